@@ -17,7 +17,12 @@ namespace Noise {
     };
 }
 
+#include "NoiseMaps/NoiseCore/include/NoiseMap2D.hpp"
+#include "NoiseMaps/NoiseCore/include/Fbm.hpp"
+#include "NoiseMaps/NoiseCore/include/Stats.hpp"
+#include "NoiseMaps/NoiseCore/include/Trace.hpp"
 #include "NoiseMaps/WhiteNoise/include/WhiteNoise.hpp"
 #include "NoiseMaps/PerlinNoise/include/PerlinNoise.hpp"
 #include "NoiseMaps/SimplexNoise/include/SimplexNoise.hpp"
 #include "NoiseMaps/PinkNoise/include/PinkNoise.hpp"
+#include "NoiseMaps/NoiseGraph/include/NoiseGraph.hpp"
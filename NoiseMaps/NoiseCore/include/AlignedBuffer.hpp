@@ -0,0 +1,28 @@
+// AlignedBuffer.hpp
+// ----------------
+// 64-byte aligned, zero-initialized float storage shared by the noise modules.
+
+#pragma once
+#include <cstddef>
+
+namespace Noise {
+
+    // aligned buffer RAII wrapper (opaque here, defined in cpp)
+    struct AlignedBuffer {
+        static constexpr std::size_t Alignment = 64;
+
+        float* data = nullptr;
+        std::size_t size = 0; // number of floats
+        AlignedBuffer() = default;
+        // zeroFill = false leaves the contents indeterminate (for buffers overwritten anyway)
+        AlignedBuffer(std::size_t n, bool zeroFill = true);
+        ~AlignedBuffer();
+        AlignedBuffer(const AlignedBuffer&) = delete;
+        AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+        AlignedBuffer(AlignedBuffer&& other) noexcept;
+        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+        float* get() noexcept { return data; }
+        const float* get() const noexcept { return data; }
+    };
+
+} // namespace Noise
@@ -0,0 +1,43 @@
+// CoordHash.hpp
+// ----------------
+// Stateless integer hash turning (seed, x, y) into a uniform value.
+//
+// Every sample depends only on its own coordinates, so any region of a hashed
+// layer can be produced in any order, on any thread, with identical results.
+// World coordinates wrap every 2^32 pixels.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace Noise {
+
+    // 32-bit integer finalizer ("lowbias32", C. Wellons)
+    inline std::uint32_t hash32(std::uint32_t v) noexcept {
+        v ^= v >> 16;
+        v *= 0x7feb352dU;
+        v ^= v >> 15;
+        v *= 0x846ca68bU;
+        v ^= v >> 16;
+        return v;
+    }
+
+    // Per-row part of hash_coords: lets row loops hash only x per pixel
+    inline std::uint32_t hash_row(std::uint32_t seed, std::int64_t y) noexcept {
+        return hash32(hash32(seed ^ 0x9e3779b9U) ^ static_cast<std::uint32_t>(y));
+    }
+
+    inline std::uint32_t hash_coords(std::uint32_t seed, std::int64_t x, std::int64_t y) noexcept {
+        return hash32(hash_row(seed, y) ^ static_cast<std::uint32_t>(x));
+    }
+
+    // Top 24 bits mapped to [0,1)
+    inline float hash_to_unit(std::uint32_t h) noexcept {
+        return static_cast<float>(h >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // One row of a hashed layer: out[i] = hash_to_unit(hash32(rowKey ^ uint32(x0 + i))).
+    // Runs 16/8 pixels per step on AVX-512/AVX2 builds; results match the scalar form exactly.
+    void hash_row_to_unit(std::uint32_t rowKey, std::int64_t x0, float* out, std::size_t count);
+
+} // namespace Noise
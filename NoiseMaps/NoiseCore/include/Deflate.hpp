@@ -0,0 +1,84 @@
+// Deflate.hpp
+// ----------------
+// Incremental raw deflate (RFC 1951) encoder used by the PNG writer.
+//
+// Input can be fed in pieces of any size. Whenever a full block is buffered it
+// is compressed (LZ77 + dynamic Huffman, or stored when that is smaller) and
+// handed to the sink, so memory stays bounded by one block plus the 32 KB match
+// window no matter how much data passes through.
+//
+// Independent segments of one stream can be compressed in parallel: give each
+// encoder the 32 KB preceding its segment with set_dictionary() and end every
+// segment but the last with sync_flush(). The outputs then concatenate into a
+// single valid stream.
+//
+// Usage:
+//   Noise::DeflateEncoder z([&](const std::uint8_t* p, std::size_t n) { out.write(p, n); });
+//   z.write(bytes, count);   // any number of times
+//   z.finish();
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Noise {
+
+    class DeflateEncoder {
+    public:
+        using Sink = std::function<void(const std::uint8_t* data, std::size_t size)>;
+
+        // level: 0 = stored blocks only, 1..9 = increasingly thorough match search
+        explicit DeflateEncoder(Sink sink, int level = 6);
+
+        // Input that precedes this segment in the full stream (last 32 KB are
+        // used). Matches may reference it; it is not emitted. Call before write().
+        void set_dictionary(const std::uint8_t* data, std::size_t size);
+
+        void write(const std::uint8_t* data, std::size_t size);
+
+        // Compresses all pending input and ends on a byte boundary with an empty
+        // stored block, so more deflate data can follow
+        void sync_flush();
+
+        // Compresses the remaining input as the final block
+        void finish();
+
+    private:
+        void compress(std::size_t end, bool last);
+        void emit_block(const std::vector<std::uint32_t>& symbols, std::size_t begin, std::size_t end, bool last);
+        void put_bits(std::uint32_t value, int count);
+        void align_to_byte();
+        void flush_output();
+
+        Sink sink_;
+        int level_;
+        int maxChain_;
+
+        // window_[0, pos_) is history (last 32 KB kept), window_[pos_, size) is pending input;
+        // base_ is the absolute stream offset of window_[0]
+        std::vector<std::uint8_t> window_;
+        std::size_t pos_ = 0;
+        std::uint64_t base_ = 0;
+
+        // hash chains over absolute offsets (-1 = empty)
+        std::vector<std::int64_t> head_;
+        std::vector<std::int64_t> prev_;
+
+        std::uint64_t bits_ = 0;
+        int bitCount_ = 0;
+        std::vector<std::uint8_t> out_;
+        bool finished_ = false;
+    };
+
+    // zlib (RFC 1950) framing around a deflate stream
+    std::array<std::uint8_t, 2> zlib_header(int level);
+    std::uint32_t adler32_update(std::uint32_t adler, const std::uint8_t* data, std::size_t size);
+
+    // Final empty block (fixed Huffman, just end-of-block) closing a stream whose
+    // segments all ended with sync_flush()
+    constexpr std::array<std::uint8_t, 2> DeflateFinalEmptyBlock = { 0x03, 0x00 };
+
+} // namespace Noise
@@ -0,0 +1,105 @@
+// DomainWarp.hpp
+// ----------------
+// Domain warping for the map generators: the map's fBm is sampled at pixel
+// coordinates displaced by a second fBm field, the warp field.
+//
+// With levels = 1, pixel p samples the map at p + strength * w(p). Each further
+// level feeds the warped point back into the field:
+// p + strength * w(p + strength * w(p)), and so on. w has two components,
+// both fBm of the map's noise type seeded with the warp seed: x at q / scale
+// and y at q / scale + (5.2, 1.3), each remapped from [0,1] to [-1,1].
+// Warp field and map are evaluated with the batched per-lane fBm kernels on
+// one row at a time, so no extra map is allocated; strength = 0 reproduces
+// generate_*_map exactly.
+//
+// Usage:
+//   Noise::DomainWarp warp;
+//   warp.strength = 40.0f;
+//   warp.levels = 2;
+//   auto map = Noise::generate_perlin_warped(1024, 1024, 120.0f, 6, 1.0f, 0.5f, 2.0f, 0.0f, warp, 42);
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace Noise {
+
+    struct DomainWarp {
+        float strength = 20.0f;     // largest displacement, in pixels
+        int levels = 1;             // times the warp field is applied (>= 1)
+        float scale = 100.0f;       // warp field feature size, in pixels
+        int octaves = 3;
+        float persistence = 0.5f;
+        float lacunarity = 2.0f;
+        int seed = -1;              // -1 = map seed + 1 (random when the map seed is random)
+    };
+
+    // Seed the warp field is generated with
+    inline int warp_seed(const DomainWarp& warp, int mapSeed) {
+        if (warp.seed >= 0) return warp.seed;
+        return mapSeed >= 0 ? mapSeed + 1 : -1;
+    }
+
+    // One fBm layer as the row kernels take it: octave o samples
+    // (coordinate / scale + shift) * freqs[o] with weight amplitudes[o]
+    struct FbmLayer {
+        const float* amplitudes = nullptr;
+        const float* freqs = nullptr;
+        int octaves = 0;
+        float maxAmp = 1.0f;
+        float scale = 1.0f;
+    };
+
+    // Row buffers for warped_fbm_row, one set per worker
+    struct WarpScratch {
+        std::vector<float> qx, qy, wx, wy, xs, ys;
+
+        WarpScratch(int width, int maxOctaves)
+            : qx(width), qy(width), wx(width), wy(width),
+              xs(static_cast<std::size_t>(maxOctaves) * width), ys(static_cast<std::size_t>(maxOctaves) * width) {
+        }
+    };
+
+    // Octave-major coordinates of `layer` at the points (qx[i], qy[i])
+    inline void fbm_layer_coords(const FbmLayer& layer, const float* qx, const float* qy, float shiftX, float shiftY,
+        float* xs, float* ys, int width) {
+        for (int o = 0; o < layer.octaves; ++o) {
+            float* xo = xs + static_cast<std::size_t>(o) * width;
+            float* yo = ys + static_cast<std::size_t>(o) * width;
+            for (int i = 0; i < width; ++i) {
+                xo[i] = (qx[i] / layer.scale + shiftX) * layer.freqs[o];
+                yo[i] = (qy[i] / layer.scale + shiftY) * layer.freqs[o];
+            }
+        }
+    }
+
+    // One warped map row: out[i] = target fBm at pixel (px[i], py) warped by
+    // `field` (see above). Generator needs the per-lane
+    // fbm(xs, ys, stride, amplitudes, octaves, maxAmp, out, count) of
+    // PerlinNoise / SimplexNoise, returning [0,1].
+    template <class Generator>
+    void warped_fbm_row(const Generator& target, const FbmLayer& map, const Generator& field, const FbmLayer& warpLayer,
+        const DomainWarp& warp, const float* px, float py, float* out, int width, WarpScratch& s) {
+        const std::size_t count = static_cast<std::size_t>(width);
+        for (int i = 0; i < width; ++i) {
+            s.qx[i] = px[i];
+            s.qy[i] = py;
+        }
+
+        for (int level = 0; level < warp.levels; ++level) {
+            fbm_layer_coords(warpLayer, s.qx.data(), s.qy.data(), 0.0f, 0.0f, s.xs.data(), s.ys.data(), width);
+            field.fbm(s.xs.data(), s.ys.data(), count, warpLayer.amplitudes, warpLayer.octaves, warpLayer.maxAmp, s.wx.data(), count);
+            fbm_layer_coords(warpLayer, s.qx.data(), s.qy.data(), 5.2f, 1.3f, s.xs.data(), s.ys.data(), width);
+            field.fbm(s.xs.data(), s.ys.data(), count, warpLayer.amplitudes, warpLayer.octaves, warpLayer.maxAmp, s.wy.data(), count);
+
+            for (int i = 0; i < width; ++i) {
+                s.qx[i] = px[i] + (s.wx[i] * 2.0f - 1.0f) * warp.strength;
+                s.qy[i] = py + (s.wy[i] * 2.0f - 1.0f) * warp.strength;
+            }
+        }
+
+        fbm_layer_coords(map, s.qx.data(), s.qy.data(), 0.0f, 0.0f, s.xs.data(), s.ys.data(), width);
+        target.fbm(s.xs.data(), s.ys.data(), count, map.amplitudes, map.octaves, map.maxAmp, out, count);
+    }
+
+} // namespace Noise
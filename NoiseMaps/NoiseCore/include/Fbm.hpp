@@ -0,0 +1,108 @@
+// Fbm.hpp
+// ----------------
+// Fractal Brownian motion over any 2D noise kernel, specialized at compile time.
+//
+// fbm<Kernel, Octaves> sums Octaves octaves of kernel(x * freq, y * freq) with
+// the octave loop unrolled, and fbm_weights<Octaves>() builds the amplitudes,
+// frequencies and normalization - as constant expressions when the parameters
+// are known at compile time. A kernel is anything callable as
+// float(float x, float y): PerlinNoise and SimplexNoise are, and a kernel whose
+// body is visible in the calling translation unit inlines into the loop.
+//
+// The map generators build their schedule with the same fbm_schedule() and run
+// their row kernels through dispatch_octaves(), which picks an unrolled
+// instantiation for 1-8 octaves and the runtime-count loop beyond that.
+//
+// Usage:
+//   constexpr auto weights = Noise::fbm_weights<5>(1.0f, 0.5f, 2.0f);
+//   Noise::PerlinNoise perlin(42);
+//   float h = Noise::fbm(perlin, x / 40.0f, y / 40.0f, weights);   // pixel (x, y) of the
+//                                                                  // matching generate_perlin_map
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Noise {
+
+    // Octave o has amplitude persistence^o and frequency frequency * lacunarity^o;
+    // maxAmp is the sum of the amplitudes. Accumulated in float, octave by octave,
+    // so every caller of the same parameters gets the same bits.
+    constexpr void fbm_schedule(int octaves, float frequency, float persistence, float lacunarity,
+        float* amplitudes, float* freqs, float& maxAmp) {
+        float amplitude = 1.0f;
+        float freq = frequency;
+        maxAmp = 0.0f;
+        for (int o = 0; o < octaves; ++o) {
+            amplitudes[o] = amplitude;
+            freqs[o] = freq;
+            maxAmp += amplitude;
+            amplitude *= persistence;
+            freq *= lacunarity;
+        }
+    }
+
+    template <int Octaves>
+    struct FbmWeights {
+        static_assert(Octaves > 0, "fBm needs at least one octave");
+        std::array<float, Octaves> amplitudes{};
+        std::array<float, Octaves> freqs{};
+        float maxAmp = 0.0f;
+    };
+
+    template <int Octaves>
+    constexpr FbmWeights<Octaves> fbm_weights(float frequency, float persistence, float lacunarity) {
+        FbmWeights<Octaves> weights;
+        fbm_schedule(Octaves, frequency, persistence, lacunarity,
+            weights.amplitudes.data(), weights.freqs.data(), weights.maxAmp);
+        return weights;
+    }
+
+    template <class Kernel, int Octaves, std::size_t... O>
+    inline float fbm_sum(const Kernel& kernel, float x, float y, const FbmWeights<Octaves>& weights,
+        std::index_sequence<O...>) {
+        float acc = 0.0f;
+        ((acc += kernel(x * weights.freqs[O], y * weights.freqs[O]) * weights.amplitudes[O]), ...);
+        return acc;
+    }
+
+    // (sum over o of kernel(x * freqs[o], y * freqs[o]) * amplitudes[o]) / maxAmp,
+    // summed in octave order like the map generators
+    template <class Kernel, int Octaves>
+    inline float fbm(const Kernel& kernel, float x, float y, const FbmWeights<Octaves>& weights) {
+        return fbm_sum(kernel, x, y, weights, std::make_index_sequence<Octaves>{}) / weights.maxAmp;
+    }
+
+    // ---------------------------------------------------------
+    // Runtime dispatch
+    // ---------------------------------------------------------
+
+    // Octave counts up to this get their own unrolled kernel instantiation
+    constexpr int MaxUnrolledOctaves = 8;
+
+    // Octaves is the compile-time count, 0 when it is only known at run time
+    template <int Octaves>
+    constexpr int octave_count(int octaves) {
+        return Octaves > 0 ? Octaves : octaves;
+    }
+
+    // Calls f(std::integral_constant<int, octaves>{}) for 1 <= octaves <= MaxUnrolledOctaves
+    // and f(std::integral_constant<int, 0>{}) otherwise
+    template <class F>
+    decltype(auto) dispatch_octaves(int octaves, F&& f) {
+        switch (octaves) {
+        case 1: return f(std::integral_constant<int, 1>{});
+        case 2: return f(std::integral_constant<int, 2>{});
+        case 3: return f(std::integral_constant<int, 3>{});
+        case 4: return f(std::integral_constant<int, 4>{});
+        case 5: return f(std::integral_constant<int, 5>{});
+        case 6: return f(std::integral_constant<int, 6>{});
+        case 7: return f(std::integral_constant<int, 7>{});
+        case 8: return f(std::integral_constant<int, 8>{});
+        default: return f(std::integral_constant<int, 0>{});
+        }
+    }
+
+}
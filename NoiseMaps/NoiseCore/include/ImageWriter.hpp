@@ -0,0 +1,85 @@
+// ImageWriter.hpp
+// ----------------
+// Streaming grayscale PNG / JPEG (and RGB PNG) output shared by every save_* function.
+//
+// Rows are encoded and written to disk as they arrive, so saving never needs an
+// 8-bit copy of the whole map or the whole compressed file in memory: a PNG
+// keeps one batch of ~1 MB segments per thread, a JPEG one 8-row strip.
+// PNG segments are filtered and deflated in parallel on the shared pool and
+// stitched into a single zlib stream, so large images save at pool speed.
+//
+// Usage:
+//   Noise::ImageWriter out(Noise::resolve_image_path("huge.png", ""), width, height);
+//   for (each band) out.write_rows(band);   // values in [0,1], top to bottom
+//   out.finish();
+
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "NoiseMap2D.hpp"
+
+namespace Noise {
+
+    struct ImageOptions {
+        int jpegQuality = 90;       // [1, 100], JPEG only
+        int compressionLevel = 6;   // [0, 9] like zlib (0 = stored, 1 = fastest, 9 = smallest), PNG only
+        int threads = 0;            // <= 0 uses the library default (see set_thread_count)
+        int channels = 1;           // 1 = grayscale, 3 = RGB (PNG only)
+    };
+
+    class ImageWriter {
+    public:
+        // Format follows the extension: .jpg / .jpeg write JPEG, anything else PNG.
+        ImageWriter(const std::filesystem::path& path, int width, int height, const ImageOptions& options = {});
+        ~ImageWriter();
+
+        ImageWriter(const ImageWriter&) = delete;
+        ImageWriter& operator=(const ImageWriter&) = delete;
+
+        // Appends one row of `width` floats in [0,1] (width * 3 interleaved
+        // r, g, b floats for RGB images)
+        void write_row(const float* row);
+
+        // Appends every row of `band` (grayscale only; its width must match the image)
+        void write_rows(const NoiseMap2D& band);
+
+        // Flushes the encoder and closes the file; every row must have been written
+        void finish();
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        int rows_written() const noexcept { return rowsWritten_; }
+        const std::filesystem::path& path() const noexcept { return path_; }
+
+        class Encoder;
+
+    private:
+        std::filesystem::path path_;
+        int width_;
+        int height_;
+        int rowsWritten_ = 0;
+        int channels_ = 1;
+        std::vector<unsigned char> pixels_;
+        std::unique_ptr<Encoder> encoder_;
+    };
+
+    // The 8-bit conversion every writer applies: out[i] = clamp(in[i], 0, 1) * 255, truncated
+    void quantize_row(const float* in, unsigned char* out, std::size_t count);
+
+    // `outputDir` / `filename`, or ../ImageOutput/`filename` when outputDir is empty.
+    // Creates the directory if needed.
+    std::filesystem::path resolve_image_path(const std::string& filename, const std::string& outputDir);
+
+    // Writes a whole map through an ImageWriter
+    void write_image(const NoiseMap2D& map, const std::filesystem::path& path, const ImageOptions& options = {});
+
+    // Pipelined generate-and-save: produce(y0, rows) must return rows [y0, y0 + rows)
+    // of the image. The next band is generated while the current one is encoded,
+    // so at most two bands are alive at a time. options.threads bounds both stages.
+    void stream_image(const std::filesystem::path& path, int width, int height,
+        const std::function<NoiseMap2D(int y0, int rows)>& produce, const ImageOptions& options = {});
+
+} // namespace Noise
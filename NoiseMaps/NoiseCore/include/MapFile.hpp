@@ -0,0 +1,120 @@
+// MapFile.hpp
+// ----------------
+// Raw binary map container (".relmap") that can be memory-mapped.
+//
+// Layout: a 256-byte little-endian header (magic "RELNOMAP", dimensions, row
+// stride, sample format, generator type, seed, region origin and up to 16
+// generator parameters) followed by the payload. Payload rows start on 64-byte
+// boundaries, so a Float32 file maps straight onto a NoiseMap2D view: loading
+// it costs one mmap and no decode, and pages are only read when touched.
+//
+// Usage:
+//   Noise::save_perlin_map_file("terrain.relmap", 4096, 4096, 40.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 42);
+//   Noise::MappedMap file = Noise::MappedMap::open("terrain.relmap");
+//   const Noise::NoiseMap2D& map = file.map();   // zero-copy, float32 files only
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "NoiseMap2D.hpp"
+
+namespace Noise {
+
+    // Generator recorded in a map file
+    enum class NoiseType : std::uint32_t {
+        Custom = 0,
+        White = 1,
+        Perlin = 2,
+        Simplex = 3,
+        Pink = 4
+    };
+
+    enum class SampleFormat : std::uint32_t {
+        Float32 = 0,  // exact values, loadable zero-copy
+        UInt16 = 1    // round(v * 65535), half the size
+    };
+
+    // Metadata stored next to the samples
+    struct MapInfo {
+        NoiseType type = NoiseType::Custom;
+        std::int64_t seed = -1;
+        std::int64_t originX = 0;  // world position of the first sample
+        std::int64_t originY = 0;
+        std::vector<double> params; // generator arguments in signature order (at most 16)
+    };
+
+    class MappedMap {
+    public:
+        static constexpr std::size_t HeaderSize = 256;
+        static constexpr std::size_t MaxParams = 16;
+
+        // Maps an existing file copy-on-write: reading is zero-copy and writes
+        // through map() never reach the file.
+        static MappedMap open(const std::filesystem::path& path);
+
+        // Creates (or truncates) a file for a width x height map and maps it
+        // read-write; the payload starts zero-filled. Call flush() or let the
+        // destructor unmap it to persist the samples.
+        static MappedMap create(const std::filesystem::path& path, int width, int height,
+            SampleFormat format = SampleFormat::Float32, const MapInfo& info = {});
+
+        MappedMap() = default;
+        ~MappedMap();
+        MappedMap(MappedMap&& other) noexcept;
+        MappedMap& operator=(MappedMap&& other) noexcept;
+        MappedMap(const MappedMap&) = delete;
+        MappedMap& operator=(const MappedMap&) = delete;
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        SampleFormat format() const noexcept { return format_; }
+        const MapInfo& info() const noexcept { return info_; }
+        // Samples between two payload rows
+        std::size_t stride() const noexcept { return stride_; }
+
+        // Float32 payload as a map view (throws for UInt16 files)
+        NoiseMap2D& map();
+        const NoiseMap2D& map() const;
+
+        // Raw UInt16 payload (throws for Float32 files)
+        const std::uint16_t* samples_u16() const;
+
+        // Owning float copy, converting UInt16 samples back to [0,1]
+        NoiseMap2D to_map() const;
+
+        // Writes `source` (same size) into the payload, quantizing for UInt16
+        void store(const NoiseMap2D& source);
+
+        // Pushes pending writes of a created file to disk
+        void flush();
+
+    private:
+        void unmap() noexcept;
+
+        void* base_ = nullptr;
+        std::size_t length_ = 0;
+        std::size_t payloadOffset_ = HeaderSize;
+        bool writable_ = false;
+#if defined(_WIN32)
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#endif
+
+        int width_ = 0;
+        int height_ = 0;
+        std::size_t stride_ = 0;
+        SampleFormat format_ = SampleFormat::Float32;
+        MapInfo info_;
+        NoiseMap2D view_;
+    };
+
+    // Writes any map to a map file
+    void save_map_file(const NoiseMap2D& map, const std::filesystem::path& path,
+        const MapInfo& info = {}, SampleFormat format = SampleFormat::Float32);
+
+    // Reads a map file into an owning map (MappedMap::open avoids the copy)
+    NoiseMap2D load_map_file(const std::filesystem::path& path);
+
+} // namespace Noise
@@ -0,0 +1,97 @@
+// NoiseMap2D.hpp
+// ----------------
+// Contiguous 2D float map returned by every generator in the library.
+//
+// The whole map is a single 64-byte aligned allocation. Each row is padded to a
+// multiple of 16 floats so every row also starts on a 64-byte boundary; walk the
+// raw buffer with data() + y * stride().
+//
+// Usage:
+//   Noise::NoiseMap2D map(512, 512);
+//   map[y][x] = 0.5f;          // row view, same syntax as std::vector<std::vector<float>>
+//   float* row = map.row(y);   // raw, aligned row pointer
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "AlignedBuffer.hpp"
+
+namespace Noise {
+
+    // Non-owning view over a single map row
+    template <class T>
+    class RowView {
+    public:
+        RowView(T* data, int width) noexcept : data_(data), width_(width) {}
+
+        T& operator[](int x) const noexcept { return data_[x]; }
+        T* data() const noexcept { return data_; }
+        T* begin() const noexcept { return data_; }
+        T* end() const noexcept { return data_ + width_; }
+        int size() const noexcept { return width_; }
+
+    private:
+        T* data_;
+        int width_;
+    };
+
+    class NoiseMap2D {
+    public:
+        // Row stride granularity in floats (64 bytes)
+        static constexpr std::size_t RowAlignment = AlignedBuffer::Alignment / sizeof(float);
+
+        NoiseMap2D() = default;
+        // Allocates a zero-filled width x height map
+        NoiseMap2D(int width, int height);
+
+        NoiseMap2D(const NoiseMap2D& other);
+        NoiseMap2D& operator=(const NoiseMap2D& other);
+        NoiseMap2D(NoiseMap2D&& other) noexcept;
+        NoiseMap2D& operator=(NoiseMap2D&& other) noexcept;
+
+        // Non-owning view over rows that live elsewhere (e.g. a memory-mapped file).
+        // `stride` is in floats; the memory must outlive the view. Copying a view
+        // produces an owning map.
+        static NoiseMap2D view(float* data, int width, int height, std::size_t stride);
+
+        // Allocates without zero-filling, for generators that write every sample
+        // anyway (saves one pass over the map). Contents are indeterminate until written.
+        static NoiseMap2D uninitialized(int width, int height);
+
+        // Conversion helpers for code still using the nested vector layout
+        static NoiseMap2D from_rows(const std::vector<std::vector<float>>& rows);
+        std::vector<std::vector<float>> to_rows() const;
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        // Distance between two rows, in floats
+        std::size_t stride() const noexcept { return stride_; }
+        bool empty() const noexcept { return width_ == 0 || height_ == 0; }
+        // False for views created with view()
+        bool owns_data() const noexcept { return data_ == buffer_.get(); }
+        // Bytes spanned by the map including row padding
+        std::size_t size_bytes() const noexcept { return stride_ * static_cast<std::size_t>(height_) * sizeof(float); }
+
+        float* data() noexcept { return data_; }
+        const float* data() const noexcept { return data_; }
+
+        float* row(int y) noexcept { return data_ + static_cast<std::size_t>(y) * stride_; }
+        const float* row(int y) const noexcept { return data_ + static_cast<std::size_t>(y) * stride_; }
+
+        RowView<float> operator[](int y) noexcept { return RowView<float>(row(y), width_); }
+        RowView<const float> operator[](int y) const noexcept { return RowView<const float>(row(y), width_); }
+
+        float& operator()(int x, int y) noexcept { return row(y)[x]; }
+        float operator()(int x, int y) const noexcept { return row(y)[x]; }
+
+        void fill(float value) noexcept;
+
+    private:
+        AlignedBuffer buffer_;
+        float* data_ = nullptr;
+        int width_ = 0;
+        int height_ = 0;
+        std::size_t stride_ = 0;
+    };
+
+} // namespace Noise
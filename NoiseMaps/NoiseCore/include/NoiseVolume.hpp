@@ -0,0 +1,70 @@
+// NoiseVolume.hpp
+// ----------------
+// Contiguous 3D float volume returned by the volume generators.
+//
+// Slices (one per z) are stored back to back and laid out like a NoiseMap2D:
+// rows padded to 64 bytes, every row 64-byte aligned. slice(z) is a zero-copy
+// NoiseMap2D view, so a slice goes straight into write_image, save_map_file
+// and the other map helpers.
+//
+// Usage:
+//   Noise::NoiseVolume vol = Noise::generate_perlin_volume(128, 128, 64, 40.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, 42);
+//   float v = vol(x, y, z);
+//   Noise::write_image(vol.slice(z), "slice.png");
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "AlignedBuffer.hpp"
+#include "NoiseMap2D.hpp"
+
+namespace Noise {
+
+    class NoiseVolume {
+    public:
+        NoiseVolume() = default;
+        // Allocates a zero-filled width x height x depth volume
+        NoiseVolume(int width, int height, int depth);
+
+        NoiseVolume(const NoiseVolume& other);
+        NoiseVolume& operator=(const NoiseVolume& other);
+        NoiseVolume(NoiseVolume&& other) noexcept;
+        NoiseVolume& operator=(NoiseVolume&& other) noexcept;
+
+        // Allocates without zero-filling, for generators that write every voxel
+        static NoiseVolume uninitialized(int width, int height, int depth);
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+        int depth() const noexcept { return depth_; }
+        // Distance between two rows / two slices, in floats
+        std::size_t stride() const noexcept { return stride_; }
+        std::size_t slice_stride() const noexcept { return stride_ * static_cast<std::size_t>(height_); }
+        bool empty() const noexcept { return width_ == 0 || height_ == 0 || depth_ == 0; }
+        // Bytes spanned by the volume including row padding
+        std::size_t size_bytes() const noexcept { return slice_stride() * static_cast<std::size_t>(depth_) * sizeof(float); }
+
+        float* data() noexcept { return buffer_.get(); }
+        const float* data() const noexcept { return buffer_.get(); }
+
+        float* row(int y, int z) noexcept { return data() + static_cast<std::size_t>(z) * slice_stride() + static_cast<std::size_t>(y) * stride_; }
+        const float* row(int y, int z) const noexcept { return data() + static_cast<std::size_t>(z) * slice_stride() + static_cast<std::size_t>(y) * stride_; }
+
+        float& operator()(int x, int y, int z) noexcept { return row(y, z)[x]; }
+        float operator()(int x, int y, int z) const noexcept { return row(y, z)[x]; }
+
+        // Non-owning map view over slice z; valid while the volume lives (copy it to keep it)
+        NoiseMap2D slice(int z);
+
+    private:
+        AlignedBuffer buffer_;
+        int width_ = 0;
+        int height_ = 0;
+        int depth_ = 0;
+        std::size_t stride_ = 0;
+    };
+
+    // Receives animation frames in order; `map` is only valid during the call
+    using FrameCallback = std::function<void(int frame, const NoiseMap2D& map)>;
+
+} // namespace Noise
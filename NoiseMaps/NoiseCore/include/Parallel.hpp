@@ -0,0 +1,26 @@
+// Parallel.hpp
+// ----------------
+// Minimal data-parallel helpers shared by the noise generators.
+//
+// Usage:
+//   Noise::parallel_for(bandCount, [&](std::size_t band) { ... }, threads);
+
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace Noise {
+
+    // Resolves a requested thread count: values <= 0 mean the library default (see set_thread_count)
+    unsigned int resolve_thread_count(int requested);
+
+    // Runs task(i) for every i in [0, count) using up to `threads` threads of the
+    // shared pool (the calling thread participates), or the user executor when one
+    // is installed. Blocks until every task finished and rethrows the first
+    // exception thrown by a task.
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task, int threads = 0);
+
+    // Number of rows per band so one band of `width` floats stays around `targetBytes`
+    int rows_per_band(int width, std::size_t targetBytes = 256 * 1024);
+
+} // namespace Noise
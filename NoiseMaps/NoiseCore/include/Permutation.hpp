@@ -0,0 +1,17 @@
+// Permutation.hpp
+// ----------------
+// Seeded lattice permutation shared by the Perlin and Simplex generators.
+//
+// The table is 0..255 shuffled with std::mt19937(seed), stored twice (512
+// entries) so lookups of i + 1 never wrap. Tables for fixed seeds are memoized,
+// so repeated generate_* calls with the same seed skip the RNG and shuffle.
+
+#pragma once
+#include <vector>
+
+namespace Noise {
+
+    // Permutation for `seed`; seeds < 0 draw a fresh random table (never cached)
+    std::vector<int> permutation_table(int seed);
+
+} // namespace Noise
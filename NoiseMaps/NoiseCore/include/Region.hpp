@@ -0,0 +1,39 @@
+// Region.hpp
+// ----------------
+// World-space rectangle for chunked / streaming generation.
+//
+// A region names pixels (x .. x+width-1, y .. y+height-1) of an unbounded world.
+// Generating two adjacent regions with the same parameters gives maps that join
+// seamlessly, and generating Region{0, 0, w, h, base, base} reproduces the
+// matching generate_*_map output.
+//
+// Usage:
+//   Noise::Region chunk{ cx * 256, cy * 256, 256, 256 };
+//   auto tile = Noise::generate_perlin_region(chunk, 40.0f, 5, 1.0f, 0.5f, 2.0f, 42);
+
+#pragma once
+#include <cstdint>
+
+namespace Noise {
+
+    struct Region {
+        std::int64_t x = 0;    // world column of the left edge
+        std::int64_t y = 0;    // world row of the top edge
+        int width = 0;
+        int height = 0;
+        double offsetX = 0.0;  // shift added to world x before scaling
+        double offsetY = 0.0;  // shift added to world y before scaling
+    };
+
+    // How world coordinates are turned into noise-space coordinates
+    enum class CoordinateMode {
+        // float math, identical to generate_*_map: (x + offset) / scale * frequency.
+        // Loses precision once world coordinates reach ~1e5 pixels.
+        Float,
+        // double math, then the whole lattice periods are dropped and only the
+        // in-period remainder is evaluated in float. Precision no longer
+        // depends on the distance from the origin.
+        Precise
+    };
+
+} // namespace Noise
@@ -0,0 +1,64 @@
+// Simd.hpp
+// ----------------
+// Runtime selection of the SIMD kernels.
+//
+// The libraries are compiled for the baseline instruction set. The AVX2 and
+// AVX-512 kernels are built next to the portable loops with per-function
+// target attributes and picked at run time from CPUID, so one binary runs on
+// older hosts and still takes the wide paths where the CPU has them. Every
+// level produces bit-identical results.
+//
+// Usage:
+//   Noise::simd_level();                             // level the kernels use
+//   Noise::set_simd_level(Noise::SimdLevel::AVX2);   // force a level (capped at the CPU's)
+//   RELNO_SIMD=scalar|sse2|avx2|avx512 ./app         // same, from the environment
+
+#pragma once
+
+// x86 builds carry the wide kernels; other targets only have the portable loops.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RELNO_SIMD_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC accepts every intrinsic without /arch flags
+#define RELNO_TARGET_AVX2
+#define RELNO_TARGET_AVX512
+#else
+#define RELNO_TARGET_AVX2 __attribute__((target("avx2")))
+#define RELNO_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#else
+#define RELNO_SIMD_X86 0
+#endif
+
+namespace Noise {
+
+    // Ordered: a level runs every kernel of the levels below it.
+    // Scalar and SSE2 both run the portable loops; SSE2 is what the compiler
+    // already vectorizes them with on x86-64, Scalar is reported elsewhere.
+    enum class SimdLevel {
+        Scalar = 0,
+        SSE2 = 1,
+        AVX2 = 2,
+        AVX512 = 3      // AVX-512F
+    };
+
+    // Best level the CPU and OS support (detected once)
+    SimdLevel detected_simd_level();
+
+    // Level the kernels dispatch to: the RELNO_SIMD environment variable
+    // (scalar, sse2, avx2, avx512; read on first use, unknown values ignored)
+    // or the last set_simd_level() call, capped at detected_simd_level().
+    SimdLevel simd_level();
+
+    // Forces a level for testing and returns the one now in effect; levels the
+    // CPU lacks fall back to detected_simd_level(). Safe to call at any time,
+    // calls already running keep the kernels they started with.
+    SimdLevel set_simd_level(SimdLevel level);
+
+    // Back to detected_simd_level(), ignoring RELNO_SIMD
+    void reset_simd_level();
+
+    // "scalar", "sse2", "avx2" or "avx512"
+    const char* simd_level_name(SimdLevel level);
+
+} // namespace Noise
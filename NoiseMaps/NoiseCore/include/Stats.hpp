@@ -0,0 +1,135 @@
+// Stats.hpp
+// ----------------
+// Opt-in timing and counters for the generators and save functions.
+//
+// Once an observer is installed, every public generate_* / save_* / stream_* /
+// create_* call (and the WhiteNoise, tile and NoiseGraph equivalents) reports
+// one CallStats when it returns. A call made from inside another one, such as
+// generate_perlin_map inside create_perlinnoise, is folded into the outer
+// call's report. Work that the call runs on pool workers is attributed to it.
+// Calls that throw are not reported.
+//
+// Stage times are wall times and exclusive: time spent in a nested stage,
+// such as quantizing inside an image write, is not counted again in the
+// enclosing stage. A parallel section inside a stage counts toward that stage
+// as a whole. Tasks that run stages side by side (stream_* encodes one band
+// while it generates the next) are timed per task, so there the stages can add
+// up to more than `seconds`.
+//
+// With no observer installed, an instrumented call costs one atomic load and
+// each timer or counter one thread-local load. Scopes and timers are also the
+// trace spans of Trace.hpp.
+//
+// Usage:
+//   Noise::set_stats_observer([](const Noise::CallStats& s) {
+//       std::printf("%s: %.2f ms, generate %.2f ms, encode %.2f ms, %llu bytes written\n",
+//           s.function, s.seconds * 1e3, s.stage(Noise::Stage::Generate) * 1e3,
+//           s.stage(Noise::Stage::Encode) * 1e3, static_cast<unsigned long long>(s.bytesWritten));
+//   });
+//   Noise::create_perlinnoise(1024, 1024, 50.0f, 6, 1.0f, 0.5f, 2.0f, 0.0f, 42, Noise::OutputMode::Image, "p.png");
+//   Noise::set_stats_observer(nullptr);
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "Trace.hpp"
+
+namespace Noise {
+
+    enum class Stage {
+        Setup = 0,      // permutation tables, output files
+        Generate,       // noise evaluation (fBm normalization is fused into it)
+        Normalize,      // separate scaling passes (pink noise)
+        Quantize,       // float -> 8-bit (images) / 16-bit (map files) conversion
+        Encode          // PNG / JPEG encoding, map file output
+    };
+
+    constexpr std::size_t StageCount = 5;
+
+    // "setup", "generate", "normalize", "quantize" or "encode"
+    const char* stage_name(Stage stage);
+
+    struct CallStats {
+        const char* function = "";                  // e.g. "generate_perlin_map"
+        double seconds = 0.0;                       // wall time of the whole call
+        std::array<double, StageCount> stageSeconds{};
+        std::uint64_t pixels = 0;                   // output pixels (samples for volumes)
+        unsigned int threads = 1;                   // most threads any parallel section used
+        std::uint64_t bytesAllocated = 0;           // aligned map, volume and scratch buffers
+        std::uint64_t bytesWritten = 0;             // image and map file bytes
+
+        double stage(Stage s) const { return stageSeconds[static_cast<std::size_t>(s)]; }
+    };
+
+    using StatsObserver = std::function<void(const CallStats& stats)>;
+
+    // Installs `observer` for calls that start from now on; an empty observer
+    // turns collection off. The observer runs on the thread that made the call.
+    void set_stats_observer(StatsObserver observer);
+    StatsObserver get_stats_observer();
+    bool stats_enabled() noexcept;
+
+    // ---------------------------------------------------------
+    // Instrumentation hooks used by the library
+    // ---------------------------------------------------------
+
+    struct StatsCall;
+
+    // Pixels of a width x height (x depth) output, for StatsScope
+    constexpr std::uint64_t pixel_count(int width, int height, int depth = 1) {
+        return static_cast<std::uint64_t>(width < 0 ? 0 : width) * static_cast<std::uint64_t>(height < 0 ? 0 : height)
+            * static_cast<std::uint64_t>(depth < 0 ? 0 : depth);
+    }
+
+    // Reporting scope of one public call. A scope opened while another one is
+    // active on the thread does not report; every scope is a trace span.
+    class StatsScope {
+    public:
+        StatsScope(const char* function, std::uint64_t pixels);
+        ~StatsScope();
+
+        StatsScope(const StatsScope&) = delete;
+        StatsScope& operator=(const StatsScope&) = delete;
+
+    private:
+        TraceSpan span_;
+        std::unique_ptr<StatsCall> call_;
+        int uncaught_ = 0;
+    };
+
+    // Charges its lifetime, minus nested timers, to `stage` of the active call,
+    // and records it as a trace span unless `traced` is false (per-row timers)
+    class StageTimer {
+    public:
+        explicit StageTimer(Stage stage, bool traced = true);
+        ~StageTimer();
+
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        TraceSpan span_;
+        StatsCall* call_ = nullptr;
+        StageTimer* parent_ = nullptr;
+        Stage stage_;
+        std::chrono::steady_clock::time_point start_;
+
+        void charge(std::chrono::steady_clock::time_point now);
+    };
+
+    // Call the calling thread reports into (nullptr when none)
+    StatsCall* current_stats_call() noexcept;
+
+    // Runs task(i) with `call` as the current call of the running thread
+    // (parallel_for wraps tasks with this while a call is active)
+    std::function<void(std::size_t)> bind_stats_call(StatsCall* call, const std::function<void(std::size_t)>& task);
+
+    void stats_add_allocated(std::size_t bytes) noexcept;
+    void stats_add_written(std::size_t bytes) noexcept;
+    void stats_note_threads(unsigned int threads) noexcept;
+
+} // namespace Noise
@@ -0,0 +1,46 @@
+// Surface.hpp
+// ----------------
+// Height maps together with their analytic gradient, and the normal maps
+// built from them.
+//
+// The generate_*_surface functions evaluate every octave's value and
+// derivatives in the same pass, so normals need neither finite differences
+// nor a second pass over the map and keep full float precision.
+//
+// Usage:
+//   Noise::SurfaceMap s = Noise::generate_perlin_surface(512, 512, 40.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 42);
+//   Noise::NormalMap n = Noise::surface_normals(s, 40.0f);
+//   Noise::save_normal_map(n, "normals.png");
+
+#pragma once
+#include <string>
+#include "NoiseMap2D.hpp"
+
+namespace Noise {
+
+    struct SurfaceMap {
+        NoiseMap2D height;  // [0,1], same values as the matching generate_*_map
+        NoiseMap2D dx;      // d height / d x, per pixel
+        NoiseMap2D dy;      // d height / d y, per pixel (rows grow downwards)
+    };
+
+    // Unit normal components in [-1,1]
+    struct NormalMap {
+        NoiseMap2D x;
+        NoiseMap2D y;
+        NoiseMap2D z;
+    };
+
+    // Normals of the surface z = strength * height, with x and y in pixels:
+    // normalize(-strength * dx, -strength * dy, 1). `strength` is the height of
+    // the surface, in pixels, at height 1; throws for strength < 0.
+    NormalMap surface_normals(const SurfaceMap& surface, float strength, int threads = 0);
+
+    // RGB PNG with (n + 1) / 2 per channel (tangent-space encoding, +y down).
+    // If outputDir is empty, uses default ImageOutput/ directory.
+    void save_normal_map(const NormalMap& normals,
+        const std::string& filename = "normal_map.png",
+        const std::string& outputDir = "",
+        int compressionLevel = 6);
+
+} // namespace Noise
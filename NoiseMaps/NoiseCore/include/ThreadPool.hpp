@@ -0,0 +1,85 @@
+// ThreadPool.hpp
+// ----------------
+// Library-wide worker pool behind Noise::parallel_for.
+//
+// The shared pool is created lazily on first use and reused by every
+// generator, so a parallel call only costs a few queue operations instead of
+// spawning and joining threads. Each worker owns a deque and steals from the
+// others when it runs dry; the calling thread always helps with its own work,
+// so nested parallel_for calls cannot deadlock.
+//
+// Usage:
+//   Noise::set_thread_count(16);                    // resize the shared pool
+//   Noise::set_executor([](std::size_t n, const std::function<void(std::size_t)>& task) {
+//       my_scheduler.run_all(n, task);              // or plug in your own scheduler
+//   });
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Noise {
+
+    // User-supplied scheduler: must run task(i) for every i in [0, count) and
+    // return only once all of them finished.
+    using Executor = std::function<void(std::size_t count, const std::function<void(std::size_t)>& task)>;
+
+    class ThreadPool {
+    public:
+        // `workers` background threads; the caller of parallel_for is one more
+        explicit ThreadPool(unsigned int workers);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Threads available to a parallel_for call (workers + caller)
+        unsigned int size() const noexcept { return static_cast<unsigned int>(workers_.size()) + 1; }
+
+        // Runs task(i) for every i in [0, count) on up to `maxThreads` threads
+        // (0 = whole pool). Rethrows the first exception thrown by a task.
+        void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task, unsigned int maxThreads = 0);
+
+        // Shared pool, created on first use with get_thread_count() threads
+        static std::shared_ptr<ThreadPool> shared();
+
+    private:
+        struct Batch;
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Batch>> items;
+        };
+
+        void push(std::shared_ptr<Batch> batch);
+        bool try_pop(std::size_t self, std::shared_ptr<Batch>& out);
+        bool try_steal(std::size_t self, std::shared_ptr<Batch>& out);
+        void worker_loop(std::size_t index);
+        static void run(Batch& batch);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::mutex sleepMutex_;
+        std::condition_variable sleepCv_;
+        std::atomic<std::size_t> queued_{ 0 };
+        std::atomic<std::size_t> nextQueue_{ 0 };
+        bool stop_ = false;
+    };
+
+    // Size of the shared pool including the calling thread (<= 0 = all hardware threads).
+    // Takes effect for the next parallel call; calls already running keep their pool.
+    void set_thread_count(int threads);
+    int get_thread_count();
+
+    // Routes every parallel call in the library through `executor` instead of
+    // the shared pool. Pass an empty Executor to go back to the built-in pool.
+    void set_executor(Executor executor);
+    Executor get_executor();
+
+} // namespace Noise
@@ -0,0 +1,115 @@
+// TileCache.hpp
+// ----------------
+// Opt-in, thread-safe LRU cache for square noise tiles.
+//
+// Tiles are keyed by generator, full parameter set, seed and tile coordinate
+// and held as shared, immutable maps, so a tile evicted while a caller still
+// uses it stays valid until the last reference drops. The cache keeps the
+// total size of its tiles under a byte budget by dropping the least recently
+// used ones. Concurrent requests for the same missing tile generate it once;
+// the other callers wait for that result.
+//
+// Usage:
+//   Noise::TileCache cache(256 * 1024 * 1024);
+//   auto tile = Noise::perlin_tile(cache, tx, ty, 256, 40.0f, 5, 1.0f, 0.5f, 2.0f, 42);
+//   float v = (*tile)[y][x];
+//   Noise::TileCacheStats s = cache.stats();   // hits / misses / evictions
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "MapFile.hpp"
+#include "NoiseMap2D.hpp"
+#include "Region.hpp"
+
+namespace Noise {
+
+    struct TileKey {
+        NoiseType type = NoiseType::Custom;
+        std::int64_t tileX = 0;
+        std::int64_t tileY = 0;
+        int tileSize = 0;
+        std::int64_t seed = 0;
+        std::vector<double> params; // generator arguments in signature order
+
+        bool operator==(const TileKey& other) const noexcept;
+        bool operator!=(const TileKey& other) const noexcept { return !(*this == other); }
+    };
+
+    struct TileKeyHash {
+        std::size_t operator()(const TileKey& key) const noexcept;
+    };
+
+    // Key for tile (tileX, tileY); throws for tileSize <= 0 or seed < 0 (a random
+    // seed would make every request a new tile)
+    TileKey make_tile_key(NoiseType type, std::int64_t tileX, std::int64_t tileY, int tileSize,
+        int seed, std::vector<double> params);
+
+    // World rectangle covered by a tile: origin (tileX, tileY) * tileSize
+    Region tile_region(const TileKey& key);
+
+    struct TileCacheStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;       // tiles generated
+        std::uint64_t evictions = 0;    // tiles dropped to stay within the budget
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+
+    class TileCache {
+    public:
+        using Tile = std::shared_ptr<const NoiseMap2D>;
+        using Producer = std::function<NoiseMap2D()>;
+
+        explicit TileCache(std::size_t byteBudget = 64 * 1024 * 1024);
+
+        TileCache(const TileCache&) = delete;
+        TileCache& operator=(const TileCache&) = delete;
+
+        // Cached tile for `key`, or the result of produce() (stored unless it
+        // alone exceeds the budget). Exceptions from produce() reach every
+        // caller waiting on the key and nothing is cached.
+        Tile get_or_create(const TileKey& key, const Producer& produce);
+
+        // Cached tile or nullptr; counts as a hit or miss
+        Tile find(const TileKey& key);
+
+        // Drops every tile (counters are kept)
+        void clear();
+
+        // Shrinking the budget evicts immediately
+        void set_byte_budget(std::size_t bytes);
+        std::size_t byte_budget() const;
+
+        TileCacheStats stats() const;
+        void reset_stats();
+
+    private:
+        struct Entry {
+            TileKey key;
+            Tile tile;
+            std::size_t bytes;
+        };
+        using Lru = std::list<Entry>; // front = most recently used
+
+        void evict_locked();
+
+        mutable std::mutex mutex_;
+        std::size_t budget_;
+        std::size_t bytes_ = 0;
+        Lru lru_;
+        std::unordered_map<TileKey, Lru::iterator, TileKeyHash> index_;
+        std::unordered_map<TileKey, std::shared_future<Tile>, TileKeyHash> pending_;
+        std::uint64_t hits_ = 0;
+        std::uint64_t misses_ = 0;
+        std::uint64_t evictions_ = 0;
+    };
+
+} // namespace Noise
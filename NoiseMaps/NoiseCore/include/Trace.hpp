@@ -0,0 +1,73 @@
+// Trace.hpp
+// ----------------
+// Opt-in timeline of what every thread does, exported as a Chrome trace.
+//
+// Between start_trace() and stop_trace() the library records a begin/end span
+// for each public call, each stage (the stages of Stats.hpp), each parallel_for
+// task, each band of image rows written ("write_rows"), and the passes of the
+// pink generator: "octave" (args.index = octave), "block_means" inside it
+// (args.index = block size) and the final "normalize". The standalone
+// PinkNoise helpers add "generate_white_layer", "build_integral" and
+// "box_average" when called directly.
+//
+// Spans go into a fixed-size buffer owned by the recording thread, so
+// recording takes no lock; a thread takes the registry lock once, for its
+// first span of a session. Spans that do not fit are counted as dropped.
+// write_trace() saves them in the Trace Event Format, which chrome://tracing
+// and ui.perfetto.dev open directly. Gaps between the task spans of a thread
+// are idle time.
+//
+// Perlin and Simplex evaluate all octaves of a row in one fused kernel, so
+// their traces show tasks and stages but no per-octave spans.
+//
+// start_trace(), stop_trace() and write_trace() must not overlap with library
+// calls on other threads. When tracing is off, each span costs one atomic load.
+//
+// Usage:
+//   Noise::start_trace();
+//   auto map = Noise::generate_pink_map(4096, 4096, 8);
+//   Noise::stop_trace();
+//   Noise::write_trace("pink.trace.json");   // open in ui.perfetto.dev
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Noise {
+
+    // Drops earlier spans and starts recording, with room for `eventsPerThread`
+    // spans per thread
+    void start_trace(std::size_t eventsPerThread = 1 << 16);
+    void stop_trace();
+    bool tracing() noexcept;
+
+    // Spans recorded since the last start_trace() and spans that did not fit
+    std::size_t trace_event_count();
+    std::size_t trace_dropped_count();
+
+    // Chrome trace JSON of the spans recorded since the last start_trace()
+    void write_trace(const std::filesystem::path& path);
+
+    struct TraceBuffer;
+
+    // Records [construction, destruction) on the calling thread. `name` and
+    // `category` must outlive the trace (string literals); `arg` >= 0 is
+    // exported as args.index. A null `name` records nothing.
+    class TraceSpan {
+    public:
+        TraceSpan(const char* name, const char* category, std::int64_t arg = -1);
+        ~TraceSpan();
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        TraceBuffer* buffer_ = nullptr;
+        const char* name_;
+        const char* category_;
+        std::int64_t arg_;
+        std::int64_t begin_ = 0;
+    };
+
+} // namespace Noise
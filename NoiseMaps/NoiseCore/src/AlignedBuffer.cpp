@@ -0,0 +1,105 @@
+// AlignedBuffer.cpp
+#include "AlignedBuffer.hpp"
+#include "Stats.hpp"
+
+#include <cstring>
+#include <cstdint> // for std::uintptr_t
+#include <new>     // for std::bad_alloc
+
+#if defined(_MSC_VER)
+#include <malloc.h> // _aligned_malloc / _aligned_free
+#else
+#include <stdlib.h> // malloc, free
+#endif
+
+namespace Noise {
+
+    namespace {
+        void release(float* data) {
+#if defined(_MSC_VER)
+            if (data) {
+                _aligned_free(data);
+            }
+#else
+            if (data) {
+                // Recover the original pointer we stashed just before `data`
+                void* raw = reinterpret_cast<void**>(data)[-1];
+                std::free(raw);
+            }
+#endif
+        }
+    }
+
+    // -----------------------------
+    // AlignedBuffer implementation
+    // -----------------------------
+    AlignedBuffer::AlignedBuffer(std::size_t n, bool zeroFill) : data(nullptr), size(n) {
+        if (n == 0) return;
+
+        std::size_t bytes = n * sizeof(float);
+        stats_add_allocated(bytes);
+
+#if defined(_MSC_VER)
+        // Windows (MSVC): use _aligned_malloc / _aligned_free
+        data = static_cast<float*>(_aligned_malloc(bytes, Alignment));
+        if (!data) {
+            throw std::bad_alloc();
+        }
+#else
+        // Portable manual alignment for all other compilers (MinGW, Linux, macOS, etc.)
+        const std::size_t alignment = Alignment;
+
+        // We allocate extra space to:
+        //  - guarantee we can align to `alignment`
+        //  - store the original pointer just before the aligned block
+        std::size_t total = bytes + alignment - 1 + sizeof(void*);
+        void* raw = std::malloc(total);
+        if (!raw) {
+            throw std::bad_alloc();
+        }
+
+        // Find an aligned address inside the allocated block
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        std::uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+        void* alignedPtr = reinterpret_cast<void*>(aligned);
+
+        // Store the original pointer immediately before the aligned block
+        reinterpret_cast<void**>(alignedPtr)[-1] = raw;
+
+        data = static_cast<float*>(alignedPtr);
+#endif
+
+        // zero initialize the usable bytes (not the padding)
+        if (zeroFill) std::memset(data, 0, bytes);
+    }
+
+    AlignedBuffer::~AlignedBuffer() {
+        release(data);
+        data = nullptr;
+        size = 0;
+    }
+
+    // Move constructor
+    AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept {
+        data = other.data;
+        size = other.size;
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    // Move assignment
+    AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+        if (this != &other) {
+            // Free existing buffer
+            release(data);
+
+            // Steal ownership
+            data = other.data;
+            size = other.size;
+            other.data = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+} // namespace Noise
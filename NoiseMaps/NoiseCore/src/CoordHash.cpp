@@ -0,0 +1,72 @@
+// CoordHash.cpp
+#include "CoordHash.hpp"
+#include "Simd.hpp"
+
+#if RELNO_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace Noise {
+
+    namespace {
+
+#if RELNO_SIMD_X86
+        RELNO_TARGET_AVX2 inline __m256i hash32x8(__m256i v) {
+            v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+            v = _mm256_mullo_epi32(v, _mm256_set1_epi32(0x7feb352d));
+            v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 15));
+            v = _mm256_mullo_epi32(v, _mm256_set1_epi32(static_cast<int>(0x846ca68bU)));
+            return _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+        }
+
+        RELNO_TARGET_AVX512 inline __m512i hash32x16(__m512i v) {
+            v = _mm512_xor_si512(v, _mm512_srli_epi32(v, 16));
+            v = _mm512_mullo_epi32(v, _mm512_set1_epi32(0x7feb352d));
+            v = _mm512_xor_si512(v, _mm512_srli_epi32(v, 15));
+            v = _mm512_mullo_epi32(v, _mm512_set1_epi32(static_cast<int>(0x846ca68bU)));
+            return _mm512_xor_si512(v, _mm512_srli_epi32(v, 16));
+        }
+
+        // Kernels fill out[i, ...) in whole vectors and return where they stopped
+        RELNO_TARGET_AVX512 std::size_t hash_row16(std::uint32_t rowKey, std::uint32_t xBase, float* out, std::size_t i, std::size_t count) {
+            const __m512i key = _mm512_set1_epi32(static_cast<int>(rowKey));
+            const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m512 unit = _mm512_set1_ps(1.0f / 16777216.0f);
+            for (; i + 16 <= count; i += 16) {
+                __m512i x = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(xBase + static_cast<std::uint32_t>(i))), lanes);
+                __m512i h = hash32x16(_mm512_xor_si512(key, x));
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srli_epi32(h, 8)), unit));
+            }
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t hash_row8(std::uint32_t rowKey, std::uint32_t xBase, float* out, std::size_t i, std::size_t count) {
+            const __m256i key = _mm256_set1_epi32(static_cast<int>(rowKey));
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256 unit = _mm256_set1_ps(1.0f / 16777216.0f);
+            for (; i + 8 <= count; i += 8) {
+                __m256i x = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(xBase + static_cast<std::uint32_t>(i))), lanes);
+                __m256i h = hash32x8(_mm256_xor_si256(key, x));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(h, 8)), unit));
+            }
+            return i;
+        }
+#endif
+
+    } // namespace
+
+    void hash_row_to_unit(std::uint32_t rowKey, std::int64_t x0, float* out, std::size_t count) {
+        // x only enters the hash through its low 32 bits
+        const std::uint32_t xBase = static_cast<std::uint32_t>(x0);
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        const SimdLevel level = simd_level();
+        if (level >= SimdLevel::AVX512) i = hash_row16(rowKey, xBase, out, i, count);
+        if (level >= SimdLevel::AVX2) i = hash_row8(rowKey, xBase, out, i, count);
+#endif
+        // scalar fallback / tail
+        for (; i < count; ++i)
+            out[i] = hash_to_unit(hash32(rowKey ^ (xBase + static_cast<std::uint32_t>(i))));
+    }
+
+} // namespace Noise
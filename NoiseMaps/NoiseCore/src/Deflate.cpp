@@ -0,0 +1,470 @@
+// Deflate.cpp
+#include "Deflate.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    namespace {
+        constexpr std::size_t kWindowSize = 32768;
+        constexpr std::size_t kBlockSize = 128 * 1024;  // input bytes per deflate block
+        constexpr int kMinMatch = 3;
+        constexpr int kMaxMatch = 258;
+        constexpr int kHashBits = 15;
+        constexpr std::uint32_t kMatchFlag = 0x80000000u;
+
+        // Chain lengths per level (index 0 unused: level 0 never searches)
+        constexpr int kChainLength[10] = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+        // Chain search stops once a match reaches this length (zlib nice_length)
+        constexpr int kNiceLength[10] = { 0, 8, 16, 32, 16, 32, 128, 128, 258, 258 };
+
+        constexpr std::uint16_t kLengthBase[29] = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        constexpr std::uint8_t kLengthExtra[29] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        constexpr std::uint16_t kDistBase[30] = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        constexpr std::uint8_t kDistExtra[30] = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        // Order in which code length code lengths are transmitted
+        constexpr std::uint8_t kCodeLengthOrder[19] = {
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        int length_code(int length) {
+            return static_cast<int>(std::upper_bound(kLengthBase, kLengthBase + 29, length) - kLengthBase) - 1;
+        }
+
+        int dist_code(int dist) {
+            return static_cast<int>(std::upper_bound(kDistBase, kDistBase + 30, dist) - kDistBase) - 1;
+        }
+
+        // Huffman code lengths for `freq`, no longer than `limit` bits. Frequencies
+        // are halved until the tree fits, which costs a little ratio on pathological
+        // inputs but keeps the builder short. At least two symbols get a code so the
+        // resulting code is always complete.
+        std::vector<std::uint8_t> build_lengths(std::vector<std::uint32_t> freq, int limit) {
+            const int n = static_cast<int>(freq.size());
+            int used = 0;
+            for (std::uint32_t f : freq) used += (f != 0);
+            for (int s = 0; used < 2 && s < n; ++s)
+                if (freq[s] == 0) { freq[s] = 1; ++used; }
+
+            std::vector<std::uint8_t> lengths(n, 0);
+            for (;;) {
+                // nodes [0, n) are leaves, the rest internal; parent links give depths
+                std::vector<int> parent(2 * n, -1);
+                std::vector<std::uint64_t> weight(2 * n, 0);
+                using Item = std::pair<std::uint64_t, int>;
+                std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+                for (int s = 0; s < n; ++s) {
+                    weight[s] = freq[s];
+                    if (freq[s]) heap.push({ freq[s], s });
+                }
+                int next = n;
+                while (heap.size() > 1) {
+                    Item a = heap.top(); heap.pop();
+                    Item b = heap.top(); heap.pop();
+                    weight[next] = a.first + b.first;
+                    parent[a.second] = parent[b.second] = next;
+                    heap.push({ weight[next], next });
+                    ++next;
+                }
+
+                int maxLen = 0;
+                for (int s = 0; s < n; ++s) {
+                    if (!freq[s]) { lengths[s] = 0; continue; }
+                    int depth = 0;
+                    for (int p = parent[s]; p >= 0; p = parent[p]) ++depth;
+                    lengths[s] = static_cast<std::uint8_t>(depth);
+                    maxLen = std::max(maxLen, depth);
+                }
+                if (maxLen <= limit) return lengths;
+
+                for (std::uint32_t& f : freq)
+                    if (f) f = (f + 1) / 2;
+            }
+        }
+
+        // Canonical codes, bit-reversed because deflate packs Huffman codes MSB first
+        std::vector<std::uint16_t> build_codes(const std::vector<std::uint8_t>& lengths) {
+            std::uint16_t count[16] = {};
+            for (std::uint8_t l : lengths) ++count[l];
+            count[0] = 0;
+
+            std::uint16_t next[16] = {};
+            std::uint16_t code = 0;
+            for (int bits = 1; bits < 16; ++bits) {
+                code = static_cast<std::uint16_t>((code + count[bits - 1]) << 1);
+                next[bits] = code;
+            }
+
+            std::vector<std::uint16_t> codes(lengths.size(), 0);
+            for (std::size_t s = 0; s < lengths.size(); ++s) {
+                int len = lengths[s];
+                if (!len) continue;
+                std::uint16_t c = next[len]++;
+                std::uint16_t r = 0;
+                for (int i = 0; i < len; ++i) r = static_cast<std::uint16_t>((r << 1) | ((c >> i) & 1));
+                codes[s] = r;
+            }
+            return codes;
+        }
+
+        struct CodeLengthSymbol {
+            std::uint8_t symbol;
+            std::uint8_t extra;
+        };
+
+        // Run-length encodes the concatenated literal/length and distance code lengths
+        std::vector<CodeLengthSymbol> encode_code_lengths(const std::vector<std::uint8_t>& lengths) {
+            std::vector<CodeLengthSymbol> out;
+            const std::size_t n = lengths.size();
+            for (std::size_t i = 0; i < n;) {
+                std::uint8_t len = lengths[i];
+                std::size_t run = 1;
+                while (i + run < n && lengths[i + run] == len) ++run;
+
+                std::size_t left = run;
+                if (len == 0) {
+                    while (left >= 11) {
+                        std::size_t r = std::min<std::size_t>(left, 138);
+                        out.push_back({ 18, static_cast<std::uint8_t>(r - 11) });
+                        left -= r;
+                    }
+                    if (left >= 3) {
+                        out.push_back({ 17, static_cast<std::uint8_t>(left - 3) });
+                        left = 0;
+                    }
+                }
+                else if (left >= 4) {
+                    out.push_back({ len, 0 });
+                    --left;
+                    while (left >= 3) {
+                        std::size_t r = std::min<std::size_t>(left, 6);
+                        out.push_back({ 16, static_cast<std::uint8_t>(r - 3) });
+                        left -= r;
+                    }
+                }
+                while (left--) out.push_back({ len, 0 });
+                i += run;
+            }
+            return out;
+        }
+
+        std::uint32_t hash3(const std::uint8_t* p) {
+            return ((static_cast<std::uint32_t>(p[0]) << 10) ^ (static_cast<std::uint32_t>(p[1]) << 5) ^ p[2])
+                & ((1u << kHashBits) - 1);
+        }
+    }
+
+    DeflateEncoder::DeflateEncoder(Sink sink, int level)
+        : sink_(std::move(sink)), level_(level) {
+        if (level < 0 || level > 9)
+            throw std::invalid_argument("compression level must be in [0, 9], got: " + std::to_string(level));
+        maxChain_ = kChainLength[level];
+        if (level_ > 0) {
+            head_.assign(std::size_t(1) << kHashBits, -1);
+            prev_.assign(kWindowSize, -1);
+        }
+    }
+
+    void DeflateEncoder::set_dictionary(const std::uint8_t* data, std::size_t size) {
+        if (!window_.empty()) throw std::logic_error("DeflateEncoder::set_dictionary must come before write");
+        if (size > kWindowSize) {
+            data += size - kWindowSize;
+            size = kWindowSize;
+        }
+        window_.assign(data, data + size);
+        pos_ = size;
+
+        if (level_ > 0) {
+            for (std::size_t i = 0; i + kMinMatch <= size; ++i) {
+                const std::uint32_t h = hash3(window_.data() + i);
+                prev_[i & (kWindowSize - 1)] = head_[h];
+                head_[h] = static_cast<std::int64_t>(i);
+            }
+        }
+    }
+
+    void DeflateEncoder::write(const std::uint8_t* data, std::size_t size) {
+        if (finished_) throw std::logic_error("DeflateEncoder::write called after finish");
+
+        window_.insert(window_.end(), data, data + size);
+        while (window_.size() - pos_ >= kBlockSize + kMaxMatch)
+            compress(pos_ + kBlockSize, false);
+    }
+
+    void DeflateEncoder::sync_flush() {
+        if (finished_) throw std::logic_error("DeflateEncoder::sync_flush called after finish");
+        if (window_.size() > pos_) compress(window_.size(), false);
+
+        // empty stored block: header bits, byte alignment, LEN = 0, NLEN = 0xFFFF
+        put_bits(0, 3);
+        align_to_byte();
+        put_bits(0x0000, 16);
+        put_bits(0xFFFF, 16);
+        flush_output();
+    }
+
+    void DeflateEncoder::finish() {
+        if (finished_) return;
+        compress(window_.size(), true);
+        align_to_byte();
+        flush_output();
+        finished_ = true;
+    }
+
+    // Parses window_[pos_, end) into literals and matches (greedy, hash chains over
+    // the last 32 KB), emits it as one block and slides the window.
+    void DeflateEncoder::compress(std::size_t end, bool last) {
+        const std::size_t begin = pos_;
+        const std::size_t avail = window_.size();
+        std::size_t i = begin;
+
+        std::vector<std::uint32_t> symbols;
+        if (level_ > 0) {
+            symbols.reserve(end - begin + 1);
+            const std::uint8_t* data = window_.data();
+
+            auto insert = [&](std::size_t at) -> std::int64_t {
+                const std::int64_t abs = static_cast<std::int64_t>(base_ + at);
+                const std::uint32_t h = hash3(data + at);
+                const std::int64_t chain = head_[h];
+                prev_[static_cast<std::size_t>(abs) & (kWindowSize - 1)] = chain;
+                head_[h] = abs;
+                return chain;
+            };
+
+            while (i < end) {
+                int bestLen = 0;
+                int bestDist = 0;
+
+                if (i + kMinMatch <= avail) {
+                    const std::int64_t abs = static_cast<std::int64_t>(base_ + i);
+                    const int maxLen = static_cast<int>(std::min<std::size_t>(kMaxMatch, avail - i));
+                    const int niceLen = std::min(maxLen, kNiceLength[level_]);
+                    std::int64_t cand = insert(i);
+
+                    for (int chain = maxChain_; cand >= 0 && chain > 0; --chain) {
+                        const std::int64_t dist = abs - cand;
+                        if (dist > static_cast<std::int64_t>(kWindowSize)) break;
+
+                        const std::uint8_t* a = data + i;
+                        const std::uint8_t* b = data + static_cast<std::size_t>(cand - static_cast<std::int64_t>(base_));
+                        if (b[bestLen] == a[bestLen]) {
+                            int len = 0;
+                            while (len < maxLen && a[len] == b[len]) ++len;
+                            if (len > bestLen) {
+                                bestLen = len;
+                                bestDist = static_cast<int>(dist);
+                                if (len >= niceLen) break;
+                            }
+                        }
+
+                        const std::int64_t next = prev_[static_cast<std::size_t>(cand) & (kWindowSize - 1)];
+                        if (next >= cand) break; // slot reused by a newer position
+                        cand = next;
+                    }
+                }
+
+                if (bestLen >= kMinMatch) {
+                    symbols.push_back(kMatchFlag | (static_cast<std::uint32_t>(bestLen) << 16) | static_cast<std::uint32_t>(bestDist));
+                    for (int k = 1; k < bestLen && i + k + kMinMatch <= avail; ++k)
+                        insert(i + k);
+                    i += bestLen;
+                }
+                else {
+                    symbols.push_back(window_[i]);
+                    ++i;
+                }
+            }
+        }
+        else {
+            i = end;
+        }
+
+        emit_block(symbols, begin, i, last);
+        flush_output();
+
+        // keep 32 KB of history in front of the next block
+        pos_ = i;
+        const std::size_t keep = std::min(pos_, kWindowSize);
+        const std::size_t drop = pos_ - keep;
+        if (drop > 0) {
+            window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(drop));
+            base_ += drop;
+            pos_ = keep;
+        }
+    }
+
+    void DeflateEncoder::emit_block(const std::vector<std::uint32_t>& symbols, std::size_t begin, std::size_t end, bool last) {
+        const std::size_t rawSize = end - begin;
+
+        // Stored cost: per 64 KB piece a 3-bit header, byte alignment and LEN/NLEN
+        const std::size_t pieces = std::max<std::size_t>(1, (rawSize + 65534) / 65535);
+        const std::uint64_t storedBits = pieces * (3 + 7 + 32) + rawSize * 8;
+
+        std::uint64_t dynamicBits = ~std::uint64_t(0);
+        std::vector<std::uint8_t> litLens, distLens, clLens;
+        std::vector<CodeLengthSymbol> clSymbols;
+        int hlit = 257, hdist = 1, hclen = 4;
+
+        if (level_ > 0) {
+            std::vector<std::uint32_t> litFreq(286, 0), distFreq(30, 0);
+            for (std::uint32_t s : symbols) {
+                if (s & kMatchFlag) {
+                    ++litFreq[257 + length_code(static_cast<int>((s >> 16) & 0x1FF))];
+                    ++distFreq[dist_code(static_cast<int>(s & 0xFFFF))];
+                }
+                else {
+                    ++litFreq[s];
+                }
+            }
+            litFreq[256] = 1;
+
+            litLens = build_lengths(litFreq, 15);
+            distLens = build_lengths(distFreq, 15);
+
+            hlit = 286;
+            while (hlit > 257 && litLens[hlit - 1] == 0) --hlit;
+            hdist = 30;
+            while (hdist > 1 && distLens[hdist - 1] == 0) --hdist;
+
+            std::vector<std::uint8_t> all(litLens.begin(), litLens.begin() + hlit);
+            all.insert(all.end(), distLens.begin(), distLens.begin() + hdist);
+            clSymbols = encode_code_lengths(all);
+
+            std::vector<std::uint32_t> clFreq(19, 0);
+            for (const CodeLengthSymbol& c : clSymbols) ++clFreq[c.symbol];
+            clLens = build_lengths(clFreq, 7);
+            hclen = 19;
+            while (hclen > 4 && clLens[kCodeLengthOrder[hclen - 1]] == 0) --hclen;
+
+            std::uint64_t bits = 3 + 5 + 5 + 4 + 3 * static_cast<std::uint64_t>(hclen);
+            for (const CodeLengthSymbol& c : clSymbols) {
+                bits += clLens[c.symbol];
+                bits += (c.symbol == 16) ? 2 : (c.symbol == 17) ? 3 : (c.symbol == 18) ? 7 : 0;
+            }
+            for (int s = 0; s < 286; ++s) {
+                if (!litFreq[s]) continue;
+                std::uint64_t extra = (s > 256) ? kLengthExtra[s - 257] : 0;
+                bits += litFreq[s] * (litLens[s] + extra);
+            }
+            for (int d = 0; d < 30; ++d)
+                bits += distFreq[d] * static_cast<std::uint64_t>(distLens[d] + kDistExtra[d]);
+            dynamicBits = bits;
+        }
+
+        if (storedBits <= dynamicBits) {
+            std::size_t at = begin;
+            for (std::size_t p = 0; p < pieces; ++p) {
+                const std::size_t n = std::min<std::size_t>(end - at, 65535);
+                const bool final = last && (p + 1 == pieces);
+                put_bits(final ? 1 : 0, 1);
+                put_bits(0, 2);
+                align_to_byte();
+                put_bits(static_cast<std::uint32_t>(n), 16);
+                put_bits(static_cast<std::uint32_t>(~n & 0xFFFF), 16);
+                out_.insert(out_.end(), window_.begin() + static_cast<std::ptrdiff_t>(at),
+                    window_.begin() + static_cast<std::ptrdiff_t>(at + n));
+                at += n;
+            }
+            return;
+        }
+
+        const std::vector<std::uint16_t> litCodes = build_codes(litLens);
+        const std::vector<std::uint16_t> distCodes = build_codes(distLens);
+        const std::vector<std::uint16_t> clCodes = build_codes(clLens);
+
+        put_bits(last ? 1 : 0, 1);
+        put_bits(2, 2);
+        put_bits(static_cast<std::uint32_t>(hlit - 257), 5);
+        put_bits(static_cast<std::uint32_t>(hdist - 1), 5);
+        put_bits(static_cast<std::uint32_t>(hclen - 4), 4);
+        for (int k = 0; k < hclen; ++k)
+            put_bits(clLens[kCodeLengthOrder[k]], 3);
+
+        for (const CodeLengthSymbol& c : clSymbols) {
+            put_bits(clCodes[c.symbol], clLens[c.symbol]);
+            if (c.symbol == 16) put_bits(c.extra, 2);
+            else if (c.symbol == 17) put_bits(c.extra, 3);
+            else if (c.symbol == 18) put_bits(c.extra, 7);
+        }
+
+        for (std::uint32_t s : symbols) {
+            if (s & kMatchFlag) {
+                const int len = static_cast<int>((s >> 16) & 0x1FF);
+                const int dist = static_cast<int>(s & 0xFFFF);
+                const int lc = length_code(len);
+                put_bits(litCodes[257 + lc], litLens[257 + lc]);
+                put_bits(static_cast<std::uint32_t>(len - kLengthBase[lc]), kLengthExtra[lc]);
+                const int dc = dist_code(dist);
+                put_bits(distCodes[dc], distLens[dc]);
+                put_bits(static_cast<std::uint32_t>(dist - kDistBase[dc]), kDistExtra[dc]);
+            }
+            else {
+                put_bits(litCodes[s], litLens[s]);
+            }
+        }
+        put_bits(litCodes[256], litLens[256]);
+    }
+
+    void DeflateEncoder::put_bits(std::uint32_t value, int count) {
+        bits_ |= static_cast<std::uint64_t>(value) << bitCount_;
+        bitCount_ += count;
+        while (bitCount_ >= 8) {
+            out_.push_back(static_cast<std::uint8_t>(bits_));
+            bits_ >>= 8;
+            bitCount_ -= 8;
+        }
+    }
+
+    void DeflateEncoder::align_to_byte() {
+        if (bitCount_ > 0) put_bits(0, 8 - bitCount_);
+    }
+
+    void DeflateEncoder::flush_output() {
+        if (out_.empty()) return;
+        sink_(out_.data(), out_.size());
+        out_.clear();
+    }
+
+    // -----------------------------
+    // zlib framing
+    // -----------------------------
+    std::array<std::uint8_t, 2> zlib_header(int level) {
+        // CMF: deflate, 32 KB window. FLG: level hint, FCHECK makes the pair a multiple of 31
+        const std::uint32_t cmf = 0x78;
+        const std::uint32_t hint = (level <= 1) ? 0 : (level <= 5) ? 1 : (level == 6) ? 2 : 3;
+        std::uint32_t flg = hint << 6;
+        flg |= 31 - ((cmf << 8) | flg) % 31;
+        return { static_cast<std::uint8_t>(cmf), static_cast<std::uint8_t>(flg) };
+    }
+
+    std::uint32_t adler32_update(std::uint32_t adler, const std::uint8_t* data, std::size_t size) {
+        // reduced often enough that the 32-bit sums cannot overflow
+        const std::uint32_t mod = 65521;
+        std::uint32_t a = adler & 0xFFFF;
+        std::uint32_t b = adler >> 16;
+        for (std::size_t i = 0; i < size;) {
+            std::size_t n = std::min<std::size_t>(size - i, 5552);
+            for (std::size_t k = 0; k < n; ++k) {
+                a += data[i + k];
+                b += a;
+            }
+            a %= mod;
+            b %= mod;
+            i += n;
+        }
+        return (b << 16) | a;
+    }
+
+} // namespace Noise
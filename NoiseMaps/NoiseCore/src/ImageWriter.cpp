@@ -0,0 +1,622 @@
+// ImageWriter.cpp
+#include "ImageWriter.hpp"
+#include "Deflate.hpp"
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    class ImageWriter::Encoder {
+    public:
+        virtual ~Encoder() = default;
+        virtual void write_row(const unsigned char* row) = 0;
+        virtual void finish() = 0;
+    };
+
+    namespace {
+
+        // Owns the output file; every failed write is reported with the path
+        class FileSink {
+        public:
+            explicit FileSink(const std::filesystem::path& path)
+                : path_(path), file_(path, std::ios::binary | std::ios::trunc) {
+                if (!file_) throw std::runtime_error("Failed to write image file: " + path.string());
+            }
+
+            void put(const void* data, std::size_t size) {
+                file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+                stats_add_written(size);
+            }
+
+            void close() {
+                file_.close();
+                if (!file_) throw std::runtime_error("Failed to write image file: " + path_.string());
+            }
+
+        private:
+            std::filesystem::path path_;
+            std::ofstream file_;
+        };
+
+        // -----------------------------
+        // PNG (8-bit grayscale)
+        // -----------------------------
+        std::uint32_t crc32_update(std::uint32_t crc, const std::uint8_t* data, std::size_t size) {
+            static const std::array<std::uint32_t, 256> table = []() {
+                std::array<std::uint32_t, 256> t{};
+                for (std::uint32_t n = 0; n < 256; ++n) {
+                    std::uint32_t c = n;
+                    for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    t[n] = c;
+                }
+                return t;
+            }();
+            for (std::size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return crc;
+        }
+
+        void put_be32(std::uint8_t* p, std::uint32_t v) {
+            p[0] = static_cast<std::uint8_t>(v >> 24);
+            p[1] = static_cast<std::uint8_t>(v >> 16);
+            p[2] = static_cast<std::uint8_t>(v >> 8);
+            p[3] = static_cast<std::uint8_t>(v);
+        }
+
+        int paeth(int a, int b, int c) {
+            int p = a + b - c;
+            int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            if (pa <= pb && pa <= pc) return a;
+            if (pb <= pc) return b;
+            return c;
+        }
+
+        // Picks the filter with the smallest sum of absolute residuals (same
+        // heuristic as stb / libpng). `out` receives the filter byte + width bytes;
+        // `bpp` is the distance to the same channel of the pixel on the left.
+        void filter_row(const std::uint8_t* row, const std::uint8_t* prev, std::size_t width, std::size_t bpp,
+            std::uint8_t* out, std::uint8_t* scratch) {
+            long bestCost = -1;
+            for (int type = 0; type < 5; ++type) {
+                scratch[0] = static_cast<std::uint8_t>(type);
+                long cost = 0;
+                for (std::size_t x = 0; x < width; ++x) {
+                    const int a = (x >= bpp) ? row[x - bpp] : 0;
+                    const int b = prev[x];
+                    const int c = (x >= bpp) ? prev[x - bpp] : 0;
+                    int pred = 0;
+                    switch (type) {
+                    case 1: pred = a; break;
+                    case 2: pred = b; break;
+                    case 3: pred = (a + b) >> 1; break;
+                    case 4: pred = paeth(a, b, c); break;
+                    default: break;
+                    }
+                    const std::uint8_t v = static_cast<std::uint8_t>(row[x] - pred);
+                    scratch[x + 1] = v;
+                    cost += std::abs(static_cast<int>(static_cast<std::int8_t>(v)));
+                }
+                if (bestCost < 0 || cost < bestCost) {
+                    bestCost = cost;
+                    std::copy(scratch, scratch + width + 1, out);
+                }
+            }
+        }
+
+        // Rows are buffered into a batch of ~1 MB segments, one or more per pool
+        // thread. A full batch is filtered and deflated segment-parallel: every
+        // segment is compressed on its own with the 32 KB before it as dictionary
+        // and ends with a sync flush, so the pieces concatenate into one zlib
+        // stream that compresses within a fraction of a percent of a serial one.
+        class PngEncoder : public ImageWriter::Encoder {
+        public:
+            PngEncoder(const std::filesystem::path& path, int width, int height, int channels, int level, int threads)
+                : file_(path),
+                  rowBytes_(static_cast<std::size_t>(width) * channels),
+                  channels_(static_cast<std::size_t>(channels)),
+                  level_(level),
+                  threads_(threads),
+                  prev_(rowBytes_, 0) {
+                constexpr std::size_t segmentBytes = 1024 * 1024;
+                segmentRows_ = std::max<std::size_t>(1, segmentBytes / (rowBytes_ + 1));
+                batchRows_ = segmentRows_ * resolve_thread_count(threads);
+                raw_.resize(batchRows_ * rowBytes_);
+
+                static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+                file_.put(signature, sizeof(signature));
+
+                std::uint8_t ihdr[13];
+                put_be32(ihdr, static_cast<std::uint32_t>(width));
+                put_be32(ihdr + 4, static_cast<std::uint32_t>(height));
+                ihdr[8] = 8;   // bit depth
+                ihdr[9] = (channels == 3) ? 2 : 0;   // RGB or grayscale
+                ihdr[10] = 0;  // deflate
+                ihdr[11] = 0;  // adaptive filtering
+                ihdr[12] = 0;  // no interlace
+                write_chunk("IHDR", ihdr, sizeof(ihdr));
+
+                const std::array<std::uint8_t, 2> header = zlib_header(level);
+                idat_.assign(header.begin(), header.end());
+            }
+
+            void write_row(const unsigned char* row) override {
+                std::copy(row, row + rowBytes_, raw_.data() + pending_ * rowBytes_);
+                if (++pending_ == batchRows_) flush_batch();
+            }
+
+            void finish() override {
+                flush_batch();
+                idat_.insert(idat_.end(), DeflateFinalEmptyBlock.begin(), DeflateFinalEmptyBlock.end());
+                std::uint8_t trailer[4];
+                put_be32(trailer, adler_);
+                idat_.insert(idat_.end(), trailer, trailer + 4);
+                flush_idat(true);
+                write_chunk("IEND", nullptr, 0);
+                file_.close();
+            }
+
+        private:
+            void flush_batch() {
+                if (pending_ == 0) return;
+
+                const std::size_t lineBytes = rowBytes_ + 1;
+                const std::size_t segments = (pending_ + segmentRows_ - 1) / segmentRows_;
+                filtered_.resize(pending_ * lineBytes);
+
+                // 1) filter: each row only needs the raw row above it
+                parallel_for(segments, [&](std::size_t seg) {
+                    std::vector<std::uint8_t> scratch(lineBytes);
+                    const std::size_t r0 = seg * segmentRows_;
+                    const std::size_t r1 = std::min(r0 + segmentRows_, pending_);
+                    for (std::size_t r = r0; r < r1; ++r) {
+                        const std::uint8_t* above = r ? raw_.data() + (r - 1) * rowBytes_ : prev_.data();
+                        filter_row(raw_.data() + r * rowBytes_, above, rowBytes_, channels_, filtered_.data() + r * lineBytes, scratch.data());
+                    }
+                }, threads_);
+
+                // 2) deflate each segment against the 32 KB of filtered data before it
+                std::vector<std::vector<std::uint8_t>> compressed(segments);
+                parallel_for(segments, [&](std::size_t seg) {
+                    const std::size_t begin = seg * segmentRows_ * lineBytes;
+                    const std::size_t end = std::min((seg + 1) * segmentRows_, pending_) * lineBytes;
+
+                    std::vector<std::uint8_t> dictionary;
+                    constexpr std::size_t window = 32768;
+                    if (begin < window) dictionary.assign(history_.end() - std::min(history_.size(), window - begin), history_.end());
+                    dictionary.insert(dictionary.end(), filtered_.begin() + static_cast<std::ptrdiff_t>(begin - std::min(begin, window)),
+                        filtered_.begin() + static_cast<std::ptrdiff_t>(begin));
+
+                    std::vector<std::uint8_t>& out = compressed[seg];
+                    DeflateEncoder deflate([&out](const std::uint8_t* p, std::size_t n) { out.insert(out.end(), p, p + n); }, level_);
+                    deflate.set_dictionary(dictionary.data(), dictionary.size());
+                    deflate.write(filtered_.data() + begin, end - begin);
+                    deflate.sync_flush();
+                }, threads_);
+
+                adler_ = adler32_update(adler_, filtered_.data(), filtered_.size());
+                for (const std::vector<std::uint8_t>& piece : compressed) {
+                    idat_.insert(idat_.end(), piece.begin(), piece.end());
+                    flush_idat(false);
+                }
+
+                // carry the last raw row and 32 KB of filtered history into the next batch
+                std::copy(raw_.data() + (pending_ - 1) * rowBytes_, raw_.data() + pending_ * rowBytes_, prev_.begin());
+                history_.insert(history_.end(), filtered_.end() - static_cast<std::ptrdiff_t>(std::min<std::size_t>(filtered_.size(), 32768)), filtered_.end());
+                if (history_.size() > 32768) history_.erase(history_.begin(), history_.end() - 32768);
+                pending_ = 0;
+            }
+
+            void write_chunk(const char* type, const std::uint8_t* data, std::size_t size) {
+                std::uint8_t header[8];
+                put_be32(header, static_cast<std::uint32_t>(size));
+                std::copy(type, type + 4, header + 4);
+                std::uint32_t crc = crc32_update(0xFFFFFFFFu, header + 4, 4);
+                crc = crc32_update(crc, data, size);
+                std::uint8_t trailer[4];
+                put_be32(trailer, crc ^ 0xFFFFFFFFu);
+
+                file_.put(header, sizeof(header));
+                if (size) file_.put(data, size);
+                file_.put(trailer, sizeof(trailer));
+            }
+
+            // Compressed data goes out in IDAT chunks of about 256 KB as it is produced
+            void flush_idat(bool all) {
+                constexpr std::size_t chunkSize = 256 * 1024;
+                std::size_t at = 0;
+                while (idat_.size() - at >= chunkSize || (all && at < idat_.size())) {
+                    std::size_t n = std::min(chunkSize, idat_.size() - at);
+                    write_chunk("IDAT", idat_.data() + at, n);
+                    at += n;
+                }
+                idat_.erase(idat_.begin(), idat_.begin() + static_cast<std::ptrdiff_t>(at));
+            }
+
+            FileSink file_;
+            std::size_t rowBytes_;
+            std::size_t channels_;
+            int level_;
+            int threads_;
+            std::size_t segmentRows_ = 1;
+            std::size_t batchRows_ = 1;
+            std::size_t pending_ = 0;
+            std::vector<std::uint8_t> raw_;       // batchRows_ x rowBytes_ unfiltered rows
+            std::vector<std::uint8_t> prev_;      // raw row above the batch
+            std::vector<std::uint8_t> filtered_;  // filter byte + row, per pending row
+            std::vector<std::uint8_t> history_;   // last 32 KB of filtered data already compressed
+            std::vector<std::uint8_t> idat_;
+            std::uint32_t adler_ = 1;
+        };
+
+        // -----------------------------
+        // JPEG (baseline, single grayscale component)
+        // -----------------------------
+        constexpr std::uint8_t kZigZag[64] = {
+            0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+            12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+            35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+            58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63 };
+
+        // ITU T.81 Annex K luminance tables
+        constexpr std::uint8_t kLumaQuant[64] = {
+            16, 11, 10, 16, 24, 40, 51, 61,
+            12, 12, 14, 19, 26, 58, 60, 55,
+            14, 13, 16, 24, 40, 57, 69, 56,
+            14, 17, 22, 29, 51, 87, 80, 62,
+            18, 22, 37, 56, 68, 109, 103, 77,
+            24, 35, 55, 64, 81, 104, 113, 92,
+            49, 64, 78, 87, 103, 121, 120, 101,
+            72, 92, 95, 98, 112, 100, 103, 99 };
+
+        constexpr std::uint8_t kDcBits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+        constexpr std::uint8_t kDcValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+        constexpr std::uint8_t kAcBits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+        constexpr std::uint8_t kAcValues[162] = {
+            0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+            0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+            0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+            0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+            0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+            0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+            0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+            0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+            0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+            0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+            0xf9, 0xfa };
+
+        struct HuffmanTable {
+            std::uint16_t code[256] = {};
+            std::uint8_t size[256] = {};
+        };
+
+        HuffmanTable make_huffman(const std::uint8_t* bits, const std::uint8_t* values) {
+            HuffmanTable t;
+            std::uint16_t code = 0;
+            int k = 0;
+            for (int len = 1; len <= 16; ++len) {
+                for (int i = 0; i < bits[len - 1]; ++i, ++k) {
+                    t.code[values[k]] = code++;
+                    t.size[values[k]] = static_cast<std::uint8_t>(len);
+                }
+                code = static_cast<std::uint16_t>(code << 1);
+            }
+            return t;
+        }
+
+        class JpegEncoder : public ImageWriter::Encoder {
+        public:
+            JpegEncoder(const std::filesystem::path& path, int width, int height, int quality)
+                : file_(path),
+                  width_(width),
+                  height_(height),
+                  paddedWidth_(static_cast<std::size_t>((width + 7) / 8) * 8),
+                  strip_(paddedWidth_ * 8, 0) {
+                if (width > 65535 || height > 65535)
+                    throw std::invalid_argument("JPEG dimensions must be <= 65535, got: " + std::to_string(width) + "x" + std::to_string(height));
+
+                quality = std::clamp(quality, 1, 100);
+                const int scale = (quality < 50) ? 5000 / quality : 200 - quality * 2;
+                for (int i = 0; i < 64; ++i)
+                    quant_[i] = static_cast<std::uint8_t>(std::clamp((kLumaQuant[i] * scale + 50) / 100, 1, 255));
+
+                // Orthonormal 8-point DCT-II basis
+                const double pi = 3.14159265358979323846;
+                for (int u = 0; u < 8; ++u)
+                    for (int x = 0; x < 8; ++x)
+                        basis_[u][x] = static_cast<float>((u == 0 ? std::sqrt(0.125) : 0.5) * std::cos((2 * x + 1) * u * pi / 16.0));
+
+                dc_ = make_huffman(kDcBits, kDcValues);
+                ac_ = make_huffman(kAcBits, kAcValues);
+                write_headers();
+            }
+
+            void write_row(const unsigned char* row) override {
+                std::uint8_t* dst = strip_.data() + static_cast<std::size_t>(stripRows_) * paddedWidth_;
+                std::copy(row, row + width_, dst);
+                std::fill(dst + width_, dst + paddedWidth_, row[width_ - 1]);
+                if (++stripRows_ == 8) encode_strip();
+            }
+
+            void finish() override {
+                if (stripRows_ > 0) {
+                    // repeat the last row to fill the final strip
+                    const std::uint8_t* last = strip_.data() + static_cast<std::size_t>(stripRows_ - 1) * paddedWidth_;
+                    for (int r = stripRows_; r < 8; ++r)
+                        std::copy(last, last + paddedWidth_, strip_.data() + static_cast<std::size_t>(r) * paddedWidth_);
+                    encode_strip();
+                }
+                // pad the entropy-coded segment with 1 bits, then EOI
+                if (bitCount_ > 0) put_bits((1u << (8 - bitCount_)) - 1, 8 - bitCount_);
+                out_.push_back(0xFF);
+                out_.push_back(0xD9);
+                flush();
+                file_.close();
+            }
+
+        private:
+            void write_headers() {
+                const std::uint8_t soiApp0[] = {
+                    0xFF, 0xD8,                                          // SOI
+                    0xFF, 0xE0, 0, 16, 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 }; // JFIF 1.01
+                out_.insert(out_.end(), soiApp0, soiApp0 + sizeof(soiApp0));
+
+                // DQT, 8-bit table 0, zigzag order
+                const std::uint8_t dqt[] = { 0xFF, 0xDB, 0, 67, 0 };
+                out_.insert(out_.end(), dqt, dqt + sizeof(dqt));
+                for (int k = 0; k < 64; ++k) out_.push_back(quant_[kZigZag[k]]);
+
+                // SOF0: 8-bit precision, one component (id 1, 1x1 sampling, quant table 0)
+                const std::uint8_t sof[] = {
+                    0xFF, 0xC0, 0, 11, 8,
+                    static_cast<std::uint8_t>(height_ >> 8), static_cast<std::uint8_t>(height_),
+                    static_cast<std::uint8_t>(width_ >> 8), static_cast<std::uint8_t>(width_),
+                    1, 1, 0x11, 0 };
+                out_.insert(out_.end(), sof, sof + sizeof(sof));
+
+                write_dht(0x00, kDcBits, kDcValues, sizeof(kDcValues));
+                write_dht(0x10, kAcBits, kAcValues, sizeof(kAcValues));
+
+                // SOS: component 1 uses DC/AC table 0, full spectral range
+                const std::uint8_t sos[] = { 0xFF, 0xDA, 0, 8, 1, 1, 0x00, 0, 63, 0 };
+                out_.insert(out_.end(), sos, sos + sizeof(sos));
+            }
+
+            void write_dht(std::uint8_t classId, const std::uint8_t* bits, const std::uint8_t* values, std::size_t count) {
+                const std::size_t length = 2 + 1 + 16 + count;
+                out_.push_back(0xFF);
+                out_.push_back(0xC4);
+                out_.push_back(static_cast<std::uint8_t>(length >> 8));
+                out_.push_back(static_cast<std::uint8_t>(length));
+                out_.push_back(classId);
+                out_.insert(out_.end(), bits, bits + 16);
+                out_.insert(out_.end(), values, values + count);
+            }
+
+            void encode_strip() {
+                for (std::size_t bx = 0; bx < paddedWidth_; bx += 8)
+                    encode_block(strip_.data() + bx);
+                stripRows_ = 0;
+                if (out_.size() >= 256 * 1024) flush();
+            }
+
+            void encode_block(const std::uint8_t* src) {
+                float block[8][8];
+                for (int y = 0; y < 8; ++y)
+                    for (int x = 0; x < 8; ++x)
+                        block[y][x] = static_cast<float>(src[static_cast<std::size_t>(y) * paddedWidth_ + x]) - 128.0f;
+
+                // separable DCT: rows, then columns
+                float tmp[8][8];
+                for (int y = 0; y < 8; ++y)
+                    for (int u = 0; u < 8; ++u) {
+                        float s = 0.0f;
+                        for (int x = 0; x < 8; ++x) s += basis_[u][x] * block[y][x];
+                        tmp[y][u] = s;
+                    }
+
+                int coef[64];
+                for (int v = 0; v < 8; ++v)
+                    for (int u = 0; u < 8; ++u) {
+                        float s = 0.0f;
+                        for (int y = 0; y < 8; ++y) s += basis_[v][y] * tmp[y][u];
+                        coef[v * 8 + u] = static_cast<int>(std::lround(s / quant_[v * 8 + u]));
+                    }
+
+                const int diff = coef[0] - prevDc_;
+                prevDc_ = coef[0];
+                const int dcSize = magnitude_bits(diff);
+                put_bits(dc_.code[dcSize], dc_.size[dcSize]);
+                if (dcSize) put_bits(magnitude_value(diff, dcSize), dcSize);
+
+                int run = 0;
+                for (int k = 1; k < 64; ++k) {
+                    const int c = coef[kZigZag[k]];
+                    if (c == 0) { ++run; continue; }
+                    while (run > 15) {
+                        put_bits(ac_.code[0xF0], ac_.size[0xF0]);  // ZRL
+                        run -= 16;
+                    }
+                    const int size = magnitude_bits(c);
+                    const int symbol = (run << 4) | size;
+                    put_bits(ac_.code[symbol], ac_.size[symbol]);
+                    put_bits(magnitude_value(c, size), size);
+                    run = 0;
+                }
+                if (run > 0) put_bits(ac_.code[0x00], ac_.size[0x00]);  // EOB
+            }
+
+            static int magnitude_bits(int v) {
+                int a = std::abs(v), n = 0;
+                while (a) { ++n; a >>= 1; }
+                return n;
+            }
+
+            // negative values are sent as v - 1 in `size` bits (one's complement)
+            static std::uint32_t magnitude_value(int v, int size) {
+                return static_cast<std::uint32_t>(v < 0 ? v - 1 : v) & ((1u << size) - 1);
+            }
+
+            // MSB-first bit packing with 0xFF byte stuffing
+            void put_bits(std::uint32_t value, int count) {
+                bits_ = (bits_ << count) | value;
+                bitCount_ += count;
+                while (bitCount_ >= 8) {
+                    const std::uint8_t byte = static_cast<std::uint8_t>(bits_ >> (bitCount_ - 8));
+                    out_.push_back(byte);
+                    if (byte == 0xFF) out_.push_back(0x00);
+                    bitCount_ -= 8;
+                }
+                bits_ &= (std::uint64_t(1) << bitCount_) - 1;
+            }
+
+            void flush() {
+                file_.put(out_.data(), out_.size());
+                out_.clear();
+            }
+
+            FileSink file_;
+            int width_;
+            int height_;
+            std::size_t paddedWidth_;
+            std::vector<std::uint8_t> strip_;
+            int stripRows_ = 0;
+            std::uint8_t quant_[64];
+            float basis_[8][8];
+            HuffmanTable dc_;
+            HuffmanTable ac_;
+            int prevDc_ = 0;
+            std::uint64_t bits_ = 0;
+            int bitCount_ = 0;
+            std::vector<std::uint8_t> out_;
+        };
+
+        bool is_jpeg(const std::filesystem::path& path) {
+            std::string extension = path.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            return extension == ".jpg" || extension == ".jpeg";
+        }
+    }
+
+    // -----------------------------
+    // ImageWriter
+    // -----------------------------
+    ImageWriter::ImageWriter(const std::filesystem::path& path, int width, int height, const ImageOptions& options)
+        : path_(path), width_(width), height_(height) {
+        if (width <= 0) throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0) throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        if (options.compressionLevel < 0 || options.compressionLevel > 9)
+            throw std::invalid_argument("compressionLevel must be in [0, 9], got: " + std::to_string(options.compressionLevel));
+
+        if (options.channels != 1 && options.channels != 3)
+            throw std::invalid_argument("channels must be 1 or 3, got: " + std::to_string(options.channels));
+        if (options.channels == 3 && is_jpeg(path))
+            throw std::invalid_argument("RGB images are only written as PNG: " + path.string());
+
+        StageTimer timer(Stage::Setup);
+        channels_ = options.channels;
+        pixels_.resize(static_cast<std::size_t>(width) * channels_);
+        if (is_jpeg(path)) encoder_ = std::make_unique<JpegEncoder>(path, width, height, options.jpegQuality);
+        else encoder_ = std::make_unique<PngEncoder>(path, width, height, channels_, options.compressionLevel, options.threads);
+    }
+
+    void quantize_row(const float* in, unsigned char* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            out[i] = static_cast<unsigned char>(std::clamp(in[i], 0.0f, 1.0f) * 255.0f);
+    }
+
+    // An unfinished image is left truncated on disk
+    ImageWriter::~ImageWriter() = default;
+
+    void ImageWriter::write_row(const float* row) {
+        if (!encoder_) throw std::runtime_error("ImageWriter already finished: " + path_.string());
+        if (rowsWritten_ >= height_)
+            throw std::runtime_error("ImageWriter received more than " + std::to_string(height_) + " rows: " + path_.string());
+
+        // per-row timers feed the stats only; write_rows traces whole bands
+        {
+            StageTimer timer(Stage::Quantize, false);
+            quantize_row(row, pixels_.data(), pixels_.size());
+        }
+        StageTimer timer(Stage::Encode, false);
+        encoder_->write_row(pixels_.data());
+        ++rowsWritten_;
+    }
+
+    void ImageWriter::write_rows(const NoiseMap2D& band) {
+        if (channels_ != 1)
+            throw std::invalid_argument("write_rows needs a grayscale image: " + path_.string());
+        if (band.width() != width_)
+            throw std::invalid_argument("band width " + std::to_string(band.width()) + " does not match image width " + std::to_string(width_));
+        TraceSpan span("write_rows", "image", rowsWritten_);
+        for (int y = 0; y < band.height(); ++y)
+            write_row(band.row(y));
+    }
+
+    void ImageWriter::finish() {
+        if (!encoder_) return;
+        if (rowsWritten_ != height_)
+            throw std::runtime_error("ImageWriter got " + std::to_string(rowsWritten_) + " of " + std::to_string(height_) + " rows: " + path_.string());
+        StageTimer timer(Stage::Encode);
+        encoder_->finish();
+        encoder_.reset();
+    }
+
+    std::filesystem::path resolve_image_path(const std::string& filename, const std::string& outputDir) {
+        std::filesystem::path outDir;
+        if (outputDir.empty()) {
+            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
+        }
+        else {
+            outDir = outputDir;
+        }
+        std::filesystem::create_directories(outDir);
+        return outDir / filename;
+    }
+
+    void write_image(const NoiseMap2D& map, const std::filesystem::path& path, const ImageOptions& options) {
+        if (map.empty()) {
+            throw std::invalid_argument("Cannot save empty noise map.");
+        }
+        StatsScope stats("write_image", pixel_count(map.width(), map.height()));
+        ImageWriter writer(path, map.width(), map.height(), options);
+        writer.write_rows(map);
+        writer.finish();
+    }
+
+    void stream_image(const std::filesystem::path& path, int width, int height,
+        const std::function<NoiseMap2D(int y0, int rows)>& produce, const ImageOptions& options) {
+        StatsScope stats("stream_image", pixel_count(width, height));
+        ImageWriter writer(path, width, height, options);
+
+        // ~4 MB bands keep the pipeline busy without holding much of the image
+        const int bandRows = rows_per_band(width, 4 * 1024 * 1024);
+        auto rows_at = [&](int y0) { return std::min(bandRows, height - y0); };
+
+        NoiseMap2D current = produce(0, rows_at(0));
+        for (int y0 = 0; y0 < height; y0 += bandRows) {
+            const int next = y0 + bandRows;
+            NoiseMap2D upcoming;
+
+            // task 0 encodes the current band, task 1 generates the next one
+            parallel_for(next < height ? 2 : 1, [&](std::size_t task) {
+                if (task == 0) writer.write_rows(current);
+                else upcoming = produce(next, rows_at(next));
+            }, options.threads);
+
+            current = std::move(upcoming);
+        }
+        writer.finish();
+    }
+
+} // namespace Noise
@@ -0,0 +1,338 @@
+// MapFile.cpp
+#include "MapFile.hpp"
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Noise {
+
+    namespace {
+        constexpr char kMagic[8] = { 'R', 'E', 'L', 'N', 'O', 'M', 'A', 'P' };
+        constexpr std::uint32_t kVersion = 1;
+
+        // On-disk header, little-endian (the layout of every supported target)
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t headerSize;
+            std::uint32_t width;
+            std::uint32_t height;
+            std::uint64_t stride;      // samples per payload row
+            std::uint32_t format;
+            std::uint32_t type;
+            std::int64_t seed;
+            std::int64_t originX;
+            std::int64_t originY;
+            std::uint32_t paramCount;
+            std::uint32_t reserved;
+            double params[MappedMap::MaxParams];
+            std::uint8_t padding[56];
+        };
+        static_assert(sizeof(FileHeader) == MappedMap::HeaderSize, "map file header must stay 256 bytes");
+
+        std::size_t sample_size(SampleFormat format) {
+            return format == SampleFormat::UInt16 ? sizeof(std::uint16_t) : sizeof(float);
+        }
+
+        // Rows padded to 64 bytes, matching NoiseMap2D for Float32
+        std::size_t padded_stride(int width, SampleFormat format) {
+            const std::size_t perLine = 64 / sample_size(format);
+            return (static_cast<std::size_t>(width) + perLine - 1) / perLine * perLine;
+        }
+
+        [[noreturn]] void fail(const std::string& what, const std::filesystem::path& path) {
+            throw std::runtime_error(what + ": " + path.string());
+        }
+    }
+
+    // -----------------------------
+    // Mapping lifetime
+    // -----------------------------
+    MappedMap::~MappedMap() {
+        unmap();
+    }
+
+    MappedMap::MappedMap(MappedMap&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedMap& MappedMap::operator=(MappedMap&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base_ = other.base_;
+            length_ = other.length_;
+            payloadOffset_ = other.payloadOffset_;
+            writable_ = other.writable_;
+#if defined(_WIN32)
+            file_ = other.file_;
+            mapping_ = other.mapping_;
+            other.file_ = other.mapping_ = nullptr;
+#endif
+            width_ = other.width_;
+            height_ = other.height_;
+            stride_ = other.stride_;
+            format_ = other.format_;
+            info_ = std::move(other.info_);
+            view_ = std::move(other.view_);
+            other.base_ = nullptr;
+            other.length_ = 0;
+            other.width_ = other.height_ = 0;
+            other.stride_ = 0;
+        }
+        return *this;
+    }
+
+    void MappedMap::unmap() noexcept {
+        if (!base_) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(base_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = mapping_ = nullptr;
+#else
+        munmap(base_, length_);
+#endif
+        base_ = nullptr;
+        length_ = 0;
+        view_ = NoiseMap2D();
+    }
+
+    MappedMap MappedMap::create(const std::filesystem::path& path, int width, int height,
+        SampleFormat format, const MapInfo& info) {
+        if (width <= 0) throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0) throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        if (info.params.size() > MaxParams)
+            throw std::invalid_argument("map files hold at most 16 parameters, got: " + std::to_string(info.params.size()));
+
+        StageTimer timer(Stage::Setup);
+        MappedMap m;
+        m.width_ = width;
+        m.height_ = height;
+        m.format_ = format;
+        m.info_ = info;
+        m.stride_ = padded_stride(width, format);
+        m.payloadOffset_ = HeaderSize;
+        m.length_ = HeaderSize + m.stride_ * static_cast<std::size_t>(height) * sample_size(format);
+        m.writable_ = true;
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail("Failed to create map file", path);
+        ULARGE_INTEGER size;
+        size.QuadPart = static_cast<ULONGLONG>(m.length_);
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        if (!mapping) { CloseHandle(file); fail("Failed to map map file", path); }
+        m.base_ = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, m.length_);
+        if (!m.base_) { CloseHandle(mapping); CloseHandle(file); fail("Failed to map map file", path); }
+        m.file_ = file;
+        m.mapping_ = mapping;
+#else
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail("Failed to create map file", path);
+        if (::ftruncate(fd, static_cast<off_t>(m.length_)) != 0) { ::close(fd); fail("Failed to size map file", path); }
+        void* base = ::mmap(nullptr, m.length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) fail("Failed to map map file", path);
+        m.base_ = base;
+#endif
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.headerSize = static_cast<std::uint32_t>(HeaderSize);
+        header.width = static_cast<std::uint32_t>(width);
+        header.height = static_cast<std::uint32_t>(height);
+        header.stride = m.stride_;
+        header.format = static_cast<std::uint32_t>(format);
+        header.type = static_cast<std::uint32_t>(info.type);
+        header.seed = info.seed;
+        header.originX = info.originX;
+        header.originY = info.originY;
+        header.paramCount = static_cast<std::uint32_t>(info.params.size());
+        std::copy(info.params.begin(), info.params.end(), header.params);
+        std::memcpy(m.base_, &header, sizeof(header));
+        stats_add_written(m.length_);
+
+        if (format == SampleFormat::Float32) {
+            float* payload = reinterpret_cast<float*>(static_cast<char*>(m.base_) + m.payloadOffset_);
+            m.view_ = NoiseMap2D::view(payload, width, height, m.stride_);
+        }
+        return m;
+    }
+
+    MappedMap MappedMap::open(const std::filesystem::path& path) {
+        MappedMap m;
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail("Failed to open map file", path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) { CloseHandle(file); fail("Failed to open map file", path); }
+        m.length_ = static_cast<std::size_t>(size.QuadPart);
+        if (m.length_ < HeaderSize) { CloseHandle(file); fail("Invalid map file (truncated header)", path); }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mapping) { CloseHandle(file); fail("Failed to map map file", path); }
+        m.base_ = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!m.base_) { CloseHandle(mapping); CloseHandle(file); fail("Failed to map map file", path); }
+        m.file_ = file;
+        m.mapping_ = mapping;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail("Failed to open map file", path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd); fail("Failed to open map file", path); }
+        m.length_ = static_cast<std::size_t>(st.st_size);
+        if (m.length_ < HeaderSize) { ::close(fd); fail("Invalid map file (truncated header)", path); }
+        // private writable mapping: zero-copy reads, copy-on-write for callers that modify map()
+        void* base = ::mmap(nullptr, m.length_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) fail("Failed to map map file", path);
+        m.base_ = base;
+#endif
+
+        FileHeader header;
+        std::memcpy(&header, m.base_, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) fail("Invalid map file (bad magic)", path);
+        if (header.version != kVersion)
+            fail("Unsupported map file version " + std::to_string(header.version), path);
+        if (header.headerSize < HeaderSize || header.headerSize % 64 != 0)
+            fail("Invalid map file (bad header size)", path);
+        if (header.format > static_cast<std::uint32_t>(SampleFormat::UInt16))
+            fail("Invalid map file (unknown sample format)", path);
+        if (header.width == 0 || header.height == 0 || header.width > 0x7fffffffu || header.height > 0x7fffffffu
+            || header.stride < header.width || header.paramCount > MaxParams)
+            fail("Invalid map file (bad dimensions)", path);
+
+        m.width_ = static_cast<int>(header.width);
+        m.height_ = static_cast<int>(header.height);
+        m.stride_ = static_cast<std::size_t>(header.stride);
+        m.format_ = static_cast<SampleFormat>(header.format);
+        m.payloadOffset_ = header.headerSize;
+        // stride comes from the file: bound it by division so the payload size cannot wrap
+        if (header.headerSize > m.length_
+            || header.stride > (m.length_ - header.headerSize) / header.height / sample_size(m.format_))
+            fail("Invalid map file (truncated payload)", path);
+        // rows must keep the 64-byte alignment padded_stride() gives them
+        if (header.stride % padded_stride(1, m.format_) != 0)
+            fail("Invalid map file (bad stride)", path);
+
+        m.info_.type = static_cast<NoiseType>(header.type);
+        m.info_.seed = header.seed;
+        m.info_.originX = header.originX;
+        m.info_.originY = header.originY;
+        m.info_.params.assign(header.params, header.params + header.paramCount);
+
+        if (m.format_ == SampleFormat::Float32) {
+            float* payload = reinterpret_cast<float*>(static_cast<char*>(m.base_) + m.payloadOffset_);
+            m.view_ = NoiseMap2D::view(payload, m.width_, m.height_, m.stride_);
+        }
+        return m;
+    }
+
+    // -----------------------------
+    // Payload access
+    // -----------------------------
+    NoiseMap2D& MappedMap::map() {
+        if (format_ != SampleFormat::Float32 || !base_)
+            throw std::logic_error("MappedMap::map() needs an open Float32 map file");
+        return view_;
+    }
+
+    const NoiseMap2D& MappedMap::map() const {
+        if (format_ != SampleFormat::Float32 || !base_)
+            throw std::logic_error("MappedMap::map() needs an open Float32 map file");
+        return view_;
+    }
+
+    const std::uint16_t* MappedMap::samples_u16() const {
+        if (format_ != SampleFormat::UInt16 || !base_)
+            throw std::logic_error("MappedMap::samples_u16() needs an open UInt16 map file");
+        return reinterpret_cast<const std::uint16_t*>(static_cast<const char*>(base_) + payloadOffset_);
+    }
+
+    NoiseMap2D MappedMap::to_map() const {
+        if (format_ == SampleFormat::Float32) return NoiseMap2D(map());
+
+        NoiseMap2D out(width_, height_);
+        const std::uint16_t* samples = samples_u16();
+        for (int y = 0; y < height_; ++y) {
+            const std::uint16_t* src = samples + static_cast<std::size_t>(y) * stride_;
+            float* dst = out.row(y);
+            for (int x = 0; x < width_; ++x)
+                dst[x] = static_cast<float>(src[x]) * (1.0f / 65535.0f);
+        }
+        return out;
+    }
+
+    void MappedMap::store(const NoiseMap2D& source) {
+        if (!base_) throw std::logic_error("MappedMap::store() on a closed map file");
+        if (source.width() != width_ || source.height() != height_)
+            throw std::invalid_argument("map size " + std::to_string(source.width()) + "x" + std::to_string(source.height())
+                + " does not match file size " + std::to_string(width_) + "x" + std::to_string(height_));
+
+        if (format_ == SampleFormat::Float32) {
+            StageTimer timer(Stage::Encode);
+            for (int y = 0; y < height_; ++y)
+                std::memcpy(view_.row(y), source.row(y), sizeof(float) * static_cast<std::size_t>(width_));
+            return;
+        }
+
+        StageTimer timer(Stage::Quantize);
+
+        std::uint16_t* samples = reinterpret_cast<std::uint16_t*>(static_cast<char*>(base_) + payloadOffset_);
+        for (int y = 0; y < height_; ++y) {
+            const float* src = source.row(y);
+            std::uint16_t* dst = samples + static_cast<std::size_t>(y) * stride_;
+            for (int x = 0; x < width_; ++x)
+                dst[x] = static_cast<std::uint16_t>(std::lround(std::clamp(src[x], 0.0f, 1.0f) * 65535.0f));
+        }
+    }
+
+    void MappedMap::flush() {
+        if (!base_ || !writable_) return;
+        StageTimer timer(Stage::Encode);
+#if defined(_WIN32)
+        if (!FlushViewOfFile(base_, length_) || !FlushFileBuffers(static_cast<HANDLE>(file_)))
+            throw std::runtime_error("Failed to flush map file");
+#else
+        if (::msync(base_, length_, MS_SYNC) != 0)
+            throw std::runtime_error("Failed to flush map file");
+#endif
+    }
+
+    // -----------------------------
+    // Convenience wrappers
+    // -----------------------------
+    void save_map_file(const NoiseMap2D& map, const std::filesystem::path& path, const MapInfo& info, SampleFormat format) {
+        if (map.empty()) {
+            throw std::invalid_argument("Cannot save empty noise map.");
+        }
+        StatsScope stats("save_map_file", pixel_count(map.width(), map.height()));
+        MappedMap file = MappedMap::create(path, map.width(), map.height(), format, info);
+        file.store(map);
+        file.flush();
+    }
+
+    NoiseMap2D load_map_file(const std::filesystem::path& path) {
+        return MappedMap::open(path).to_map();
+    }
+
+} // namespace Noise
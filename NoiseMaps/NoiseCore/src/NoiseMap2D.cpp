@@ -0,0 +1,129 @@
+// NoiseMap2D.cpp
+#include "NoiseMap2D.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Noise {
+
+    namespace {
+        std::size_t padded_stride(int width) {
+            const std::size_t a = NoiseMap2D::RowAlignment;
+            return (static_cast<std::size_t>(width) + a - 1) / a * a;
+        }
+    }
+
+    NoiseMap2D::NoiseMap2D(int width, int height) {
+        if (width < 0 || height < 0)
+            throw std::invalid_argument("map dimensions must be >= 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        if (width == 0 || height == 0) return;
+
+        width_ = width;
+        height_ = height;
+        stride_ = padded_stride(width);
+        buffer_ = AlignedBuffer(stride_ * static_cast<std::size_t>(height));
+        data_ = buffer_.get();
+    }
+
+    NoiseMap2D::NoiseMap2D(const NoiseMap2D& other) : NoiseMap2D(other.width_, other.height_) {
+        if (empty()) return;
+        if (stride_ == other.stride_) {
+            std::memcpy(data_, other.data_, size_bytes());
+            return;
+        }
+        // views may use a different stride
+        for (int y = 0; y < height_; ++y)
+            std::memcpy(row(y), other.row(y), sizeof(float) * static_cast<std::size_t>(width_));
+    }
+
+    NoiseMap2D& NoiseMap2D::operator=(const NoiseMap2D& other) {
+        if (this != &other) {
+            NoiseMap2D copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    NoiseMap2D::NoiseMap2D(NoiseMap2D&& other) noexcept
+        : buffer_(std::move(other.buffer_)),
+          data_(other.data_),
+          width_(other.width_),
+          height_(other.height_),
+          stride_(other.stride_) {
+        other.data_ = nullptr;
+        other.width_ = other.height_ = 0;
+        other.stride_ = 0;
+    }
+
+    NoiseMap2D& NoiseMap2D::operator=(NoiseMap2D&& other) noexcept {
+        if (this != &other) {
+            buffer_ = std::move(other.buffer_);
+            data_ = other.data_;
+            width_ = other.width_;
+            height_ = other.height_;
+            stride_ = other.stride_;
+            other.data_ = nullptr;
+            other.width_ = other.height_ = 0;
+            other.stride_ = 0;
+        }
+        return *this;
+    }
+
+    NoiseMap2D NoiseMap2D::uninitialized(int width, int height) {
+        if (width < 0 || height < 0)
+            throw std::invalid_argument("map dimensions must be >= 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+
+        NoiseMap2D map;
+        if (width == 0 || height == 0) return map;
+        map.width_ = width;
+        map.height_ = height;
+        map.stride_ = padded_stride(width);
+        map.buffer_ = AlignedBuffer(map.stride_ * static_cast<std::size_t>(height), false);
+        map.data_ = map.buffer_.get();
+        return map;
+    }
+
+    NoiseMap2D NoiseMap2D::view(float* data, int width, int height, std::size_t stride) {
+        if (width < 0 || height < 0)
+            throw std::invalid_argument("map dimensions must be >= 0, got: " + std::to_string(width) + "x" + std::to_string(height));
+        if (stride < static_cast<std::size_t>(width))
+            throw std::invalid_argument("stride must be >= width, got: " + std::to_string(stride));
+
+        NoiseMap2D map;
+        if (width == 0 || height == 0) return map;
+        map.data_ = data;
+        map.width_ = width;
+        map.height_ = height;
+        map.stride_ = stride;
+        return map;
+    }
+
+    NoiseMap2D NoiseMap2D::from_rows(const std::vector<std::vector<float>>& rows) {
+        if (rows.empty() || rows[0].empty()) return NoiseMap2D();
+
+        const int height = static_cast<int>(rows.size());
+        const int width = static_cast<int>(rows[0].size());
+        NoiseMap2D map(width, height);
+        for (int y = 0; y < height; ++y) {
+            if (static_cast<int>(rows[y].size()) != width)
+                throw std::invalid_argument("rows must all have the same width, row " + std::to_string(y) + " differs");
+            std::memcpy(map.row(y), rows[y].data(), sizeof(float) * static_cast<std::size_t>(width));
+        }
+        return map;
+    }
+
+    std::vector<std::vector<float>> NoiseMap2D::to_rows() const {
+        std::vector<std::vector<float>> rows(height_);
+        for (int y = 0; y < height_; ++y)
+            rows[y].assign(row(y), row(y) + width_);
+        return rows;
+    }
+
+    void NoiseMap2D::fill(float value) noexcept {
+        for (int y = 0; y < height_; ++y)
+            std::fill(row(y), row(y) + width_, value);
+    }
+
+} // namespace Noise
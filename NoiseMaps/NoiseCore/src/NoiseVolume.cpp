@@ -0,0 +1,91 @@
+// NoiseVolume.cpp
+#include "NoiseVolume.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Noise {
+
+    namespace {
+        void validate(int width, int height, int depth) {
+            if (width < 0 || height < 0 || depth < 0)
+                throw std::invalid_argument("volume dimensions must be >= 0, got: " + std::to_string(width) + "x" +
+                    std::to_string(height) + "x" + std::to_string(depth));
+        }
+
+        std::size_t padded_stride(int width) {
+            const std::size_t a = NoiseMap2D::RowAlignment;
+            return (static_cast<std::size_t>(width) + a - 1) / a * a;
+        }
+    }
+
+    NoiseVolume::NoiseVolume(int width, int height, int depth) {
+        validate(width, height, depth);
+        if (width == 0 || height == 0 || depth == 0) return;
+
+        width_ = width;
+        height_ = height;
+        depth_ = depth;
+        stride_ = padded_stride(width);
+        buffer_ = AlignedBuffer(slice_stride() * static_cast<std::size_t>(depth));
+    }
+
+    NoiseVolume NoiseVolume::uninitialized(int width, int height, int depth) {
+        validate(width, height, depth);
+
+        NoiseVolume volume;
+        if (width == 0 || height == 0 || depth == 0) return volume;
+        volume.width_ = width;
+        volume.height_ = height;
+        volume.depth_ = depth;
+        volume.stride_ = padded_stride(width);
+        volume.buffer_ = AlignedBuffer(volume.slice_stride() * static_cast<std::size_t>(depth), false);
+        return volume;
+    }
+
+    NoiseVolume::NoiseVolume(const NoiseVolume& other) {
+        if (other.empty()) return;
+        *this = uninitialized(other.width_, other.height_, other.depth_);
+        std::memcpy(data(), other.data(), size_bytes());
+    }
+
+    NoiseVolume& NoiseVolume::operator=(const NoiseVolume& other) {
+        if (this != &other) {
+            NoiseVolume copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    NoiseVolume::NoiseVolume(NoiseVolume&& other) noexcept
+        : buffer_(std::move(other.buffer_)),
+          width_(other.width_),
+          height_(other.height_),
+          depth_(other.depth_),
+          stride_(other.stride_) {
+        other.width_ = other.height_ = other.depth_ = 0;
+        other.stride_ = 0;
+    }
+
+    NoiseVolume& NoiseVolume::operator=(NoiseVolume&& other) noexcept {
+        if (this != &other) {
+            buffer_ = std::move(other.buffer_);
+            width_ = other.width_;
+            height_ = other.height_;
+            depth_ = other.depth_;
+            stride_ = other.stride_;
+            other.width_ = other.height_ = other.depth_ = 0;
+            other.stride_ = 0;
+        }
+        return *this;
+    }
+
+    NoiseMap2D NoiseVolume::slice(int z) {
+        if (z < 0 || z >= depth_)
+            throw std::invalid_argument("z must be in [0, " + std::to_string(depth_) + "), got: " + std::to_string(z));
+        return NoiseMap2D::view(row(0, z), width_, height_, stride_);
+    }
+
+} // namespace Noise
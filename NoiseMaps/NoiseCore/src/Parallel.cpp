@@ -0,0 +1,65 @@
+// Parallel.cpp
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+
+namespace Noise {
+
+    unsigned int resolve_thread_count(int requested) {
+        if (requested > 0) return static_cast<unsigned int>(requested);
+        return static_cast<unsigned int>(get_thread_count());
+    }
+
+    namespace {
+        void run_parallel(std::size_t count, const std::function<void(std::size_t)>& task, int threads) {
+            if (count == 1 || threads == 1) {
+                for (std::size_t i = 0; i < count; ++i) task(i);
+                return;
+            }
+
+            // A user executor takes over scheduling entirely
+            if (Executor executor = get_executor()) {
+                executor(count, task);
+                return;
+            }
+
+            ThreadPool::shared()->parallel_for(count, task, threads > 0 ? static_cast<unsigned int>(threads) : 0u);
+        }
+
+        // Work of a reported call stays attributed to it on every thread
+        void run_attributed(std::size_t count, const std::function<void(std::size_t)>& task, int threads) {
+            StatsCall* call = current_stats_call();
+            if (call && count > 1 && threads != 1) {
+                const unsigned int used = get_executor() ? resolve_thread_count(threads)
+                    : std::min(resolve_thread_count(threads), ThreadPool::shared()->size());
+                stats_note_threads(static_cast<unsigned int>(std::min<std::size_t>(used, count)));
+                run_parallel(count, bind_stats_call(call, task), threads);
+                return;
+            }
+            run_parallel(count, task, threads);
+        }
+    }
+
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task, int threads) {
+        if (count == 0) return;
+
+        if (tracing()) {
+            const std::function<void(std::size_t)> traced = [&task](std::size_t i) {
+                TraceSpan span("task", "parallel", static_cast<std::int64_t>(i));
+                task(i);
+            };
+            run_attributed(count, traced, threads);
+            return;
+        }
+        run_attributed(count, task, threads);
+    }
+
+    int rows_per_band(int width, std::size_t targetBytes) {
+        std::size_t rowBytes = static_cast<std::size_t>(std::max(width, 1)) * sizeof(float);
+        return static_cast<int>(std::max<std::size_t>(1, targetBytes / rowBytes));
+    }
+
+} // namespace Noise
@@ -0,0 +1,61 @@
+// Permutation.cpp
+#include "Permutation.hpp"
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+namespace Noise {
+
+    namespace {
+
+        std::vector<int> shuffled(std::mt19937& rng) {
+            std::vector<int> p(256);
+            for (int i = 0; i < 256; ++i)
+                p[i] = i;
+            std::shuffle(p.begin(), p.end(), rng);
+
+            // duplicate for overflow safety
+            p.insert(p.end(), p.begin(), p.end());
+            return p;
+        }
+
+        // Most recently built tables, oldest dropped first
+        constexpr std::size_t kMemoSeeds = 64;
+        std::mutex memoMutex;
+        std::unordered_map<int, std::vector<int>> memo;
+        std::deque<int> memoOrder;
+    }
+
+    std::vector<int> permutation_table(int seed) {
+        StageTimer timer(Stage::Setup);
+        if (seed < 0) {
+            std::random_device rd;
+            std::mt19937 rng(rd());
+            return shuffled(rng);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(memoMutex);
+            auto it = memo.find(seed);
+            if (it != memo.end()) return it->second;
+        }
+
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+        std::vector<int> table = shuffled(rng);
+
+        std::lock_guard<std::mutex> lock(memoMutex);
+        if (memo.emplace(seed, table).second) {
+            memoOrder.push_back(seed);
+            if (memoOrder.size() > kMemoSeeds) {
+                memo.erase(memoOrder.front());
+                memoOrder.pop_front();
+            }
+        }
+        return table;
+    }
+
+} // namespace Noise
@@ -0,0 +1,110 @@
+// Simd.cpp
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if RELNO_SIMD_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace Noise {
+
+    namespace {
+
+        SimdLevel detect() {
+#if RELNO_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+            int r[4];
+            __cpuid(r, 0);
+            const int maxLeaf = r[0];
+            __cpuid(r, 1);
+            const bool osxsave = (r[2] & (1 << 27)) != 0;
+            const bool avx = (r[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || maxLeaf < 7) return SimdLevel::SSE2;
+
+            // the OS must save YMM (and for AVX-512 also opmask/ZMM) state
+            const unsigned long long xcr0 = _xgetbv(0);
+            if ((xcr0 & 0x6) != 0x6) return SimdLevel::SSE2;
+            __cpuidex(r, 7, 0);
+            if ((r[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6) return SimdLevel::AVX512;
+            if ((r[1] & (1 << 5)) != 0) return SimdLevel::AVX2;
+            return SimdLevel::SSE2;
+#else
+            // also checks that the OS saves the wider registers
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            return SimdLevel::SSE2;
+#endif
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+
+        bool parse(const char* name, SimdLevel& level) {
+            for (SimdLevel l : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+                if (std::strcmp(name, simd_level_name(l)) == 0) {
+                    level = l;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        SimdLevel cap(SimdLevel level) {
+            return std::min(level, detected_simd_level());
+        }
+
+        // -1 until first use, then the active SimdLevel
+        std::atomic<int> gActive{ -1 };
+        std::once_flag gEnvOnce;
+    }
+
+    SimdLevel detected_simd_level() {
+        static const SimdLevel detected = detect();
+        return detected;
+    }
+
+    SimdLevel simd_level() {
+        int active = gActive.load(std::memory_order_relaxed);
+        if (active >= 0) return static_cast<SimdLevel>(active);
+
+        std::call_once(gEnvOnce, [] {
+            SimdLevel level = detected_simd_level();
+            const char* env = std::getenv("RELNO_SIMD");
+            if (env != nullptr) {
+                SimdLevel requested;
+                if (parse(env, requested)) level = cap(requested);
+            }
+            int unset = -1;
+            gActive.compare_exchange_strong(unset, static_cast<int>(level));
+        });
+        return static_cast<SimdLevel>(gActive.load(std::memory_order_relaxed));
+    }
+
+    SimdLevel set_simd_level(SimdLevel level) {
+        const SimdLevel effective = cap(level);
+        gActive.store(static_cast<int>(effective), std::memory_order_relaxed);
+        return effective;
+    }
+
+    void reset_simd_level() {
+        gActive.store(static_cast<int>(detected_simd_level()), std::memory_order_relaxed);
+    }
+
+    const char* simd_level_name(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE2: return "sse2";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        }
+        return "unknown";
+    }
+
+} // namespace Noise
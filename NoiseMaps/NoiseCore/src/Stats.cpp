@@ -0,0 +1,173 @@
+// Stats.cpp
+#include "Stats.hpp"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace Noise {
+
+    // Counters of one reported call; shared by every thread working for it
+    struct StatsCall {
+        const char* function = "";
+        std::uint64_t pixels = 0;
+        std::chrono::steady_clock::time_point start;
+        std::array<std::atomic<std::int64_t>, StageCount> stageNanos{};
+        std::atomic<unsigned int> threads{ 1 };
+        std::atomic<std::uint64_t> bytesAllocated{ 0 };
+        std::atomic<std::uint64_t> bytesWritten{ 0 };
+    };
+
+    namespace {
+        std::atomic<bool> gEnabled{ false };
+        std::mutex gObserverMutex;
+        StatsObserver gObserver;
+
+        thread_local StatsCall* tlsCall = nullptr;
+        thread_local StageTimer* tlsTimer = nullptr;
+        // set inside tasks of a parallel section that already runs in a stage
+        thread_local bool tlsInStage = false;
+    }
+
+    const char* stage_name(Stage stage) {
+        switch (stage) {
+        case Stage::Setup: return "setup";
+        case Stage::Generate: return "generate";
+        case Stage::Normalize: return "normalize";
+        case Stage::Quantize: return "quantize";
+        case Stage::Encode: return "encode";
+        }
+        return "unknown";
+    }
+
+    void set_stats_observer(StatsObserver observer) {
+        std::lock_guard<std::mutex> lock(gObserverMutex);
+        gEnabled.store(static_cast<bool>(observer), std::memory_order_relaxed);
+        gObserver = std::move(observer);
+    }
+
+    StatsObserver get_stats_observer() {
+        std::lock_guard<std::mutex> lock(gObserverMutex);
+        return gObserver;
+    }
+
+    bool stats_enabled() noexcept {
+        return gEnabled.load(std::memory_order_relaxed);
+    }
+
+    // -----------------------------
+    // StatsScope
+    // -----------------------------
+    StatsScope::StatsScope(const char* function, std::uint64_t pixels) : span_(function, "call") {
+        if (!stats_enabled() || tlsCall) return;
+        call_ = std::make_unique<StatsCall>();
+        call_->function = function;
+        call_->pixels = pixels;
+        call_->start = std::chrono::steady_clock::now();
+        uncaught_ = std::uncaught_exceptions();
+        tlsCall = call_.get();
+    }
+
+    StatsScope::~StatsScope() {
+        if (!call_) return;
+        tlsCall = nullptr;
+
+        CallStats stats;
+        stats.function = call_->function;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - call_->start).count();
+        for (std::size_t s = 0; s < StageCount; ++s)
+            stats.stageSeconds[s] = static_cast<double>(call_->stageNanos[s].load()) * 1e-9;
+        stats.pixels = call_->pixels;
+        stats.threads = call_->threads.load();
+        stats.bytesAllocated = call_->bytesAllocated.load();
+        stats.bytesWritten = call_->bytesWritten.load();
+        call_.reset();
+
+        // a failed call has nothing meaningful to report
+        if (std::uncaught_exceptions() > uncaught_) return;
+        if (StatsObserver observer = get_stats_observer()) {
+            try {
+                observer(stats);
+            }
+            catch (...) {
+                // never let an observer turn a finished call into a failure
+            }
+        }
+    }
+
+    // -----------------------------
+    // StageTimer
+    // -----------------------------
+    StageTimer::StageTimer(Stage stage, bool traced)
+        : span_(traced ? stage_name(stage) : nullptr, "stage"), call_(tlsInStage ? nullptr : tlsCall), stage_(stage) {
+        if (!call_) return;
+        start_ = std::chrono::steady_clock::now();
+        parent_ = tlsTimer;
+        if (parent_) parent_->charge(start_);
+        tlsTimer = this;
+    }
+
+    StageTimer::~StageTimer() {
+        if (!call_) return;
+        const auto now = std::chrono::steady_clock::now();
+        charge(now);
+        tlsTimer = parent_;
+        if (parent_) parent_->start_ = now;
+    }
+
+    void StageTimer::charge(std::chrono::steady_clock::time_point now) {
+        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+        call_->stageNanos[static_cast<std::size_t>(stage_)].fetch_add(nanos, std::memory_order_relaxed);
+        start_ = now;
+    }
+
+    // -----------------------------
+    // Counters
+    // -----------------------------
+    StatsCall* current_stats_call() noexcept {
+        return tlsCall;
+    }
+
+    std::function<void(std::size_t)> bind_stats_call(StatsCall* call, const std::function<void(std::size_t)>& task) {
+        // A section started inside a stage is charged to that stage as a whole
+        // (wall time on the spawning thread); the tasks' own timers are ignored.
+        // Outside a stage (stream_image pipelining) each task times its stages.
+        const bool inStage = tlsInStage || tlsTimer;
+        return [call, inStage, &task](std::size_t i) {
+            struct Restore {
+                StatsCall* call = tlsCall;
+                StageTimer* timer = tlsTimer;
+                bool inStage = tlsInStage;
+                ~Restore() {
+                    tlsCall = call;
+                    tlsTimer = timer;
+                    tlsInStage = inStage;
+                }
+            } restore;
+
+            tlsCall = call;
+            tlsInStage = inStage;
+            if (!inStage) tlsTimer = nullptr;
+            task(i);
+        };
+    }
+
+    void stats_add_allocated(std::size_t bytes) noexcept {
+        if (StatsCall* call = tlsCall) call->bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void stats_add_written(std::size_t bytes) noexcept {
+        if (StatsCall* call = tlsCall) call->bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void stats_note_threads(unsigned int threads) noexcept {
+        StatsCall* call = tlsCall;
+        if (!call) return;
+        unsigned int seen = call->threads.load(std::memory_order_relaxed);
+        while (threads > seen && !call->threads.compare_exchange_weak(seen, threads, std::memory_order_relaxed)) {
+        }
+    }
+
+} // namespace Noise
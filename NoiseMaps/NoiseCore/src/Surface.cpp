@@ -0,0 +1,85 @@
+// Surface.cpp
+#include "Surface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ImageWriter.hpp"
+#include "Parallel.hpp"
+#include "Stats.hpp"
+
+namespace Noise {
+
+    NormalMap surface_normals(const SurfaceMap& surface, float strength, int threads) {
+        StatsScope stats("surface_normals", pixel_count(surface.height.width(), surface.height.height()));
+        const int width = surface.height.width();
+        const int height = surface.height.height();
+        if (surface.height.empty())
+            throw std::invalid_argument("surface must not be empty");
+        if (surface.dx.width() != width || surface.dx.height() != height ||
+            surface.dy.width() != width || surface.dy.height() != height)
+            throw std::invalid_argument("surface height, dx and dy must have the same size");
+        if (!(strength >= 0.0f))
+            throw std::invalid_argument("strength must be >= 0, got: " + std::to_string(strength));
+
+        StageTimer timer(Stage::Generate);
+        NormalMap normals{ NoiseMap2D::uninitialized(width, height), NoiseMap2D::uninitialized(width, height),
+            NoiseMap2D::uninitialized(width, height) };
+
+        const int bandRows = rows_per_band(width);
+        const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+        parallel_for(bands, [&](std::size_t band) {
+            const int y0 = static_cast<int>(band) * bandRows;
+            const int y1 = std::min(y0 + bandRows, height);
+            for (int y = y0; y < y1; ++y) {
+                const float* dx = surface.dx.row(y);
+                const float* dy = surface.dy.row(y);
+                float* nx = normals.x.row(y);
+                float* ny = normals.y.row(y);
+                float* nz = normals.z.row(y);
+                for (int x = 0; x < width; ++x) {
+                    const float gx = -strength * dx[x];
+                    const float gy = -strength * dy[x];
+                    const float inv = 1.0f / std::sqrt(gx * gx + gy * gy + 1.0f);
+                    nx[x] = gx * inv;
+                    ny[x] = gy * inv;
+                    nz[x] = inv;
+                }
+            }
+        }, threads);
+        return normals;
+    }
+
+    void save_normal_map(const NormalMap& normals, const std::string& filename, const std::string& outputDir, int compressionLevel) {
+        StatsScope stats("save_normal_map", pixel_count(normals.x.width(), normals.x.height()));
+        const int width = normals.x.width();
+        const int height = normals.x.height();
+        if (normals.x.empty())
+            throw std::invalid_argument("Cannot save empty normal map.");
+        if (normals.y.width() != width || normals.y.height() != height ||
+            normals.z.width() != width || normals.z.height() != height)
+            throw std::invalid_argument("normal map components must have the same size");
+
+        ImageOptions options;
+        options.channels = 3;
+        options.compressionLevel = compressionLevel;
+        ImageWriter writer(resolve_image_path(filename, outputDir), width, height, options);
+
+        std::vector<float> rgb(static_cast<std::size_t>(width) * 3);
+        for (int y = 0; y < height; ++y) {
+            const float* nx = normals.x.row(y);
+            const float* ny = normals.y.row(y);
+            const float* nz = normals.z.row(y);
+            for (int x = 0; x < width; ++x) {
+                rgb[3 * static_cast<std::size_t>(x)] = nx[x] * 0.5f + 0.5f;
+                rgb[3 * static_cast<std::size_t>(x) + 1] = ny[x] * 0.5f + 0.5f;
+                rgb[3 * static_cast<std::size_t>(x) + 2] = nz[x] * 0.5f + 0.5f;
+            }
+            writer.write_row(rgb.data());
+        }
+        writer.finish();
+    }
+
+} // namespace Noise
@@ -0,0 +1,194 @@
+// ThreadPool.cpp
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace Noise {
+
+    namespace {
+        // Identifies pool workers so nested submissions land on their own deque
+        thread_local const ThreadPool* tlsPool = nullptr;
+        thread_local std::size_t tlsIndex = 0;
+
+        std::mutex gConfigMutex;
+        std::shared_ptr<ThreadPool> gPool;
+        int gThreadCount = 0; // <= 0: hardware concurrency
+        Executor gExecutor;
+    }
+
+    // One parallel_for call. Queued helpers and the caller pull indices from
+    // `next` until the range is drained; the caller waits for `done == count`.
+    struct ThreadPool::Batch {
+        const std::function<void(std::size_t)>* task = nullptr;
+        std::size_t count = 0;
+        std::atomic<std::size_t> next{ 0 };
+        std::atomic<std::size_t> done{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    ThreadPool::ThreadPool(unsigned int workers) {
+        queues_.reserve(workers);
+        for (unsigned int i = 0; i < workers; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        workers_.reserve(workers);
+        for (unsigned int i = 0; i < workers; ++i)
+            workers_.emplace_back([this, i]() { worker_loop(i); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        sleepCv_.notify_all();
+        for (auto& th : workers_) {
+            // A worker can only drop the last reference through a nested call; never join yourself
+            if (th.get_id() == std::this_thread::get_id()) th.detach();
+            else th.join();
+        }
+    }
+
+    void ThreadPool::run(Batch& batch) {
+        std::size_t i;
+        while ((i = batch.next.fetch_add(1, std::memory_order_relaxed)) < batch.count) {
+            if (!batch.failed.load(std::memory_order_relaxed)) {
+                try {
+                    (*batch.task)(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(batch.mutex);
+                    if (!batch.error) batch.error = std::current_exception();
+                    batch.failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (batch.done.fetch_add(1, std::memory_order_acq_rel) + 1 == batch.count) {
+                std::lock_guard<std::mutex> lock(batch.mutex);
+                batch.cv.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::push(std::shared_ptr<Batch> batch) {
+        std::size_t q = (tlsPool == this) ? tlsIndex
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            // count first so a worker never sees an item it cannot account for
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queued_.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            queues_[q]->items.push_back(std::move(batch));
+        }
+        sleepCv_.notify_one();
+    }
+
+    bool ThreadPool::try_pop(std::size_t self, std::shared_ptr<Batch>& out) {
+        Queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.items.empty()) return false;
+        out = std::move(q.items.back());
+        q.items.pop_back();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ThreadPool::try_steal(std::size_t self, std::shared_ptr<Batch>& out) {
+        const std::size_t n = queues_.size();
+        for (std::size_t k = 1; k < n; ++k) {
+            Queue& q = *queues_[(self + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.items.empty()) continue;
+            out = std::move(q.items.front());
+            q.items.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void ThreadPool::worker_loop(std::size_t index) {
+        tlsPool = this;
+        tlsIndex = index;
+
+        for (;;) {
+            std::shared_ptr<Batch> batch;
+            if (try_pop(index, batch) || try_steal(index, batch)) {
+                run(*batch);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleepCv_.wait(lock, [this]() { return stop_ || queued_.load(std::memory_order_relaxed) > 0; });
+            if (stop_) return;
+        }
+    }
+
+    void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& task, unsigned int maxThreads) {
+        if (count == 0) return;
+
+        unsigned int threads = (maxThreads == 0) ? size() : std::min(maxThreads, size());
+        threads = static_cast<unsigned int>(std::min<std::size_t>(threads, count));
+
+        if (threads <= 1) {
+            for (std::size_t i = 0; i < count; ++i) task(i);
+            return;
+        }
+
+        auto batch = std::make_shared<Batch>();
+        batch->task = &task;
+        batch->count = count;
+
+        for (unsigned int t = 1; t < threads; ++t)
+            push(batch);
+
+        // The caller works too, then waits for helpers still finishing an index.
+        // Helpers that start late find the range drained and only touch `batch`,
+        // which their shared_ptr keeps alive.
+        run(*batch);
+        {
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            batch->cv.wait(lock, [&]() { return batch->done.load(std::memory_order_acquire) == count; });
+        }
+
+        if (batch->error) std::rethrow_exception(batch->error);
+    }
+
+    std::shared_ptr<ThreadPool> ThreadPool::shared() {
+        std::lock_guard<std::mutex> lock(gConfigMutex);
+        if (!gPool) {
+            unsigned int threads = (gThreadCount > 0) ? static_cast<unsigned int>(gThreadCount)
+                : std::max(1u, std::thread::hardware_concurrency());
+            gPool = std::make_shared<ThreadPool>(threads - 1);
+        }
+        return gPool;
+    }
+
+    void set_thread_count(int threads) {
+        std::lock_guard<std::mutex> lock(gConfigMutex);
+        gThreadCount = threads;
+        // Rebuilt lazily on next use; running calls keep the old pool alive
+        gPool.reset();
+    }
+
+    int get_thread_count() {
+        std::lock_guard<std::mutex> lock(gConfigMutex);
+        if (gThreadCount > 0) return gThreadCount;
+        return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    void set_executor(Executor executor) {
+        std::lock_guard<std::mutex> lock(gConfigMutex);
+        gExecutor = std::move(executor);
+    }
+
+    Executor get_executor() {
+        std::lock_guard<std::mutex> lock(gConfigMutex);
+        return gExecutor;
+    }
+
+} // namespace Noise
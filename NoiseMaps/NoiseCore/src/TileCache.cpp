@@ -0,0 +1,177 @@
+// TileCache.cpp
+#include "TileCache.hpp"
+
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace Noise {
+
+    namespace {
+
+        inline void hash_combine(std::size_t& h, std::uint64_t v) noexcept {
+            v *= 0x9e3779b97f4a7c15ULL;
+            v ^= v >> 32;
+            h ^= static_cast<std::size_t>(v) + 0x9e3779b9u + (h << 6) + (h >> 2);
+        }
+    }
+
+    bool TileKey::operator==(const TileKey& other) const noexcept {
+        return type == other.type && tileX == other.tileX && tileY == other.tileY &&
+            tileSize == other.tileSize && seed == other.seed && params == other.params;
+    }
+
+    std::size_t TileKeyHash::operator()(const TileKey& key) const noexcept {
+        std::size_t h = 0;
+        hash_combine(h, static_cast<std::uint64_t>(key.type));
+        hash_combine(h, static_cast<std::uint64_t>(key.tileX));
+        hash_combine(h, static_cast<std::uint64_t>(key.tileY));
+        hash_combine(h, static_cast<std::uint64_t>(key.tileSize));
+        hash_combine(h, static_cast<std::uint64_t>(key.seed));
+        for (double p : key.params) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &p, sizeof(bits));
+            hash_combine(h, bits);
+        }
+        return h;
+    }
+
+    TileKey make_tile_key(NoiseType type, std::int64_t tileX, std::int64_t tileY, int tileSize,
+        int seed, std::vector<double> params) {
+        if (tileSize <= 0)
+            throw std::invalid_argument("tileSize must be > 0, got: " + std::to_string(tileSize));
+        if (seed < 0)
+            throw std::invalid_argument("cached tiles need a fixed seed (>= 0), got: " + std::to_string(seed));
+
+        TileKey key;
+        key.type = type;
+        key.tileX = tileX;
+        key.tileY = tileY;
+        key.tileSize = tileSize;
+        key.seed = seed;
+        key.params = std::move(params);
+        return key;
+    }
+
+    Region tile_region(const TileKey& key) {
+        return Region{ key.tileX * key.tileSize, key.tileY * key.tileSize, key.tileSize, key.tileSize };
+    }
+
+    TileCache::TileCache(std::size_t byteBudget)
+        : budget_(byteBudget) {
+    }
+
+    TileCache::Tile TileCache::get_or_create(const TileKey& key, const Producer& produce) {
+        std::promise<Tile> promise;
+        std::shared_future<Tile> inFlight;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                ++hits_;
+                lru_.splice(lru_.begin(), lru_, it->second);
+                return it->second->tile;
+            }
+
+            auto pending = pending_.find(key);
+            if (pending != pending_.end()) {
+                ++hits_;
+                inFlight = pending->second;
+            }
+            else {
+                ++misses_;
+                pending_.emplace(key, promise.get_future().share());
+            }
+        }
+
+        // another thread is already generating this tile
+        if (inFlight.valid()) return inFlight.get();
+
+        Tile tile;
+        try {
+            tile = std::make_shared<const NoiseMap2D>(produce());
+        }
+        catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.erase(key);
+            const std::size_t bytes = tile->size_bytes();
+            if (bytes <= budget_) {
+                lru_.push_front(Entry{ key, tile, bytes });
+                index_[key] = lru_.begin();
+                bytes_ += bytes;
+                evict_locked();
+            }
+        }
+        promise.set_value(tile);
+        return tile;
+    }
+
+    TileCache::Tile TileCache::find(const TileKey& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->tile;
+    }
+
+    void TileCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.clear();
+        lru_.clear();
+        bytes_ = 0;
+    }
+
+    void TileCache::set_byte_budget(std::size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = bytes;
+        evict_locked();
+    }
+
+    std::size_t TileCache::byte_budget() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return budget_;
+    }
+
+    TileCacheStats TileCache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TileCacheStats s;
+        s.hits = hits_;
+        s.misses = misses_;
+        s.evictions = evictions_;
+        s.entries = lru_.size();
+        s.bytes = bytes_;
+        return s;
+    }
+
+    void TileCache::reset_stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hits_ = misses_ = evictions_ = 0;
+    }
+
+    // Drops least recently used tiles until the budget holds
+    void TileCache::evict_locked() {
+        while (bytes_ > budget_ && !lru_.empty()) {
+            const Entry& victim = lru_.back();
+            bytes_ -= victim.bytes;
+            index_.erase(victim.key);
+            lru_.pop_back();
+            ++evictions_;
+        }
+    }
+
+} // namespace Noise
@@ -0,0 +1,173 @@
+// Trace.cpp
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Noise {
+
+    namespace {
+        struct TraceEvent {
+            const char* name;
+            const char* category;
+            std::int64_t begin;     // steady clock, ns
+            std::int64_t end;
+            std::int64_t arg;
+        };
+
+        std::int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    // Spans of one thread. Only the owner writes `events` and publishes them
+    // through `count`; the exporter reads after stop_trace().
+    struct TraceBuffer {
+        int thread = 0;
+        std::uint64_t session = 0;
+        std::vector<TraceEvent> events;
+        std::atomic<std::size_t> count{ 0 };
+        std::atomic<std::size_t> dropped{ 0 };
+    };
+
+    namespace {
+        std::atomic<bool> gTracing{ false };
+        std::atomic<std::uint64_t> gSession{ 0 };
+
+        std::mutex gRegistryMutex;
+        // Kept for the life of the process: threads hold on to their buffer
+        std::vector<std::unique_ptr<TraceBuffer>> gBuffers;
+        std::size_t gCapacity = 0;
+        std::int64_t gOrigin = 0;
+
+        thread_local TraceBuffer* tlsBuffer = nullptr;
+
+        // The calling thread's buffer, registered and emptied on the first span
+        // of a session
+        TraceBuffer* thread_buffer() {
+            const std::uint64_t session = gSession.load(std::memory_order_acquire);
+            TraceBuffer* buffer = tlsBuffer;
+            if (buffer && buffer->session == session) return buffer;
+
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            if (!buffer) {
+                gBuffers.push_back(std::make_unique<TraceBuffer>());
+                buffer = gBuffers.back().get();
+                buffer->thread = static_cast<int>(gBuffers.size());
+                tlsBuffer = buffer;
+            }
+            if (buffer->events.size() != gCapacity) buffer->events.resize(gCapacity);
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->dropped.store(0, std::memory_order_relaxed);
+            buffer->session = session;
+            return buffer;
+        }
+
+        template <class F>
+        void for_each_session_buffer(F&& f) {
+            const std::uint64_t session = gSession.load(std::memory_order_acquire);
+            for (const auto& buffer : gBuffers)
+                if (buffer->session == session) f(*buffer);
+        }
+    }
+
+    void start_trace(std::size_t eventsPerThread) {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        gCapacity = std::max<std::size_t>(eventsPerThread, 1);
+        gOrigin = now_ns();
+        gSession.fetch_add(1, std::memory_order_release);
+        gTracing.store(true, std::memory_order_release);
+    }
+
+    void stop_trace() {
+        gTracing.store(false, std::memory_order_release);
+    }
+
+    bool tracing() noexcept {
+        return gTracing.load(std::memory_order_relaxed);
+    }
+
+    std::size_t trace_event_count() {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        std::size_t total = 0;
+        for_each_session_buffer([&](const TraceBuffer& b) { total += b.count.load(std::memory_order_acquire); });
+        return total;
+    }
+
+    std::size_t trace_dropped_count() {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        std::size_t total = 0;
+        for_each_session_buffer([&](const TraceBuffer& b) { total += b.dropped.load(std::memory_order_relaxed); });
+        return total;
+    }
+
+    void write_trace(const std::filesystem::path& path) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) throw std::runtime_error("Failed to write trace file: " + path.string());
+
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        std::size_t dropped = 0;
+        bool first = true;
+        auto separator = [&]() -> std::ofstream& {
+            file << (first ? "\n" : ",\n");
+            first = false;
+            return file;
+        };
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        separator() << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"RelNo_D1\"}}";
+        for_each_session_buffer([&](const TraceBuffer& b) {
+            dropped += b.dropped.load(std::memory_order_relaxed);
+            separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << b.thread
+                << ", \"args\": {\"name\": \"thread " << b.thread << "\"}}";
+
+            const std::size_t count = b.count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) {
+                const TraceEvent& e = b.events[i];
+                separator() << "{\"name\": \"" << e.name << "\", \"cat\": \"" << e.category
+                    << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << b.thread
+                    << ", \"ts\": " << static_cast<double>(e.begin - gOrigin) * 1e-3
+                    << ", \"dur\": " << static_cast<double>(e.end - e.begin) * 1e-3;
+                if (e.arg >= 0) file << ", \"args\": {\"index\": " << e.arg << "}";
+                file << "}";
+            }
+        });
+        file << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+
+        file.close();
+        if (!file) throw std::runtime_error("Failed to write trace file: " + path.string());
+    }
+
+    // -----------------------------
+    // TraceSpan
+    // -----------------------------
+    TraceSpan::TraceSpan(const char* name, const char* category, std::int64_t arg)
+        : name_(name), category_(category), arg_(arg) {
+        if (!name || !tracing()) return;
+        buffer_ = thread_buffer();
+        begin_ = now_ns();
+    }
+
+    TraceSpan::~TraceSpan() {
+        if (!buffer_) return;
+        const std::int64_t end = now_ns();
+        const std::size_t index = buffer_->count.load(std::memory_order_relaxed);
+        if (index >= buffer_->events.size()) {
+            buffer_->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer_->events[index] = TraceEvent{ name_, category_, begin_, end, arg_ };
+        buffer_->count.store(index + 1, std::memory_order_release);
+    }
+
+} // namespace Noise
@@ -0,0 +1,145 @@
+// NoiseGraph.hpp
+// ----------------
+// Node graph for composing noise: sources, fractal sums, domain warps and
+// per-pixel arithmetic, evaluated in one fused pass.
+//
+// Nodes are added to a graph and refer to earlier nodes, so every graph is a
+// DAG. generate() compiles the part of the graph reachable from the output
+// node into a plan of row-major steps over TileSize x TileSize tiles. Each
+// intermediate lives in a tile-sized scratch slot that is reused once its
+// last reader has run, and tiles are evaluated in parallel on the worker pool.
+// No intermediate map is allocated.
+//
+// Values are in [0,1] throughout (sources are remapped where needed).
+// Coordinates are in world pixels: pixel (x, y) of generate_region(node,
+// region) is evaluated at (region.x + x + offsetX, region.y + y + offsetY),
+// and fractal nodes divide by their scale the way generate_*_map does:
+//   fbm(perlin(s), scale, ...)    == generate_perlin_map(..., scale, ..., base, s) bit for bit
+//   fbm(simplex(s), scale, ...)   == generate_simplex_map(...) bit for bit
+//   white(s)                      == WhiteNoise::generate_region(region, s)
+//   pink(...)                     == generate_pink_region(region, ...)
+// for whole-pixel offsets (base / offsetX / offsetY as in Region{0, 0, w, h, base, base}).
+//
+// Usage:
+//   Noise::NoiseGraph g;
+//   auto hills    = g.fbm(g.perlin(42), 120.0f, 6, 1.0f, 0.5f, 2.0f);
+//   auto peaks    = g.ridged(g.simplex(7), 60.0f, 5, 1.0f, 0.5f, 2.0f);
+//   auto mask     = g.remap(g.fbm(g.simplex(9), 400.0f, 3), 0.4f, 0.6f, 0.0f, 1.0f);
+//   auto terrain  = g.select(g.clamp(mask, 0.0f, 1.0f), hills, peaks, 0.5f, 0.1f);
+//   auto warped   = g.warp(terrain, g.fbm(g.perlin(1), 80.0f, 3), g.fbm(g.perlin(2), 80.0f, 3), 25.0f);
+//   Noise::NoiseMap2D map = g.generate(warped, 2048, 2048);
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "NoiseMap2D.hpp"
+#include "Region.hpp"
+
+namespace Noise {
+
+    class PerlinNoise;
+    class SimplexNoise;
+
+    class NoiseGraph {
+    public:
+        // Handle to a node; only valid for the graph that created it
+        struct Node {
+            int id = -1;
+        };
+
+        // Edge of the square tiles the plan is evaluated on
+        static constexpr int TileSize = 64;
+
+        NoiseGraph();
+        ~NoiseGraph();
+        NoiseGraph(const NoiseGraph& other);
+        NoiseGraph& operator=(const NoiseGraph& other);
+        NoiseGraph(NoiseGraph&& other) noexcept;
+        NoiseGraph& operator=(NoiseGraph&& other) noexcept;
+
+        // ---------------------------------------------------------
+        // Sources (seed -1 = random, drawn once when the node is added).
+        // They see raw pixel coordinates; put them under a fractal node to give
+        // them a feature size (Perlin is 0.5 at every whole pixel).
+        // ---------------------------------------------------------
+
+        // PerlinNoise::noise at the coordinates, [0,1]
+        Node perlin(int seed = -1);
+        // SimplexNoise::noise2D at the coordinates, remapped to [0,1]
+        Node simplex(int seed = -1);
+        // Hashed white noise of the pixel holding the coordinates (see CoordHash.hpp)
+        Node white(int seed = -1);
+        // Pink noise world of generate_pink_region, sampled at the pixel holding the
+        // coordinates. A tile averages each distinct block its samples fall in once
+        // per octave, so a tile costs O(K * B^2) per octave for K distinct blocks of
+        // size B: about O((TileSize + B)^2) at raw pixel coordinates, and at most
+        // O(TileSize^2 * B^2) once fractal or warp nodes spread the coordinates so
+        // every sample lands in its own block. The spread itself costs nothing;
+        // the block size of the top octave does, so keep octaves moderate.
+        Node pink(int octaves = 6, float alpha = 1.0f, int sampleRate = 44100, float amplitude = 1.0f, int seed = -1);
+        Node constant(float value);
+
+        // ---------------------------------------------------------
+        // Fractal sums: octave o evaluates `source` at coordinates / scale * frequency * lacunarity^o
+        // with amplitude persistence^o; the sum is divided by the total amplitude.
+        // ---------------------------------------------------------
+
+        // Plain fBm of the source. Over a perlin() / simplex() source this runs the
+        // fused octave kernels of the map generators.
+        Node fbm(Node source, float scale, int octaves, float frequency = 1.0f,
+            float persistence = 0.5f, float lacunarity = 2.0f);
+        // Sum of (1 - |2v - 1|)^2: sharp crests where the source crosses 0.5
+        Node ridged(Node source, float scale, int octaves, float frequency = 1.0f,
+            float persistence = 0.5f, float lacunarity = 2.0f);
+        // Sum of |2v - 1|: rounded hills with creases at the source's 0.5 level
+        Node billow(Node source, float scale, int octaves, float frequency = 1.0f,
+            float persistence = 0.5f, float lacunarity = 2.0f);
+
+        // ---------------------------------------------------------
+        // Domain warp: `source` evaluated at
+        // (x + (warpX - 0.5) * 2 * strength, y + (warpY - 0.5) * 2 * strength),
+        // strength in pixels. warpX / warpY are evaluated at the unwarped coordinates.
+        // ---------------------------------------------------------
+        Node warp(Node source, Node warpX, Node warpY, float strength);
+
+        // ---------------------------------------------------------
+        // Per-pixel operations
+        // ---------------------------------------------------------
+        Node add(Node a, Node b);
+        Node mul(Node a, Node b);
+        Node clamp(Node a, float lo, float hi);
+        // Linear map of [fromLo, fromHi] onto [toLo, toHi] (not clamped)
+        Node remap(Node a, float fromLo, float fromHi, float toLo, float toHi);
+        // `a` where mask < threshold, `b` above it; with falloff > 0 the two are
+        // blended with a smoothstep over [threshold - falloff, threshold + falloff]
+        Node select(Node mask, Node a, Node b, float threshold = 0.5f, float falloff = 0.0f);
+
+        // ---------------------------------------------------------
+        // Evaluation
+        // ---------------------------------------------------------
+
+        // Same as generate_region(output, Region{0, 0, width, height})
+        NoiseMap2D generate(Node output, int width, int height, int threads = 0) const;
+        // Region of the unbounded world; adjacent regions join seamlessly
+        NoiseMap2D generate_region(Node output, const Region& region, int threads = 0) const;
+
+        // Number of nodes added so far
+        std::size_t size() const noexcept;
+
+    private:
+        enum class Op;
+        struct NodeData;
+        struct Program;
+        struct Plan;
+
+        std::vector<NodeData> nodes_;
+
+        Node add_node(NodeData node);
+        const NodeData& node(Node n) const;
+        Node fractal(Op op, Node source, float scale, int octaves, float frequency, float persistence, float lacunarity);
+        Plan compile(Node output) const;
+        int compile_program(Plan& plan, int root, bool grid) const;
+        const float* run(const Plan& plan, int program, float* arena, int width, int height) const;
+    };
+
+} // namespace Noise
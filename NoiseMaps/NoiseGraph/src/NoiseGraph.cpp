@@ -0,0 +1,723 @@
+#include "Noise.hpp"
+#include "NoiseGraph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AlignedBuffer.hpp"
+#include "CoordHash.hpp"
+#include "Fbm.hpp"
+#include "Parallel.hpp"
+#include "Stats.hpp"
+
+namespace Noise {
+
+    // ---------------------------------------------------------
+    // Node storage
+    // ---------------------------------------------------------
+    enum class NoiseGraph::Op {
+        // sources
+        Perlin, Simplex, White, Pink, Constant,
+        // fractal sums (input 0 is evaluated at scaled coordinates)
+        Fbm, Ridged, Billow,
+        // input 0 at warped coordinates, inputs 1 / 2 at the incoming ones
+        Warp,
+        // per pixel
+        Add, Mul, Clamp, Remap, Select
+    };
+
+    struct NoiseGraph::NodeData {
+        Op op = Op::Constant;
+        int inputs[3] = { -1, -1, -1 };
+        float params[4] = {};       // constant / clamp / remap / select / warp values, fractal scale, pink 1 / total weight and amplitude
+        // sources
+        std::shared_ptr<const PerlinNoise> perlin;
+        std::shared_ptr<const SimplexNoise> simplex;
+        std::uint32_t key = 0;      // white hash key, pink seed
+        int octaves = 0;            // pink and fractal octaves
+        std::vector<int> blockSizes;        // pink octave schedule (see pink_block_size)
+        std::vector<float> weights;
+        // fractal schedule (see Fbm.hpp)
+        std::vector<float> amplitudes;
+        std::vector<float> freqs;
+        float maxAmp = 0.0f;
+    };
+
+    // One compiled coordinate context: the nodes evaluated at the same coordinates,
+    // in dependency order. Fractal and warp steps own child programs for their
+    // source, which they run at transformed coordinates.
+    struct NoiseGraph::Program {
+        struct Step {
+            Op op = Op::Constant;
+            int node = -1;
+            int out = -1;                       // result slot
+            int in[3] = { -1, -1, -1 };         // input slots (same coordinates)
+            int child = -1;                     // program of the source at transformed coordinates
+            std::size_t aux = 0;                // arena offset of step-private scratch
+        };
+
+        std::vector<Step> steps;
+        bool grid = true;           // each tile row shares one y (unwarped coordinates)
+        int slots = 0;
+        int result = -1;
+        std::size_t coords = 0;     // arena offset: x coordinates, then y coordinates
+        std::size_t slotBase = 0;   // arena offset of slot 0
+    };
+
+    struct NoiseGraph::Plan {
+        std::vector<Program> programs;  // programs[0] runs at the tile's pixel coordinates
+        std::size_t arenaFloats = 0;    // scratch per worker
+    };
+
+    namespace {
+
+        constexpr std::size_t TileFloats = static_cast<std::size_t>(NoiseGraph::TileSize) * NoiseGraph::TileSize;
+
+        std::uint32_t draw_seed(int seed) {
+            return static_cast<std::uint32_t>(seed >= 0 ? seed : std::random_device{}());
+        }
+
+        std::int64_t pixel_of(float c) {
+            return static_cast<std::int64_t>(std::floor(c));
+        }
+
+        // floor(a / b) for b > 0, also for negative a
+        std::int64_t floor_div(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && a < 0) ? q - 1 : q;
+        }
+
+        // World block of one pink octave
+        struct BlockKey {
+            std::int64_t x, y;
+            bool operator==(const BlockKey& other) const { return x == other.x && y == other.y; }
+        };
+
+        struct BlockKeyHash {
+            std::size_t operator()(const BlockKey& k) const noexcept {
+                return std::hash<std::uint64_t>{}(static_cast<std::uint64_t>(k.x) * 0x9E3779B97F4A7C15ULL
+                    ^ static_cast<std::uint64_t>(k.y));
+            }
+        };
+
+    } // namespace
+
+    NoiseGraph::NoiseGraph() = default;
+    NoiseGraph::~NoiseGraph() = default;
+    NoiseGraph::NoiseGraph(const NoiseGraph& other) = default;
+    NoiseGraph& NoiseGraph::operator=(const NoiseGraph& other) = default;
+    NoiseGraph::NoiseGraph(NoiseGraph&& other) noexcept = default;
+    NoiseGraph& NoiseGraph::operator=(NoiseGraph&& other) noexcept = default;
+
+    std::size_t NoiseGraph::size() const noexcept {
+        return nodes_.size();
+    }
+
+    NoiseGraph::Node NoiseGraph::add_node(NodeData data) {
+        for (int input : data.inputs)
+            if (input >= static_cast<int>(nodes_.size()))
+                throw std::invalid_argument("node input does not belong to this graph");
+        nodes_.push_back(std::move(data));
+        return Node{ static_cast<int>(nodes_.size()) - 1 };
+    }
+
+    const NoiseGraph::NodeData& NoiseGraph::node(Node n) const {
+        if (n.id < 0 || n.id >= static_cast<int>(nodes_.size()))
+            throw std::invalid_argument("node does not belong to this graph, id: " + std::to_string(n.id));
+        return nodes_[static_cast<std::size_t>(n.id)];
+    }
+
+    // ---------------------------------------------------------
+    // Sources
+    // ---------------------------------------------------------
+    NoiseGraph::Node NoiseGraph::perlin(int seed) {
+        NodeData data;
+        data.op = Op::Perlin;
+        data.perlin = std::make_shared<const PerlinNoise>(seed);
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::simplex(int seed) {
+        NodeData data;
+        data.op = Op::Simplex;
+        data.simplex = std::make_shared<const SimplexNoise>(seed);
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::white(int seed) {
+        NodeData data;
+        data.op = Op::White;
+        data.key = draw_seed(seed);
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::pink(int octaves, float alpha, int sampleRate, float amplitude, int seed) {
+        if (octaves < 1)
+            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
+        NodeData data;
+        data.op = Op::Pink;
+        data.octaves = octaves;
+        // generate_pink_region's argument fixes and octave schedule
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+        if (sampleRate < 1) sampleRate = 44100;
+        double totalWeight = 0.0;
+        for (int o = 0; o < octaves; ++o) {
+            const int blockSize = pink_block_size(o, sampleRate);
+            const float weight = 1.0f / std::pow(static_cast<float>(blockSize), alpha);
+            data.blockSizes.push_back(blockSize);
+            data.weights.push_back(weight);
+            totalWeight += weight;
+        }
+        data.params[0] = static_cast<float>(1.0 / totalWeight);
+        data.params[1] = amplitude;
+        // same world as generate_pink_region, which takes a non-negative int seed
+        data.key = draw_seed(seed) & 0x7fffffffU;
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::constant(float value) {
+        NodeData data;
+        data.op = Op::Constant;
+        data.params[0] = value;
+        return add_node(std::move(data));
+    }
+
+    // ---------------------------------------------------------
+    // Fractal sums and warp
+    // ---------------------------------------------------------
+    NoiseGraph::Node NoiseGraph::fractal(Op op, Node source, float scale, int octaves,
+        float frequency, float persistence, float lacunarity) {
+        node(source);
+        if (!(scale > 0.0f))
+            throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
+        if (octaves < 1)
+            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
+        if (!(frequency > 0.0f))
+            throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(frequency));
+        if (!(persistence >= 0.0f))
+            throw std::invalid_argument("persistence must be >= 0, got: " + std::to_string(persistence));
+        if (!(lacunarity > 0.0f))
+            throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+
+        NodeData data;
+        data.op = op;
+        data.inputs[0] = source.id;
+        data.params[0] = scale;
+        data.octaves = octaves;
+        data.amplitudes.resize(octaves);
+        data.freqs.resize(octaves);
+        fbm_schedule(octaves, frequency, persistence, lacunarity, data.amplitudes.data(), data.freqs.data(), data.maxAmp);
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::fbm(Node source, float scale, int octaves, float frequency, float persistence, float lacunarity) {
+        return fractal(Op::Fbm, source, scale, octaves, frequency, persistence, lacunarity);
+    }
+
+    NoiseGraph::Node NoiseGraph::ridged(Node source, float scale, int octaves, float frequency, float persistence, float lacunarity) {
+        return fractal(Op::Ridged, source, scale, octaves, frequency, persistence, lacunarity);
+    }
+
+    NoiseGraph::Node NoiseGraph::billow(Node source, float scale, int octaves, float frequency, float persistence, float lacunarity) {
+        return fractal(Op::Billow, source, scale, octaves, frequency, persistence, lacunarity);
+    }
+
+    NoiseGraph::Node NoiseGraph::warp(Node source, Node warpX, Node warpY, float strength) {
+        node(source); node(warpX); node(warpY);
+        NodeData data;
+        data.op = Op::Warp;
+        data.inputs[0] = source.id;
+        data.inputs[1] = warpX.id;
+        data.inputs[2] = warpY.id;
+        data.params[0] = strength;
+        return add_node(std::move(data));
+    }
+
+    // ---------------------------------------------------------
+    // Per-pixel operations
+    // ---------------------------------------------------------
+    NoiseGraph::Node NoiseGraph::add(Node a, Node b) {
+        node(a); node(b);
+        NodeData data;
+        data.op = Op::Add;
+        data.inputs[0] = a.id;
+        data.inputs[1] = b.id;
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::mul(Node a, Node b) {
+        node(a); node(b);
+        NodeData data;
+        data.op = Op::Mul;
+        data.inputs[0] = a.id;
+        data.inputs[1] = b.id;
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::clamp(Node a, float lo, float hi) {
+        node(a);
+        if (lo > hi)
+            throw std::invalid_argument("clamp range is empty: [" + std::to_string(lo) + ", " + std::to_string(hi) + "]");
+        NodeData data;
+        data.op = Op::Clamp;
+        data.inputs[0] = a.id;
+        data.params[0] = lo;
+        data.params[1] = hi;
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::remap(Node a, float fromLo, float fromHi, float toLo, float toHi) {
+        node(a);
+        if (fromLo == fromHi)
+            throw std::invalid_argument("remap source range is empty: " + std::to_string(fromLo));
+        NodeData data;
+        data.op = Op::Remap;
+        data.inputs[0] = a.id;
+        data.params[0] = fromLo;
+        data.params[1] = fromHi;
+        data.params[2] = toLo;
+        data.params[3] = toHi;
+        return add_node(std::move(data));
+    }
+
+    NoiseGraph::Node NoiseGraph::select(Node mask, Node a, Node b, float threshold, float falloff) {
+        node(mask); node(a); node(b);
+        NodeData data;
+        data.op = Op::Select;
+        data.inputs[0] = mask.id;
+        data.inputs[1] = a.id;
+        data.inputs[2] = b.id;
+        data.params[0] = threshold;
+        data.params[1] = std::max(falloff, 0.0f);
+        return add_node(std::move(data));
+    }
+
+    // ---------------------------------------------------------
+    // Compilation
+    // ---------------------------------------------------------
+    NoiseGraph::Plan NoiseGraph::compile(Node output) const {
+        node(output);
+        Plan plan;
+        compile_program(plan, output.id, true);
+
+        // Arena: every program's coordinates and slots, then step scratch. Child
+        // programs run while their parent's slots are live, so nothing is shared.
+        std::size_t offset = 0;
+        for (Program& program : plan.programs) {
+            program.coords = offset;
+            offset += 2 * TileFloats;
+            program.slotBase = offset;
+            offset += static_cast<std::size_t>(program.slots) * TileFloats;
+            for (Program::Step& step : program.steps) {
+                const NodeData& data = nodes_[static_cast<std::size_t>(step.node)];
+                if (step.op != Op::Fbm || step.child >= 0) continue;
+                // fused fBm over a Perlin / Simplex source
+                step.aux = offset;
+                const std::size_t octaves = static_cast<std::size_t>(data.octaves);
+                offset += program.grid ? octaves * (NoiseGraph::TileSize + 1) : 2 * octaves * TileFloats;
+            }
+        }
+        plan.arenaFloats = offset;
+        return plan;
+    }
+
+    int NoiseGraph::compile_program(Plan& plan, int root, bool grid) const {
+        const int index = static_cast<int>(plan.programs.size());
+        plan.programs.emplace_back();   // reserve the index; children are appended after it
+
+        // Inputs evaluated at this program's coordinates
+        auto sameInputs = [&](const NodeData& data, int* inputs) {
+            int count = 0;
+            switch (data.op) {
+            case Op::Add: case Op::Mul: case Op::Clamp: case Op::Remap: case Op::Select:
+                for (int input : data.inputs)
+                    if (input >= 0) inputs[count++] = input;
+                break;
+            case Op::Warp:
+                inputs[count++] = data.inputs[1];
+                inputs[count++] = data.inputs[2];
+                break;
+            default:
+                break;
+            }
+            return count;
+        };
+
+        // Dependency order of the nodes in this context (each shared node once),
+        // and the number of readers per node so a slot is released after its last one
+        std::vector<int> order;
+        std::unordered_map<int, bool> visited;
+        std::function<void(int)> visit = [&](int n) {
+            if (visited[n]) return;
+            visited[n] = true;
+            int inputs[3];
+            const int count = sameInputs(nodes_[static_cast<std::size_t>(n)], inputs);
+            for (int k = 0; k < count; ++k) visit(inputs[k]);
+            order.push_back(n);
+        };
+        visit(root);
+
+        std::unordered_map<int, int> readers;
+        readers[root] = 1;  // the program result is never released
+        for (int n : order) {
+            int inputs[3];
+            const int count = sameInputs(nodes_[static_cast<std::size_t>(n)], inputs);
+            for (int k = 0; k < count; ++k) ++readers[inputs[k]];
+        }
+
+        Program program;
+        program.grid = grid;
+        std::unordered_map<int, int> slotOf;
+        std::vector<int> freeSlots;
+        auto allocate = [&]() {
+            if (!freeSlots.empty()) {
+                const int slot = freeSlots.back();
+                freeSlots.pop_back();
+                return slot;
+            }
+            return program.slots++;
+        };
+
+        for (int n : order) {
+            const NodeData& data = nodes_[static_cast<std::size_t>(n)];
+            Program::Step step;
+            step.op = data.op;
+            step.node = n;
+            int inputs[3];
+            const int count = sameInputs(data, inputs);
+            for (int k = 0; k < count; ++k)
+                step.in[k] = slotOf.at(inputs[k]);
+            step.out = allocate();
+
+            if (data.op == Op::Fbm || data.op == Op::Ridged || data.op == Op::Billow) {
+                const Op sourceOp = nodes_[static_cast<std::size_t>(data.inputs[0])].op;
+                const bool fused = data.op == Op::Fbm && (sourceOp == Op::Perlin || sourceOp == Op::Simplex);
+                // scaling keeps rows at a shared y
+                if (!fused) step.child = compile_program(plan, data.inputs[0], grid);
+            }
+            else if (data.op == Op::Warp) {
+                step.child = compile_program(plan, data.inputs[0], false);
+            }
+
+            for (int k = 0; k < count; ++k)
+                if (--readers[inputs[k]] == 0) freeSlots.push_back(step.in[k]);
+            slotOf[n] = step.out;
+            program.steps.push_back(step);
+        }
+
+        program.result = slotOf.at(root);
+        plan.programs[static_cast<std::size_t>(index)] = std::move(program);
+        return index;
+    }
+
+    // ---------------------------------------------------------
+    // Evaluation of one tile (width x height pixels, rows packed)
+    // ---------------------------------------------------------
+    const float* NoiseGraph::run(const Plan& plan, int programIndex, float* arena, int width, int height) const {
+        const Program& program = plan.programs[static_cast<std::size_t>(programIndex)];
+        const std::size_t n = static_cast<std::size_t>(width) * height;
+        const float* cx = arena + program.coords;
+        const float* cy = cx + TileFloats;
+        auto slot = [&](int s) { return arena + program.slotBase + static_cast<std::size_t>(s) * TileFloats; };
+
+        for (const Program::Step& step : program.steps) {
+            const NodeData& data = nodes_[static_cast<std::size_t>(step.node)];
+            float* out = slot(step.out);
+
+            switch (step.op) {
+            case Op::Perlin:
+                data.perlin->noise(cx, cy, out, n);
+                break;
+
+            case Op::Simplex:
+                data.simplex->noise2D(cx, cy, out, n);
+                for (std::size_t i = 0; i < n; ++i) out[i] = out[i] * 0.5f + 0.5f;
+                break;
+
+            case Op::White:
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = hash_to_unit(hash_coords(data.key, pixel_of(cx[i]), pixel_of(cy[i])));
+                break;
+
+            case Op::Pink: {
+                // generate_pink_region's sums, per sample: each octave adds the weighted
+                // mean of the world block holding the pixel. Every distinct block a tile
+                // touches is averaged once, so the cost depends on the tile and the block
+                // sizes, not on how far apart the coordinates lie.
+                std::fill(out, out + n, 0.0f);
+                std::vector<std::int64_t> pxs(n), pys(n), bxs(n), bys(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    pxs[i] = pixel_of(cx[i]);
+                    pys[i] = pixel_of(cy[i]);
+                }
+                std::vector<float> dense;
+                std::unordered_map<BlockKey, float, BlockKeyHash> sparse;
+                for (int o = 0; o < data.octaves; ++o) {
+                    const int blockSize = data.blockSizes[static_cast<std::size_t>(o)];
+                    const float weight = data.weights[static_cast<std::size_t>(o)];
+                    const std::uint32_t key = data.key + static_cast<std::uint32_t>(o);
+
+                    std::int64_t bx0 = INT64_MAX, bx1 = INT64_MIN, by0 = INT64_MAX, by1 = INT64_MIN;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        bxs[i] = blockSize == 1 ? pxs[i] : floor_div(pxs[i], blockSize);
+                        bys[i] = blockSize == 1 ? pys[i] : floor_div(pys[i], blockSize);
+                        bx0 = std::min(bx0, bxs[i]); bx1 = std::max(bx1, bxs[i]);
+                        by0 = std::min(by0, bys[i]); by1 = std::max(by1, bys[i]);
+                    }
+
+                    // Compact blocks (raw, mildly scaled or lightly warped coordinates):
+                    // every block of their bounding box, whole rows of hashes at a time.
+                    // Spread ones: each block in use, once, through a hash map. The box
+                    // wins while hashing its unused blocks costs less than the map
+                    // lookups, at about 64 hashed pixels per lookup.
+                    const std::uint64_t spanX = static_cast<std::uint64_t>(bx1 - bx0) + 1;
+                    const std::uint64_t spanY = static_cast<std::uint64_t>(by1 - by0) + 1;
+                    const std::uint64_t area = static_cast<std::uint64_t>(blockSize) * blockSize;
+                    const std::uint64_t denseBlocks = n * (area + 64) / area;
+                    if (spanX <= denseBlocks && spanY <= denseBlocks && spanX * spanY <= denseBlocks) {
+                        dense.resize(static_cast<std::size_t>(spanX * spanY));
+                        pink_block_means(key, bx0, by0, static_cast<int>(spanX), static_cast<int>(spanY), blockSize, dense.data());
+                        for (std::size_t i = 0; i < n; ++i) {
+                            const std::size_t b = static_cast<std::size_t>(bys[i] - by0) * spanX
+                                + static_cast<std::size_t>(bxs[i] - bx0);
+                            out[i] += dense[b] * weight;
+                        }
+                    }
+                    else {
+                        sparse.clear();
+                        for (std::size_t i = 0; i < n; ++i) {
+                            const BlockKey block{ bxs[i], bys[i] };
+                            auto it = sparse.find(block);
+                            if (it == sparse.end()) {
+                                float mean;
+                                pink_block_means(key, block.x, block.y, 1, 1, blockSize, &mean);
+                                it = sparse.emplace(block, mean * weight).first;
+                            }
+                            out[i] += it->second;
+                        }
+                    }
+                }
+                const float invWeight = data.params[0];
+                const float amplitude = data.params[1];
+                for (std::size_t i = 0; i < n; ++i)
+                    out[i] = std::min(1.0f, std::max(0.0f, out[i] * invWeight * amplitude));
+                break;
+            }
+
+            case Op::Constant:
+                std::fill(out, out + n, data.params[0]);
+                break;
+
+            case Op::Fbm:
+            case Op::Ridged:
+            case Op::Billow: {
+                const int octaves = data.octaves;
+                const float scale = data.params[0];
+                const float* amplitudes = data.amplitudes.data();
+                const float* freqs = data.freqs.data();
+
+                if (step.child < 0) {
+                    // Fused fBm over a Perlin / Simplex source: the map generators' kernels,
+                    // with coordinates formed the same way ((x + base) / scale * freq)
+                    const NodeData& source = nodes_[static_cast<std::size_t>(data.inputs[0])];
+                    float* aux = arena + step.aux;
+                    if (program.grid) {
+                        float* xs = aux;
+                        float* ys = aux + static_cast<std::size_t>(octaves) * TileSize;
+                        for (int y = 0; y < height; ++y) {
+                            const std::size_t row = static_cast<std::size_t>(y) * width;
+                            for (int o = 0; o < octaves; ++o) {
+                                for (int x = 0; x < width; ++x)
+                                    xs[static_cast<std::size_t>(o) * width + x] = cx[row + x] / scale * freqs[o];
+                                ys[o] = cy[row] / scale * freqs[o];
+                            }
+                            if (source.op == Op::Perlin)
+                                source.perlin->fbm_row(xs, static_cast<std::size_t>(width), ys, amplitudes, octaves, data.maxAmp, out + row, static_cast<std::size_t>(width));
+                            else
+                                source.simplex->fbm_row(xs, static_cast<std::size_t>(width), ys, amplitudes, octaves, data.maxAmp, out + row, static_cast<std::size_t>(width));
+                        }
+                    }
+                    else {
+                        // warped coordinates: the per-lane form of the same kernels
+                        float* xs = aux;
+                        float* ys = aux + static_cast<std::size_t>(octaves) * TileFloats;
+                        for (int o = 0; o < octaves; ++o)
+                            for (std::size_t i = 0; i < n; ++i) {
+                                xs[o * TileFloats + i] = cx[i] / scale * freqs[o];
+                                ys[o * TileFloats + i] = cy[i] / scale * freqs[o];
+                            }
+                        if (source.op == Op::Perlin)
+                            source.perlin->fbm(xs, ys, TileFloats, amplitudes, octaves, data.maxAmp, out, n);
+                        else
+                            source.simplex->fbm(xs, ys, TileFloats, amplitudes, octaves, data.maxAmp, out, n);
+                    }
+                    break;
+                }
+
+                // Any other source: run its program once per octave at scaled coordinates
+                const Program& child = plan.programs[static_cast<std::size_t>(step.child)];
+                float* childX = arena + child.coords;
+                float* childY = childX + TileFloats;
+                std::fill(out, out + n, 0.0f);
+                for (int o = 0; o < octaves; ++o) {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        childX[i] = cx[i] / scale * freqs[o];
+                        childY[i] = cy[i] / scale * freqs[o];
+                    }
+                    const float* v = run(plan, step.child, arena, width, height);
+                    const float amplitude = amplitudes[o];
+                    if (step.op == Op::Fbm) {
+                        for (std::size_t i = 0; i < n; ++i) out[i] += v[i] * amplitude;
+                    }
+                    else if (step.op == Op::Billow) {
+                        for (std::size_t i = 0; i < n; ++i) out[i] += std::fabs(v[i] * 2.0f - 1.0f) * amplitude;
+                    }
+                    else {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            const float ridge = 1.0f - std::fabs(v[i] * 2.0f - 1.0f);
+                            out[i] += ridge * ridge * amplitude;
+                        }
+                    }
+                }
+                for (std::size_t i = 0; i < n; ++i) out[i] /= data.maxAmp;
+                break;
+            }
+
+            case Op::Warp: {
+                const float* wx = slot(step.in[0]);
+                const float* wy = slot(step.in[1]);
+                const float reach = data.params[0] * 2.0f;
+                const Program& child = plan.programs[static_cast<std::size_t>(step.child)];
+                float* childX = arena + child.coords;
+                float* childY = childX + TileFloats;
+                for (std::size_t i = 0; i < n; ++i) {
+                    childX[i] = cx[i] + (wx[i] - 0.5f) * reach;
+                    childY[i] = cy[i] + (wy[i] - 0.5f) * reach;
+                }
+                const float* v = run(plan, step.child, arena, width, height);
+                std::copy(v, v + n, out);
+                break;
+            }
+
+            case Op::Add: {
+                const float* a = slot(step.in[0]);
+                const float* b = slot(step.in[1]);
+                for (std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+                break;
+            }
+
+            case Op::Mul: {
+                const float* a = slot(step.in[0]);
+                const float* b = slot(step.in[1]);
+                for (std::size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+                break;
+            }
+
+            case Op::Clamp: {
+                const float* a = slot(step.in[0]);
+                const float lo = data.params[0], hi = data.params[1];
+                for (std::size_t i = 0; i < n; ++i) out[i] = std::min(hi, std::max(lo, a[i]));
+                break;
+            }
+
+            case Op::Remap: {
+                const float* a = slot(step.in[0]);
+                const float fromLo = data.params[0];
+                const float factor = (data.params[3] - data.params[2]) / (data.params[1] - fromLo);
+                const float toLo = data.params[2];
+                for (std::size_t i = 0; i < n; ++i) out[i] = (a[i] - fromLo) * factor + toLo;
+                break;
+            }
+
+            case Op::Select: {
+                const float* mask = slot(step.in[0]);
+                const float* a = slot(step.in[1]);
+                const float* b = slot(step.in[2]);
+                const float threshold = data.params[0], falloff = data.params[1];
+                if (falloff <= 0.0f) {
+                    for (std::size_t i = 0; i < n; ++i) out[i] = mask[i] < threshold ? a[i] : b[i];
+                }
+                else {
+                    const float lo = threshold - falloff;
+                    const float inv = 1.0f / (2.0f * falloff);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        float t = std::min(1.0f, std::max(0.0f, (mask[i] - lo) * inv));
+                        t = t * t * (3.0f - 2.0f * t);
+                        out[i] = a[i] + (b[i] - a[i]) * t;
+                    }
+                }
+                break;
+            }
+            }
+        }
+        return slot(program.result);
+    }
+
+    NoiseMap2D NoiseGraph::generate(Node output, int width, int height, int threads) const {
+        StatsScope stats("NoiseGraph::generate", pixel_count(width, height));
+        if (width <= 0)
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0)
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        Region region;
+        region.width = width;
+        region.height = height;
+        return generate_region(output, region, threads);
+    }
+
+    NoiseMap2D NoiseGraph::generate_region(Node output, const Region& region, int threads) const {
+        StatsScope stats("NoiseGraph::generate_region", pixel_count(region.width, region.height));
+        if (region.width <= 0)
+            throw std::invalid_argument("region width must be > 0, got: " + std::to_string(region.width));
+        if (region.height <= 0)
+            throw std::invalid_argument("region height must be > 0, got: " + std::to_string(region.height));
+
+        Plan plan;
+        {
+            StageTimer timer(Stage::Setup);
+            plan = compile(output);
+        }
+        StageTimer timer(Stage::Generate);
+        NoiseMap2D map = NoiseMap2D::uninitialized(region.width, region.height);
+
+        // Every pixel depends only on its own coordinates, so tiles run in any order
+        // and the map is identical for every thread count
+        const int tilesX = (region.width + TileSize - 1) / TileSize;
+        const int tilesY = (region.height + TileSize - 1) / TileSize;
+        const float offsetX = static_cast<float>(region.offsetX);
+        const float offsetY = static_cast<float>(region.offsetY);
+
+        parallel_for(static_cast<std::size_t>(tilesX) * tilesY, [&](std::size_t tile) {
+            const int tx = static_cast<int>(tile % tilesX) * TileSize;
+            const int ty = static_cast<int>(tile / tilesX) * TileSize;
+            const int width = std::min(TileSize, region.width - tx);
+            const int height = std::min(TileSize, region.height - ty);
+
+            AlignedBuffer arena(plan.arenaFloats, false);
+            float* cx = arena.get() + plan.programs[0].coords;
+            float* cy = cx + TileFloats;
+            for (int y = 0; y < height; ++y) {
+                const float wy = static_cast<float>(region.y + ty + y) + offsetY;
+                for (int x = 0; x < width; ++x) {
+                    cx[static_cast<std::size_t>(y) * width + x] = static_cast<float>(region.x + tx + x) + offsetX;
+                    cy[static_cast<std::size_t>(y) * width + x] = wy;
+                }
+            }
+
+            const float* result = run(plan, 0, arena.get(), width, height);
+            for (int y = 0; y < height; ++y)
+                std::copy(result + static_cast<std::size_t>(y) * width, result + static_cast<std::size_t>(y + 1) * width,
+                    map.row(ty + y) + tx);
+        }, threads);
+
+        return map;
+    }
+
+} // namespace Noise
@@ -5,10 +5,19 @@
 // Usage:
 //  #include "Noise.hpp"
 //  auto map = Noise::create_perlinnoise(256, 256, 40.0f, 5, 1.0f, 0.5f, 2.0f, 0.0f, 42, "image", "perlin_noise.png");
+//  auto vol = Noise::generate_perlin_volume(128, 128, 64, 40.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, 42);
 
 #pragma once
 #include <vector>
 #include <string>
+#include <cstddef>
+#include "NoiseMap2D.hpp"
+#include "Region.hpp"
+#include "MapFile.hpp"
+#include "TileCache.hpp"
+#include "NoiseVolume.hpp"
+#include "Surface.hpp"
+#include "DomainWarp.hpp"
 
 namespace Noise {
 
@@ -24,27 +33,272 @@ namespace Noise {
         static float fade(float t);
         static float lerp(float a, float b, float t);
         static float grad(int hash, float x, float y);
+        static float fade_deriv(float t);
         // Core 2D Perlin noise function: returns [0,1]
         float noise(float x, float y) const;
+        // Kernel call for fbm<> (Fbm.hpp): same as noise(x, y)
+        float operator()(float x, float y) const { return noise(x, y); }
+
+        // Batched evaluation: out[i] = noise(x[i], y[i]) for i < count.
+        // Runs 16/8 points per step on AVX-512/AVX2 builds; results match noise() exactly.
+        void noise(const float* x, const float* y, float* out, std::size_t count) const;
+        // Row evaluation: out[i] = noise(x[i], y) for i < count (one shared y)
+        void noise_row(const float* x, float y, float* out, std::size_t count) const;
+
+        // Fused fBm row: out[i] = (sum over o of noise(xs[o * xStride + i], ys[o]) * amplitudes[o]) / maxAmp.
+        // All octaves of a pixel are summed in registers and written once, in octave
+        // order, so results match accumulating one octave at a time exactly.
+        void fbm_row(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+            int octaves, float maxAmp, float* out, std::size_t count) const;
+        // Same sum with one y per lane: x_o = xs[o * stride + i], y_o = ys[o * stride + i]
+        void fbm(const float* xs, const float* ys, std::size_t stride, const float* amplitudes,
+            int octaves, float maxAmp, float* out, std::size_t count) const;
+
+        // Value and analytic gradient (d/dx, d/dy of the [0,1] value) in one
+        // evaluation; the value matches noise() exactly
+        float noise_deriv(float x, float y, float& dx, float& dy) const;
+        // Row evaluation of noise_deriv (AVX2 when available, bit-identical)
+        void noise_row_deriv(const float* x, float y, float* out, float* dx, float* dy, std::size_t count) const;
+        // fbm_row plus its gradient: dx[i] = (sum over o of d/dx noise * gradScales[o]) / maxAmp,
+        // same for dy. With gradScales[o] = amplitudes[o] * freq_o / scale the gradient is
+        // per pixel. out[] matches fbm_row exactly.
+        void fbm_row_deriv(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+            const float* gradScales, int octaves, float maxAmp, float* out, float* dx, float* dy, std::size_t count) const;
+
+        // 3D / 4D gradient noise (improved-noise edge gradients): returns [0,1]
+        static float grad(int hash, float x, float y, float z);
+        static float grad(int hash, float x, float y, float z, float w);
+        float noise(float x, float y, float z) const;
+        float noise(float x, float y, float z, float w) const;
+
+        // Row evaluation: out[i] = noise(x[i], y, z[, w]) for i < count.
+        // 8 points per step on AVX2 (also used on AVX-512 hosts); results match noise() exactly.
+        void noise_row(const float* x, float y, float z, float* out, std::size_t count) const;
+        void noise_row(const float* x, float y, float z, float w, float* out, std::size_t count) const;
+
+        // Periodic 2D noise: the lattice wraps every periodX / periodY cells (> 0),
+        // so the value repeats with those periods. Periods of 256 give noise().
+        float noise_periodic(float x, float y, int periodX, int periodY) const;
+        // Row evaluation of noise_periodic (AVX2 when available, bit-identical)
+        void noise_row_periodic(const float* x, float y, int periodX, int periodY, float* out, std::size_t count) const;
     };
 
-    std::vector<std::vector<float>> generate_perlin_map(
+    NoiseMap2D generate_perlin_map(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        int threads = 0     // worker threads, <= 0 = library default (set_thread_count)
+    );
+
+    // Generate an arbitrary rectangle of the unbounded Perlin world.
+    // Adjacent regions with the same parameters and seed tile seamlessly; use a
+    // fixed seed (>= 0) when chunks are generated by separate calls.
+    // CoordinateMode::Float with Region{0, 0, w, h, base, base} matches generate_perlin_map.
+    NoiseMap2D generate_perlin_region(
+        const Region& region,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        int seed = -1,
+        CoordinateMode mode = CoordinateMode::Precise,
+        int threads = 0
+    );
+
+    // Square tile (tileX, tileY) of the world through `cache` (see TileCache.hpp).
+    // Same pixels as generate_perlin_region over
+    // Region{tileX * tileSize, tileY * tileSize, tileSize, tileSize}; the seed must be >= 0.
+    TileCache::Tile perlin_tile(
+        TileCache& cache,
+        std::int64_t tileX,
+        std::int64_t tileY,
+        int tileSize,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        int seed,
+        CoordinateMode mode = CoordinateMode::Precise,
+        int threads = 0
+    );
+
+    // Height map plus its analytic gradient in one pass (see Surface.hpp):
+    // surface.height equals generate_perlin_map with the same arguments, and
+    // surface.dx / dy are its derivatives per pixel. Feed it to surface_normals
+    // for a normal map.
+    SurfaceMap generate_perlin_surface(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        int threads = 0
+    );
+
+    // Seamlessly tiling map: the base octave spans periodX x periodY lattice cells
+    // across the map (feature size width / periodX pixels), and each octave
+    // spans its period times lacunarity^o, rounded, so every octave wraps at the
+    // map edge. Repeating the map shows no seams. Integer lacunarity keeps the
+    // octave frequencies exact.
+    NoiseMap2D generate_perlin_tileable(
+        int width,
+        int height,
+        int periodX,
+        int periodY,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        int seed = -1,
+        int threads = 0
+    );
+
+    // Domain-warped map (see DomainWarp.hpp): generate_perlin_map sampled at
+    // coordinates displaced by a Perlin fBm warp field, both evaluated row by row
+    // in one pass. warp.strength = 0 returns generate_perlin_map exactly.
+    NoiseMap2D generate_perlin_warped(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const DomainWarp& warp,
+        int seed = -1,
+        int threads = 0
+    );
+
+    // Multi-octave 3D volume: voxel (x, y, z) samples noise at
+    // ((x, y, z) + base) / scale * freq per octave, so slice z of a volume is the
+    // same map generate_perlin_frame returns for time = z. Slices are filled in
+    // parallel; the result does not depend on the thread count.
+    NoiseVolume generate_perlin_volume(
+        int width,
+        int height,
+        int depth,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        int threads = 0
+    );
+
+    // Volume at one point in time: 4D noise with the fourth axis at
+    // (time + base) / scale * freq, for animated volumes that evolve rather than slide
+    NoiseVolume generate_perlin_volume_frame(
+        int width,
+        int height,
+        int depth,
+        float time,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        int threads = 0
+    );
+
+    // One animation frame: a 2D map cut from the 3D noise at z = time
+    // (in pixels, scaled like x and y). Consecutive times give a pattern that
+    // evolves in place instead of the sliding of a shifted `base`.
+    NoiseMap2D generate_perlin_frame(
         int width,
         int height,
+        float time,
         float scale,
         int octaves,
         float frequency,
         float persistence,
         float lacunarity,
         float base,
-        int seed = -1
+        int seed = -1,
+        int threads = 0
+    );
+
+    // Frames time0, time0 + timeStep, ... (`frames` of them) delivered to
+    // onFrame in order. Several frames are generated in parallel while only one
+    // batch is held in memory; a random seed (-1) is drawn once for the whole
+    // sequence. Each frame matches generate_perlin_frame at its time.
+    void stream_perlin_frames(
+        int width,
+        int height,
+        int frames,
+        float time0,
+        float timeStep,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const FrameCallback& onFrame,
+        int threads = 0
     );
 
     // Save to grayscale PNG or JPEG (auto-detected from extension)
     // If outputDir is empty, uses default ImageOutput/ directory
-    void save_perlin_image(const std::vector<std::vector<float>>& noise,
+    // compressionLevel: PNG deflate level in [0, 9] (ignored for JPEG)
+    void save_perlin_image(const NoiseMap2D& noise,
         const std::string& filename = "perlin_noise.png",
-        const std::string& outputDir = "");
+        const std::string& outputDir = "",
+        int compressionLevel = 6);
+
+    // Generate and save a map without holding it in memory: row bands are
+    // produced while the previous band is encoded, so peak memory stays at two
+    // bands plus the encoder state. Pixels match generate_perlin_map + save_perlin_image.
+    void stream_perlin_image(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        const std::string& filename = "perlin_noise.png",
+        const std::string& outputDir = "",
+        int threads = 0,
+        int compressionLevel = 6
+    );
+
+    // Generate straight into a memory-mapped map file (see MapFile.hpp). Float32
+    // files are filled in place with no intermediate map; UInt16 files are
+    // quantized from a generated map. The header records the parameters and the
+    // seed actually used. Load with MappedMap::open for zero-copy access.
+    void save_perlin_map_file(
+        const std::string& path,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed = -1,
+        SampleFormat format = SampleFormat::Float32,
+        int threads = 0
+    );
 
     /* Entry wrapper 
         - int width, height: output resolution
@@ -58,7 +312,7 @@ namespace Noise {
         - mode : OutputMode::None, Image, or Map
         - outputDir : custom output directory (empty = default ImageOutput/) */
 
-    std::vector<std::vector<float>> create_perlinnoise(
+    NoiseMap2D create_perlinnoise(
         int width,
         int height,
         float scale,
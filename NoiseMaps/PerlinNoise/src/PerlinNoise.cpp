@@ -3,32 +3,27 @@
 #include <random>
 #include <cmath>
 #include <iostream>
-#include <algorithm> // for std::shuffle
-#include <filesystem>
-#include "stb_image_write.h"
+#include <algorithm>
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "ImageWriter.hpp"
+#include "MapFile.hpp"
+#include "Permutation.hpp"
+#include "Simd.hpp"
+#include "Surface.hpp"
+#include "Fbm.hpp"
+
+#if RELNO_SIMD_X86
+#include <immintrin.h>
+#endif
 
 namespace Noise {
 
     // ---------------------------------------------------------
     // Constructor: initializes permutation table
     // ---------------------------------------------------------
-    PerlinNoise::PerlinNoise(int seed) {
-        p.resize(256);
-        for (int i = 0; i < 256; ++i)
-            p[i] = i;
-
-        if (seed >= 0) {
-            std::mt19937 rng(seed);
-            std::shuffle(p.begin(), p.end(), rng);
-        }
-        else {
-            std::random_device rd;
-            std::mt19937 rng(rd());
-            std::shuffle(p.begin(), p.end(), rng);
-        }
-
-        // duplicate for overflow safety
-        p.insert(p.end(), p.begin(), p.end());
+    PerlinNoise::PerlinNoise(int seed)
+        : p(permutation_table(seed)) {
     }
 
     // ---------------------------------------------------------
@@ -49,6 +44,11 @@ namespace Noise {
         return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
     }
 
+    // d fade / dt = 30 t^2 (t - 1)^2
+    float PerlinNoise::fade_deriv(float t) {
+        return 30.0f * t * t * (t * (t - 2.0f) + 1.0f);
+    }
+
     // ---------------------------------------------------------
     // Core 2D Perlin noise value in [0,1]
     // ---------------------------------------------------------
@@ -72,10 +72,1008 @@ namespace Noise {
         return (lerp(x1, x2, v) + 1.0f) / 2.0f;
     }
 
+    // ---------------------------------------------------------
+    // 2D Perlin noise with its analytic gradient
+    // The value is computed exactly as in noise(). grad() is linear in
+    // (x, y), so each corner's gradient vector is grad(h, 1, 0),
+    // grad(h, 0, 1); the chain rule through the two lerps gives d/dx, d/dy.
+    // ---------------------------------------------------------
+    float PerlinNoise::noise_deriv(float x, float y, float& dx, float& dy) const {
+        int X = (int)std::floor(x) & 255;
+        int Y = (int)std::floor(y) & 255;
+
+        float xf = x - std::floor(x);
+        float yf = y - std::floor(y);
+
+        float u = fade(xf);
+        float v = fade(yf);
+        float du = fade_deriv(xf);
+        float dv = fade_deriv(yf);
+
+        int aa = p[p[X] + Y];
+        int ab = p[p[X] + Y + 1];
+        int ba = p[p[X + 1] + Y];
+        int bb = p[p[X + 1] + Y + 1];
+
+        float ga = grad(aa, xf, yf), gb = grad(ba, xf - 1, yf);
+        float gc = grad(ab, xf, yf - 1), gd = grad(bb, xf - 1, yf - 1);
+        float x1 = lerp(ga, gb, u);
+        float x2 = lerp(gc, gd, u);
+
+        float x1dx = lerp(grad(aa, 1, 0), grad(ba, 1, 0), u) + du * (gb - ga);
+        float x2dx = lerp(grad(ab, 1, 0), grad(bb, 1, 0), u) + du * (gd - gc);
+        float x1dy = lerp(grad(aa, 0, 1), grad(ba, 0, 1), u);
+        float x2dy = lerp(grad(ab, 0, 1), grad(bb, 0, 1), u);
+
+        // the value is remapped from [-1,1] to [0,1], halving the slope
+        dx = lerp(x1dx, x2dx, v) * 0.5f;
+        dy = (lerp(x1dy, x2dy, v) + dv * (x2 - x1)) * 0.5f;
+        return (lerp(x1, x2, v) + 1.0f) / 2.0f;
+    }
+
+    // ---------------------------------------------------------
+    // Periodic 2D Perlin noise value in [0,1]
+    // Lattice cells are wrapped modulo the period before hashing, so
+    // noise_periodic(x + periodX, y) == noise_periodic(x, y). Periods of
+    // 256 reproduce noise(), whose table already repeats every 256 cells.
+    // ---------------------------------------------------------
+    namespace {
+        inline int wrap_cell(int cell, int period) {
+            int r = cell % period;
+            return (r < 0) ? r + period : r;
+        }
+    }
+
+    float PerlinNoise::noise_periodic(float x, float y, int periodX, int periodY) const {
+        float fx = std::floor(x);
+        float fy = std::floor(y);
+        int X0 = wrap_cell(static_cast<int>(fx), periodX);
+        int Y0 = wrap_cell(static_cast<int>(fy), periodY);
+        int X1 = (X0 + 1 == periodX) ? 0 : X0 + 1;
+        int Y1 = (Y0 + 1 == periodY) ? 0 : Y0 + 1;
+        X0 &= 255; X1 &= 255;
+        Y0 &= 255; Y1 &= 255;
+
+        float xf = x - fx;
+        float yf = y - fy;
+
+        float u = fade(xf);
+        float v = fade(yf);
+
+        int aa = p[p[X0] + Y0];
+        int ab = p[p[X0] + Y1];
+        int ba = p[p[X1] + Y0];
+        int bb = p[p[X1] + Y1];
+
+        float x1 = lerp(grad(aa, xf, yf), grad(ba, xf - 1, yf), u);
+        float x2 = lerp(grad(ab, xf, yf - 1), grad(bb, xf - 1, yf - 1), u);
+        return (lerp(x1, x2, v) + 1.0f) / 2.0f;
+    }
+
+    // 12 cube-edge directions picked by the low 4 bits (Perlin's improved noise)
+    float PerlinNoise::grad(int hash, float x, float y, float z) {
+        int h = hash & 15;
+        float u = (h < 8) ? x : y;
+        float v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    // 32 directions: bits 3-4 drop one axis, bits 0-2 flip the signs of the other three
+    float PerlinNoise::grad(int hash, float x, float y, float z, float w) {
+        int h = hash & 31;
+        int drop = h >> 3;
+        float a = (drop == 0) ? y : x;
+        float b = (drop < 2) ? z : y;
+        float c = (drop == 3) ? z : w;
+        return (((h & 4) ? -a : a) + ((h & 2) ? -b : b)) + ((h & 1) ? -c : c);
+    }
+
+    // ---------------------------------------------------------
+    // 3D and 4D Perlin noise values in [0,1]
+    // Corner hashes chain one permutation lookup per axis:
+    // p[p[p[X + i] + Y + j] + Z + k] (+ W + l in 4D)
+    // ---------------------------------------------------------
+    float PerlinNoise::noise(float x, float y, float z) const {
+        float fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+        int X = static_cast<int>(fx) & 255;
+        int Y = static_cast<int>(fy) & 255;
+        int Z = static_cast<int>(fz) & 255;
+
+        float xf = x - fx, yf = y - fy, zf = z - fz;
+        float xf1 = xf - 1.0f, yf1 = yf - 1.0f, zf1 = zf - 1.0f;
+        float u = fade(xf), v = fade(yf), w = fade(zf);
+
+        int h[2][2][2];
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 2; ++j) {
+                int hy = p[p[X + i] + Y + j];
+                h[i][j][0] = p[hy + Z];
+                h[i][j][1] = p[hy + Z + 1];
+            }
+
+        float x1 = lerp(grad(h[0][0][0], xf, yf, zf), grad(h[1][0][0], xf1, yf, zf), u);
+        float x2 = lerp(grad(h[0][1][0], xf, yf1, zf), grad(h[1][1][0], xf1, yf1, zf), u);
+        float y1 = lerp(x1, x2, v);
+        float x3 = lerp(grad(h[0][0][1], xf, yf, zf1), grad(h[1][0][1], xf1, yf, zf1), u);
+        float x4 = lerp(grad(h[0][1][1], xf, yf1, zf1), grad(h[1][1][1], xf1, yf1, zf1), u);
+        float y2 = lerp(x3, x4, v);
+        return (lerp(y1, y2, w) + 1.0f) / 2.0f;
+    }
+
+    float PerlinNoise::noise(float x, float y, float z, float w) const {
+        float fx = std::floor(x), fy = std::floor(y), fz = std::floor(z), fw = std::floor(w);
+        int X = static_cast<int>(fx) & 255;
+        int Y = static_cast<int>(fy) & 255;
+        int Z = static_cast<int>(fz) & 255;
+        int W = static_cast<int>(fw) & 255;
+
+        float xf = x - fx, yf = y - fy, zf = z - fz, wf = w - fw;
+        float xf1 = xf - 1.0f, yf1 = yf - 1.0f, zf1 = zf - 1.0f, wf1 = wf - 1.0f;
+        float u = fade(xf), v = fade(yf), s = fade(zf), t = fade(wf);
+
+        int h[2][2][2][2];
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 2; ++j)
+                for (int k = 0; k < 2; ++k) {
+                    int hz = p[p[p[X + i] + Y + j] + Z + k];
+                    h[i][j][k][0] = p[hz + W];
+                    h[i][j][k][1] = p[hz + W + 1];
+                }
+
+        float cube[2];
+        for (int l = 0; l < 2; ++l) {
+            float wl = l ? wf1 : wf;
+            float x1 = lerp(grad(h[0][0][0][l], xf, yf, zf, wl), grad(h[1][0][0][l], xf1, yf, zf, wl), u);
+            float x2 = lerp(grad(h[0][1][0][l], xf, yf1, zf, wl), grad(h[1][1][0][l], xf1, yf1, zf, wl), u);
+            float y1 = lerp(x1, x2, v);
+            float x3 = lerp(grad(h[0][0][1][l], xf, yf, zf1, wl), grad(h[1][0][1][l], xf1, yf, zf1, wl), u);
+            float x4 = lerp(grad(h[0][1][1][l], xf, yf1, zf1, wl), grad(h[1][1][1][l], xf1, yf1, zf1, wl), u);
+            float y2 = lerp(x3, x4, v);
+            cube[l] = lerp(y1, y2, s);
+        }
+        return (lerp(cube[0], cube[1], t) + 1.0f) / 2.0f;
+    }
+
+    // ---------------------------------------------------------
+    // Batched SIMD kernels
+    // Same operation order as noise() so every lane is bit-identical
+    // to the scalar path: floor, fade, four nested permutation gathers,
+    // branch-free grad() (blend + sign flip) and three lerps.
+    // Each level is compiled with its own target attribute and chosen at run
+    // time (Simd.hpp); kernels start at `i`, stop before the tail and return
+    // where they stopped.
+    // ---------------------------------------------------------
+    namespace {
+
+#if RELNO_SIMD_X86
+        RELNO_TARGET_AVX2 inline __m256 fade8(__m256 t) {
+            // t * t * t * (t * (t * 6 - 15) + 10)
+            __m256 inner = _mm256_add_ps(
+                _mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))),
+                _mm256_set1_ps(10.0f));
+            return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 lerp8(__m256 a, __m256 b, __m256 t) {
+            return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 grad8(__m256i hash, __m256 x, __m256 y) {
+            // h < 2 picks (x, y), otherwise (y, x); bit 0 / bit 1 flip the sign of u / v
+            __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(3));
+            __m256 swap = _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(1)));
+            __m256 u = _mm256_blendv_ps(x, y, swap);
+            __m256 v = _mm256_blendv_ps(y, x, swap);
+            __m256 signU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+            __m256 signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+            return _mm256_add_ps(_mm256_xor_ps(u, signU), _mm256_xor_ps(v, signV));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 perlin8(const int* p, __m256 x, __m256 y) {
+            __m256 fx = _mm256_floor_ps(x);
+            __m256 fy = _mm256_floor_ps(y);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+            __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+
+            __m256 xf = _mm256_sub_ps(x, fx);
+            __m256 yf = _mm256_sub_ps(y, fy);
+            __m256 u = fade8(xf);
+            __m256 v = fade8(yf);
+
+            __m256i pX = _mm256_i32gather_epi32(p, X, 4);
+            __m256i pX1 = _mm256_i32gather_epi32(p, _mm256_add_epi32(X, one), 4);
+            __m256i aa = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX, Y), 4);
+            __m256i ab = _mm256_i32gather_epi32(p, _mm256_add_epi32(_mm256_add_epi32(pX, Y), one), 4);
+            __m256i ba = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX1, Y), 4);
+            __m256i bb = _mm256_i32gather_epi32(p, _mm256_add_epi32(_mm256_add_epi32(pX1, Y), one), 4);
+
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            __m256 xf1 = _mm256_sub_ps(xf, onef);
+            __m256 yf1 = _mm256_sub_ps(yf, onef);
+            __m256 x1 = lerp8(grad8(aa, xf, yf), grad8(ba, xf1, yf), u);
+            __m256 x2 = lerp8(grad8(ab, xf, yf1), grad8(bb, xf1, yf1), u);
+            return _mm256_div_ps(_mm256_add_ps(lerp8(x1, x2, v), onef), _mm256_set1_ps(2.0f));
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 fade16(__m512 t) {
+            __m512 inner = _mm512_add_ps(
+                _mm512_mul_ps(t, _mm512_sub_ps(_mm512_mul_ps(t, _mm512_set1_ps(6.0f)), _mm512_set1_ps(15.0f))),
+                _mm512_set1_ps(10.0f));
+            return _mm512_mul_ps(_mm512_mul_ps(_mm512_mul_ps(t, t), t), inner);
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 lerp16(__m512 a, __m512 b, __m512 t) {
+            return _mm512_add_ps(a, _mm512_mul_ps(t, _mm512_sub_ps(b, a)));
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 grad16(__m512i hash, __m512 x, __m512 y) {
+            __m512i h = _mm512_and_si512(hash, _mm512_set1_epi32(3));
+            __mmask16 swap = _mm512_cmpgt_epi32_mask(h, _mm512_set1_epi32(1));
+            __m512 u = _mm512_mask_blend_ps(swap, x, y);
+            __m512 v = _mm512_mask_blend_ps(swap, y, x);
+            __m512i signU = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(1)), 31);
+            __m512i signV = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(2)), 30);
+            __m512 su = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(u), signU));
+            __m512 sv = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v), signV));
+            return _mm512_add_ps(su, sv);
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 perlin16(const int* p, __m512 x, __m512 y) {
+            __m512 fx = _mm512_floor_ps(x);
+            __m512 fy = _mm512_floor_ps(y);
+            const __m512i mask = _mm512_set1_epi32(255);
+            const __m512i one = _mm512_set1_epi32(1);
+            __m512i X = _mm512_and_si512(_mm512_cvttps_epi32(fx), mask);
+            __m512i Y = _mm512_and_si512(_mm512_cvttps_epi32(fy), mask);
+
+            __m512 xf = _mm512_sub_ps(x, fx);
+            __m512 yf = _mm512_sub_ps(y, fy);
+            __m512 u = fade16(xf);
+            __m512 v = fade16(yf);
+
+            __m512i pX = _mm512_i32gather_epi32(X, p, 4);
+            __m512i pX1 = _mm512_i32gather_epi32(_mm512_add_epi32(X, one), p, 4);
+            __m512i aa = _mm512_i32gather_epi32(_mm512_add_epi32(pX, Y), p, 4);
+            __m512i ab = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_add_epi32(pX, Y), one), p, 4);
+            __m512i ba = _mm512_i32gather_epi32(_mm512_add_epi32(pX1, Y), p, 4);
+            __m512i bb = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_add_epi32(pX1, Y), one), p, 4);
+
+            const __m512 onef = _mm512_set1_ps(1.0f);
+            __m512 xf1 = _mm512_sub_ps(xf, onef);
+            __m512 yf1 = _mm512_sub_ps(yf, onef);
+            __m512 x1 = lerp16(grad16(aa, xf, yf), grad16(ba, xf1, yf), u);
+            __m512 x2 = lerp16(grad16(ab, xf, yf1), grad16(bb, xf1, yf1), u);
+            return _mm512_div_ps(_mm512_add_ps(lerp16(x1, x2, v), onef), _mm512_set1_ps(2.0f));
+        }
+
+        RELNO_TARGET_AVX512 std::size_t noise16(const int* p, const float* x, const float* y, float* out, std::size_t i, std::size_t count) {
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, perlin16(p, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise8(const int* p, const float* x, const float* y, float* out, std::size_t i, std::size_t count) {
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, perlin8(p, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+            return i;
+        }
+
+        RELNO_TARGET_AVX512 std::size_t noise_row16(const int* p, const float* x, float y, float* out, std::size_t i, std::size_t count) {
+            const __m512 vy = _mm512_set1_ps(y);
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, perlin16(p, _mm512_loadu_ps(x + i), vy));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise_row8(const int* p, const float* x, float y, float* out, std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, perlin8(p, _mm256_loadu_ps(x + i), vy));
+            return i;
+        }
+
+        // Octave o reads ys + o * yStride: one y per lane (fbm) or one per octave (fbm_row).
+        // Octaves > 0 fixes the octave count at compile time (see Fbm.hpp), 0 reads octaves.
+        template <int Octaves>
+        RELNO_TARGET_AVX512 std::size_t fbm16(const int* p, const float* xs, std::size_t xStride, const float* ys, std::size_t yStride,
+            bool yPerLane, const float* amplitudes, int octaves, float maxAmp, float* out, std::size_t i, std::size_t count) {
+            const int octaveCount = octave_count<Octaves>(octaves);
+            const __m512 norm = _mm512_set1_ps(maxAmp);
+            for (; i + 16 <= count; i += 16) {
+                __m512 acc = _mm512_setzero_ps();
+                for (int o = 0; o < octaveCount; ++o) {
+                    const float* yo = ys + o * yStride;
+                    __m512 vy = yPerLane ? _mm512_loadu_ps(yo + i) : _mm512_set1_ps(*yo);
+                    __m512 n = perlin16(p, _mm512_loadu_ps(xs + o * xStride + i), vy);
+                    acc = _mm512_add_ps(acc, _mm512_mul_ps(n, _mm512_set1_ps(amplitudes[o])));
+                }
+                _mm512_storeu_ps(out + i, _mm512_div_ps(acc, norm));
+            }
+            return i;
+        }
+
+        template <int Octaves>
+        RELNO_TARGET_AVX2 std::size_t fbm8(const int* p, const float* xs, std::size_t xStride, const float* ys, std::size_t yStride,
+            bool yPerLane, const float* amplitudes, int octaves, float maxAmp, float* out, std::size_t i, std::size_t count) {
+            const int octaveCount = octave_count<Octaves>(octaves);
+            const __m256 norm = _mm256_set1_ps(maxAmp);
+            for (; i + 8 <= count; i += 8) {
+                __m256 acc = _mm256_setzero_ps();
+                for (int o = 0; o < octaveCount; ++o) {
+                    const float* yo = ys + o * yStride;
+                    __m256 vy = yPerLane ? _mm256_loadu_ps(yo + i) : _mm256_set1_ps(*yo);
+                    __m256 n = perlin8(p, _mm256_loadu_ps(xs + o * xStride + i), vy);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(n, _mm256_set1_ps(amplitudes[o])));
+                }
+                _mm256_storeu_ps(out + i, _mm256_div_ps(acc, norm));
+            }
+            return i;
+        }
+
+        // 3D / 4D: AVX2 only (AVX-512 hosts take these as well)
+        RELNO_TARGET_AVX2 inline __m256 sign_flip8(__m256 v, __m256i h, int bit) {
+            // (h & bit) ? -v : v
+            __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(bit)), _mm256_set1_epi32(bit));
+            return _mm256_xor_ps(v, _mm256_and_ps(_mm256_castsi256_ps(set), _mm256_set1_ps(-0.0f)));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 grad8(__m256i hash, __m256 x, __m256 y, __m256 z) {
+            __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+            __m256 u = _mm256_blendv_ps(x, y, _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(7))));
+            // h == 12 or 14 <=> (h & 13) == 12
+            __m256i hx = _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(13)), _mm256_set1_epi32(12));
+            __m256 v = _mm256_blendv_ps(z, x, _mm256_castsi256_ps(hx));
+            v = _mm256_blendv_ps(v, y, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h)));
+            return _mm256_add_ps(sign_flip8(u, h, 1), sign_flip8(v, h, 2));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 grad8(__m256i hash, __m256 x, __m256 y, __m256 z, __m256 w) {
+            __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(31));
+            __m256i drop = _mm256_srli_epi32(h, 3);
+            __m256 a = _mm256_blendv_ps(x, y, _mm256_castsi256_ps(_mm256_cmpeq_epi32(drop, _mm256_setzero_si256())));
+            __m256 b = _mm256_blendv_ps(y, z, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), drop)));
+            __m256 c = _mm256_blendv_ps(w, z, _mm256_castsi256_ps(_mm256_cmpeq_epi32(drop, _mm256_set1_epi32(3))));
+            return _mm256_add_ps(_mm256_add_ps(sign_flip8(a, h, 4), sign_flip8(b, h, 2)), sign_flip8(c, h, 1));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256i gather8(const int* p, __m256i index) {
+            return _mm256_i32gather_epi32(p, index, 4);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 perlin8(const int* p, __m256 x, __m256 y, __m256 z) {
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y), fz = _mm256_floor_ps(z);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+            __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+            __m256i Z = _mm256_and_si256(_mm256_cvttps_epi32(fz), mask);
+
+            __m256 xf = _mm256_sub_ps(x, fx), yf = _mm256_sub_ps(y, fy), zf = _mm256_sub_ps(z, fz);
+            __m256 xf1 = _mm256_sub_ps(xf, onef), yf1 = _mm256_sub_ps(yf, onef), zf1 = _mm256_sub_ps(zf, onef);
+            __m256 u = fade8(xf), v = fade8(yf), w = fade8(zf);
+
+            __m256i h[2][2][2];
+            for (int i = 0; i < 2; ++i) {
+                __m256i hx = gather8(p, _mm256_add_epi32(X, _mm256_set1_epi32(i)));
+                for (int j = 0; j < 2; ++j) {
+                    __m256i hy = gather8(p, _mm256_add_epi32(_mm256_add_epi32(hx, Y), _mm256_set1_epi32(j)));
+                    h[i][j][0] = gather8(p, _mm256_add_epi32(hy, Z));
+                    h[i][j][1] = gather8(p, _mm256_add_epi32(_mm256_add_epi32(hy, Z), one));
+                }
+            }
+
+            __m256 x1 = lerp8(grad8(h[0][0][0], xf, yf, zf), grad8(h[1][0][0], xf1, yf, zf), u);
+            __m256 x2 = lerp8(grad8(h[0][1][0], xf, yf1, zf), grad8(h[1][1][0], xf1, yf1, zf), u);
+            __m256 y1 = lerp8(x1, x2, v);
+            __m256 x3 = lerp8(grad8(h[0][0][1], xf, yf, zf1), grad8(h[1][0][1], xf1, yf, zf1), u);
+            __m256 x4 = lerp8(grad8(h[0][1][1], xf, yf1, zf1), grad8(h[1][1][1], xf1, yf1, zf1), u);
+            __m256 y2 = lerp8(x3, x4, v);
+            return _mm256_div_ps(_mm256_add_ps(lerp8(y1, y2, w), onef), _mm256_set1_ps(2.0f));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 perlin8(const int* p, __m256 x, __m256 y, __m256 z, __m256 w) {
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y), fz = _mm256_floor_ps(z), fw = _mm256_floor_ps(w);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+            __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+            __m256i Z = _mm256_and_si256(_mm256_cvttps_epi32(fz), mask);
+            __m256i W = _mm256_and_si256(_mm256_cvttps_epi32(fw), mask);
+
+            __m256 xf = _mm256_sub_ps(x, fx), yf = _mm256_sub_ps(y, fy), zf = _mm256_sub_ps(z, fz), wf = _mm256_sub_ps(w, fw);
+            __m256 xf1 = _mm256_sub_ps(xf, onef), yf1 = _mm256_sub_ps(yf, onef);
+            __m256 zf1 = _mm256_sub_ps(zf, onef), wf1 = _mm256_sub_ps(wf, onef);
+            __m256 u = fade8(xf), v = fade8(yf), s = fade8(zf), t = fade8(wf);
+
+            __m256i h[2][2][2][2];
+            for (int i = 0; i < 2; ++i) {
+                __m256i hx = gather8(p, _mm256_add_epi32(X, _mm256_set1_epi32(i)));
+                for (int j = 0; j < 2; ++j) {
+                    __m256i hy = gather8(p, _mm256_add_epi32(_mm256_add_epi32(hx, Y), _mm256_set1_epi32(j)));
+                    for (int k = 0; k < 2; ++k) {
+                        __m256i hz = gather8(p, _mm256_add_epi32(_mm256_add_epi32(hy, Z), _mm256_set1_epi32(k)));
+                        h[i][j][k][0] = gather8(p, _mm256_add_epi32(hz, W));
+                        h[i][j][k][1] = gather8(p, _mm256_add_epi32(_mm256_add_epi32(hz, W), one));
+                    }
+                }
+            }
+
+            __m256 cube[2];
+            for (int l = 0; l < 2; ++l) {
+                __m256 wl = l ? wf1 : wf;
+                __m256 x1 = lerp8(grad8(h[0][0][0][l], xf, yf, zf, wl), grad8(h[1][0][0][l], xf1, yf, zf, wl), u);
+                __m256 x2 = lerp8(grad8(h[0][1][0][l], xf, yf1, zf, wl), grad8(h[1][1][0][l], xf1, yf1, zf, wl), u);
+                __m256 y1 = lerp8(x1, x2, v);
+                __m256 x3 = lerp8(grad8(h[0][0][1][l], xf, yf, zf1, wl), grad8(h[1][0][1][l], xf1, yf, zf1, wl), u);
+                __m256 x4 = lerp8(grad8(h[0][1][1][l], xf, yf1, zf1, wl), grad8(h[1][1][1][l], xf1, yf1, zf1, wl), u);
+                __m256 y2 = lerp8(x3, x4, v);
+                cube[l] = lerp8(y1, y2, s);
+            }
+            return _mm256_div_ps(_mm256_add_ps(lerp8(cube[0], cube[1], t), onef), _mm256_set1_ps(2.0f));
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise_row8(const int* p, const float* x, float y, float z, float* out, std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y), vz = _mm256_set1_ps(z);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, perlin8(p, _mm256_loadu_ps(x + i), vy, vz));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise_row8(const int* p, const float* x, float y, float z, float w, float* out, std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y), vz = _mm256_set1_ps(z), vw = _mm256_set1_ps(w);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, perlin8(p, _mm256_loadu_ps(x + i), vy, vz, vw));
+            return i;
+        }
+
+        // Value + gradient (see noise_deriv): AVX2 only
+        RELNO_TARGET_AVX2 inline __m256 fade_deriv8(__m256 t) {
+            // 30 * t * t * (t * (t - 2) + 1)
+            __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(t, _mm256_set1_ps(2.0f))), _mm256_set1_ps(1.0f));
+            return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(30.0f), t), t), inner);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 perlin_deriv8(const int* p, __m256 x, __m256 y, __m256& dx, __m256& dy) {
+            __m256 fx = _mm256_floor_ps(x);
+            __m256 fy = _mm256_floor_ps(y);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+            __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+
+            __m256 xf = _mm256_sub_ps(x, fx);
+            __m256 yf = _mm256_sub_ps(y, fy);
+            __m256 u = fade8(xf);
+            __m256 v = fade8(yf);
+            __m256 du = fade_deriv8(xf);
+            __m256 dv = fade_deriv8(yf);
+
+            __m256i pX = _mm256_i32gather_epi32(p, X, 4);
+            __m256i pX1 = _mm256_i32gather_epi32(p, _mm256_add_epi32(X, one), 4);
+            __m256i aa = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX, Y), 4);
+            __m256i ab = _mm256_i32gather_epi32(p, _mm256_add_epi32(_mm256_add_epi32(pX, Y), one), 4);
+            __m256i ba = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX1, Y), 4);
+            __m256i bb = _mm256_i32gather_epi32(p, _mm256_add_epi32(_mm256_add_epi32(pX1, Y), one), 4);
+
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 xf1 = _mm256_sub_ps(xf, onef);
+            __m256 yf1 = _mm256_sub_ps(yf, onef);
+            __m256 ga = grad8(aa, xf, yf), gb = grad8(ba, xf1, yf);
+            __m256 gc = grad8(ab, xf, yf1), gd = grad8(bb, xf1, yf1);
+            __m256 x1 = lerp8(ga, gb, u);
+            __m256 x2 = lerp8(gc, gd, u);
+
+            __m256 x1dx = _mm256_add_ps(lerp8(grad8(aa, onef, zero), grad8(ba, onef, zero), u), _mm256_mul_ps(du, _mm256_sub_ps(gb, ga)));
+            __m256 x2dx = _mm256_add_ps(lerp8(grad8(ab, onef, zero), grad8(bb, onef, zero), u), _mm256_mul_ps(du, _mm256_sub_ps(gd, gc)));
+            __m256 x1dy = lerp8(grad8(aa, zero, onef), grad8(ba, zero, onef), u);
+            __m256 x2dy = lerp8(grad8(ab, zero, onef), grad8(bb, zero, onef), u);
+
+            const __m256 half = _mm256_set1_ps(0.5f);
+            dx = _mm256_mul_ps(lerp8(x1dx, x2dx, v), half);
+            dy = _mm256_mul_ps(_mm256_add_ps(lerp8(x1dy, x2dy, v), _mm256_mul_ps(dv, _mm256_sub_ps(x2, x1))), half);
+            return _mm256_div_ps(_mm256_add_ps(lerp8(x1, x2, v), onef), _mm256_set1_ps(2.0f));
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise_row_deriv8(const int* p, const float* x, float y, float* out, float* dx, float* dy,
+            std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y);
+            for (; i + 8 <= count; i += 8) {
+                __m256 ddx, ddy;
+                _mm256_storeu_ps(out + i, perlin_deriv8(p, _mm256_loadu_ps(x + i), vy, ddx, ddy));
+                _mm256_storeu_ps(dx + i, ddx);
+                _mm256_storeu_ps(dy + i, ddy);
+            }
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t fbm_row_deriv8(const int* p, const float* xs, std::size_t xStride, const float* ys,
+            const float* amplitudes, const float* gradScales, int octaves, float maxAmp,
+            float* out, float* dx, float* dy, std::size_t i, std::size_t count) {
+            const __m256 norm = _mm256_set1_ps(maxAmp);
+            for (; i + 8 <= count; i += 8) {
+                __m256 acc = _mm256_setzero_ps();
+                __m256 accX = _mm256_setzero_ps();
+                __m256 accY = _mm256_setzero_ps();
+                for (int o = 0; o < octaves; ++o) {
+                    __m256 ndx, ndy;
+                    __m256 n = perlin_deriv8(p, _mm256_loadu_ps(xs + o * xStride + i), _mm256_set1_ps(ys[o]), ndx, ndy);
+                    const __m256 g = _mm256_set1_ps(gradScales[o]);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(n, _mm256_set1_ps(amplitudes[o])));
+                    accX = _mm256_add_ps(accX, _mm256_mul_ps(ndx, g));
+                    accY = _mm256_add_ps(accY, _mm256_mul_ps(ndy, g));
+                }
+                _mm256_storeu_ps(out + i, _mm256_div_ps(acc, norm));
+                _mm256_storeu_ps(dx + i, _mm256_div_ps(accX, norm));
+                _mm256_storeu_ps(dy + i, _mm256_div_ps(accY, norm));
+            }
+            return i;
+        }
+
+        // Periodic 2D: AVX2 only. Cells are whole floats, so the wrap
+        // cell - period * floor(cell / period) is exact (|cell| < 2^24);
+        // the compares correct a quotient rounded across an integer.
+        RELNO_TARGET_AVX2 inline __m256i wrap_cell8(__m256 cell, __m256 period) {
+            __m256 r = _mm256_sub_ps(cell, _mm256_mul_ps(period, _mm256_floor_ps(_mm256_div_ps(cell, period))));
+            r = _mm256_add_ps(r, _mm256_and_ps(period, _mm256_cmp_ps(r, _mm256_setzero_ps(), _CMP_LT_OQ)));
+            r = _mm256_sub_ps(r, _mm256_and_ps(period, _mm256_cmp_ps(r, period, _CMP_GE_OQ)));
+            return _mm256_cvttps_epi32(r);
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise_row_periodic8(const int* p, const float* x, float y, int periodX, int periodY,
+            float* out, std::size_t i, std::size_t count) {
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            const __m256 px = _mm256_set1_ps(static_cast<float>(periodX));
+            const __m256i pxi = _mm256_set1_epi32(periodX);
+
+            // the row's y cells are shared by every lane
+            const float fy = std::floor(y);
+            const int Y0 = wrap_cell(static_cast<int>(fy), periodY);
+            const int Y1 = (Y0 + 1 == periodY) ? 0 : Y0 + 1;
+            const __m256i vY0 = _mm256_set1_epi32(Y0 & 255);
+            const __m256i vY1 = _mm256_set1_epi32(Y1 & 255);
+            const __m256 yf = _mm256_set1_ps(y - fy);
+            const __m256 yf1 = _mm256_sub_ps(yf, onef);
+            const __m256 v = fade8(yf);
+
+            for (; i + 8 <= count; i += 8) {
+                __m256 vx = _mm256_loadu_ps(x + i);
+                __m256 fx = _mm256_floor_ps(vx);
+                __m256i X0 = wrap_cell8(fx, px);
+                __m256i X1 = _mm256_add_epi32(X0, one);
+                X1 = _mm256_andnot_si256(_mm256_cmpeq_epi32(X1, pxi), X1);
+                X0 = _mm256_and_si256(X0, mask);
+                X1 = _mm256_and_si256(X1, mask);
+
+                __m256 xf = _mm256_sub_ps(vx, fx);
+                __m256 xf1 = _mm256_sub_ps(xf, onef);
+                __m256 u = fade8(xf);
+
+                __m256i pX0 = _mm256_i32gather_epi32(p, X0, 4);
+                __m256i pX1 = _mm256_i32gather_epi32(p, X1, 4);
+                __m256i aa = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX0, vY0), 4);
+                __m256i ab = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX0, vY1), 4);
+                __m256i ba = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX1, vY0), 4);
+                __m256i bb = _mm256_i32gather_epi32(p, _mm256_add_epi32(pX1, vY1), 4);
+
+                __m256 x1 = lerp8(grad8(aa, xf, yf), grad8(ba, xf1, yf), u);
+                __m256 x2 = lerp8(grad8(ab, xf, yf1), grad8(bb, xf1, yf1), u);
+                _mm256_storeu_ps(out + i, _mm256_div_ps(_mm256_add_ps(lerp8(x1, x2, v), onef), _mm256_set1_ps(2.0f)));
+            }
+            return i;
+        }
+#endif
+
+    } // namespace
+
+    void PerlinNoise::noise(const float* x, const float* y, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        const SimdLevel level = simd_level();
+        if (level >= SimdLevel::AVX512) i = noise16(p.data(), x, y, out, i, count);
+        if (level >= SimdLevel::AVX2) i = noise8(p.data(), x, y, out, i, count);
+#endif
+        // scalar fallback / tail
+        for (; i < count; ++i)
+            out[i] = noise(x[i], y[i]);
+    }
+
+    void PerlinNoise::noise_row(const float* x, float y, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        const SimdLevel level = simd_level();
+        if (level >= SimdLevel::AVX512) i = noise_row16(p.data(), x, y, out, i, count);
+        if (level >= SimdLevel::AVX2) i = noise_row8(p.data(), x, y, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise(x[i], y);
+    }
+
+    void PerlinNoise::fbm_row(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+        int octaves, float maxAmp, float* out, std::size_t count) const {
+        // Unrolled instantiations for the usual octave counts
+        dispatch_octaves(octaves, [&](auto unrolled) {
+            constexpr int Octaves = decltype(unrolled)::value;
+            const int octaveCount = octave_count<Octaves>(octaves);
+            std::size_t i = 0;
+#if RELNO_SIMD_X86
+            const SimdLevel level = simd_level();
+            if (level >= SimdLevel::AVX512) i = fbm16<Octaves>(p.data(), xs, xStride, ys, 1, false, amplitudes, octaves, maxAmp, out, i, count);
+            if (level >= SimdLevel::AVX2) i = fbm8<Octaves>(p.data(), xs, xStride, ys, 1, false, amplitudes, octaves, maxAmp, out, i, count);
+#endif
+            for (; i < count; ++i) {
+                float acc = 0.0f;
+                for (int o = 0; o < octaveCount; ++o)
+                    acc += noise(xs[o * xStride + i], ys[o]) * amplitudes[o];
+                out[i] = acc / maxAmp;
+            }
+        });
+    }
+
+    void PerlinNoise::fbm(const float* xs, const float* ys, std::size_t stride, const float* amplitudes,
+        int octaves, float maxAmp, float* out, std::size_t count) const {
+        dispatch_octaves(octaves, [&](auto unrolled) {
+            constexpr int Octaves = decltype(unrolled)::value;
+            const int octaveCount = octave_count<Octaves>(octaves);
+            std::size_t i = 0;
+#if RELNO_SIMD_X86
+            const SimdLevel level = simd_level();
+            if (level >= SimdLevel::AVX512) i = fbm16<Octaves>(p.data(), xs, stride, ys, stride, true, amplitudes, octaves, maxAmp, out, i, count);
+            if (level >= SimdLevel::AVX2) i = fbm8<Octaves>(p.data(), xs, stride, ys, stride, true, amplitudes, octaves, maxAmp, out, i, count);
+#endif
+            for (; i < count; ++i) {
+                float acc = 0.0f;
+                for (int o = 0; o < octaveCount; ++o)
+                    acc += noise(xs[o * stride + i], ys[o * stride + i]) * amplitudes[o];
+                out[i] = acc / maxAmp;
+            }
+        });
+    }
+
+    void PerlinNoise::noise_row(const float* x, float y, float z, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise_row8(p.data(), x, y, z, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise(x[i], y, z);
+    }
+
+    void PerlinNoise::noise_row(const float* x, float y, float z, float w, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise_row8(p.data(), x, y, z, w, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise(x[i], y, z, w);
+    }
+
+    void PerlinNoise::noise_row_deriv(const float* x, float y, float* out, float* dx, float* dy, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise_row_deriv8(p.data(), x, y, out, dx, dy, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise_deriv(x[i], y, dx[i], dy[i]);
+    }
+
+    void PerlinNoise::fbm_row_deriv(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+        const float* gradScales, int octaves, float maxAmp, float* out, float* dx, float* dy, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2)
+            i = fbm_row_deriv8(p.data(), xs, xStride, ys, amplitudes, gradScales, octaves, maxAmp, out, dx, dy, i, count);
+#endif
+        for (; i < count; ++i) {
+            float acc = 0.0f, accX = 0.0f, accY = 0.0f;
+            for (int o = 0; o < octaves; ++o) {
+                float ndx, ndy;
+                float n = noise_deriv(xs[o * xStride + i], ys[o], ndx, ndy);
+                acc += n * amplitudes[o];
+                accX += ndx * gradScales[o];
+                accY += ndy * gradScales[o];
+            }
+            out[i] = acc / maxAmp;
+            dx[i] = accX / maxAmp;
+            dy[i] = accY / maxAmp;
+        }
+    }
+
+    void PerlinNoise::noise_row_periodic(const float* x, float y, int periodX, int periodY, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise_row_periodic8(p.data(), x, y, periodX, periodY, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise_periodic(x[i], y, periodX, periodY);
+    }
+
+    // ---------------------------------------------------------
+    // Shared multi-octave fill used by the map and region generators
+    // ---------------------------------------------------------
+    namespace {
+
+        void validate_fbm(float scale, int octaves, float frequency, float persistence, float lacunarity) {
+            if (scale <= 0.0f)
+                throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
+            if (octaves < 1)
+                throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
+            if (frequency <= 0.0f)
+                throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(frequency));
+            if (persistence < 0.0f || persistence > 1.0f)
+                throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
+            if (lacunarity <= 0.0f)
+                throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+        }
+
+        // Noise-space coordinate of world pixel `p` for an octave running at `freq`
+        inline float to_noise_space(std::int64_t p, double offset, float scale, float freq, CoordinateMode mode) {
+            if (mode == CoordinateMode::Float)
+                return (static_cast<float>(p) + static_cast<float>(offset)) / scale * freq;
+
+            // The permutation table repeats every 256 lattice cells: drop whole
+            // periods in double and evaluate only the remainder in float
+            double c = (static_cast<double>(p) + offset) / scale * freq;
+            return static_cast<float>(c - 256.0 * std::floor(c / 256.0));
+        }
+
+        struct FbmSchedule {
+            std::vector<float> amplitudes;
+            std::vector<float> freqs;
+            float maxAmp = 0.0f;
+        };
+
+        FbmSchedule make_schedule(int octaves, float frequency, float persistence, float lacunarity) {
+            FbmSchedule schedule;
+            schedule.amplitudes.resize(octaves);
+            schedule.freqs.resize(octaves);
+            fbm_schedule(octaves, frequency, persistence, lacunarity,
+                schedule.amplitudes.data(), schedule.freqs.data(), schedule.maxAmp);
+            return schedule;
+        }
+
+        // Writes normalized fBm for world pixels (region.x + x, region.y + y) into `noise`
+        void fill_perlin(NoiseMap2D& noise, const PerlinNoise& generator, const Region& region,
+            float scale, int octaves, float frequency, float persistence, float lacunarity,
+            CoordinateMode mode, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = region.width;
+            const int height = region.height;
+
+            // Octave schedule, computed once so every band uses identical values
+            const FbmSchedule schedule = make_schedule(octaves, frequency, persistence, lacunarity);
+            const std::vector<float>& amplitudes = schedule.amplitudes;
+            const std::vector<float>& freqs = schedule.freqs;
+            const float maxAmp = schedule.maxAmp;
+
+            // per-octave x coordinates, shared read-only by every band
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o)
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] = to_noise_space(region.x + x, region.offsetX, scale, freqs[o], mode);
+
+            // Split the map into cache-sized row bands evaluated in parallel. Each pixel
+            // depends only on its own coordinates, so the result is bit-identical for
+            // any thread count. Every row is written once: all octaves and the
+            // normalization (perlin noise() is already in [0,1], so just divide by
+            // the max amplitude) happen in fbm_row.
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> ys(octaves);
+
+                for (int y = y0; y < y1; ++y) {
+                    for (int o = 0; o < octaves; ++o)
+                        ys[o] = to_noise_space(region.y + y, region.offsetY, scale, freqs[o], mode);
+                    generator.fbm_row(xs.data(), static_cast<std::size_t>(width), ys.data(), amplitudes.data(),
+                        octaves, maxAmp, noise.row(y), static_cast<std::size_t>(width));
+                }
+            }, threads);
+        }
+
+        // fill_perlin over Region{0, 0, w, h, base, base} in Float mode, plus the
+        // per-pixel gradient of the normalized height
+        void fill_perlin_surface(SurfaceMap& surface, const PerlinNoise& generator, float base, float scale,
+            const FbmSchedule& schedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = surface.height.width();
+            const int height = surface.height.height();
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            // d(noise space) / d(pixel) = freq / scale
+            std::vector<float> gradScales(octaves);
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o) {
+                gradScales[o] = schedule.amplitudes[o] * schedule.freqs[o] / scale;
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] = to_noise_space(x, base, scale, schedule.freqs[o], CoordinateMode::Float);
+            }
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> ys(octaves);
+
+                for (int y = y0; y < y1; ++y) {
+                    for (int o = 0; o < octaves; ++o)
+                        ys[o] = to_noise_space(y, base, scale, schedule.freqs[o], CoordinateMode::Float);
+                    generator.fbm_row_deriv(xs.data(), static_cast<std::size_t>(width), ys.data(), schedule.amplitudes.data(),
+                        gradScales.data(), octaves, schedule.maxAmp, surface.height.row(y), surface.dx.row(y), surface.dy.row(y),
+                        static_cast<std::size_t>(width));
+                }
+            }, threads);
+        }
+
+        // Writes normalized fBm of 3D noise (4D when `time` is set) for zs.size()
+        // slices of width x height through rowOut(slice, y). Slice s sits at
+        // z = zs[s] and the fourth axis at *time, both in unscaled world units
+        // (base already added). Slices and row bands are split across threads
+        // together; octaves are accumulated in order, so the result does not
+        // depend on the thread count or the SIMD level.
+        template <class RowOut>
+        void fill_perlin_slices(const PerlinNoise& generator, int width, int height,
+            const std::vector<float>& zs, const float* time, float scale, float base,
+            const FbmSchedule& schedule, RowOut rowOut, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o)
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] = (static_cast<float>(x) + base) / scale * schedule.freqs[o];
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(zs.size() * bands, [&](std::size_t task) {
+                const std::size_t slice = task / bands;
+                const int y0 = static_cast<int>(task % bands) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> octave(width);
+
+                for (int y = y0; y < y1; ++y) {
+                    float* out = rowOut(slice, y);
+                    std::fill(out, out + width, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        const float freq = schedule.freqs[o];
+                        const float ny = (static_cast<float>(y) + base) / scale * freq;
+                        const float nz = zs[slice] / scale * freq;
+                        if (time != nullptr)
+                            generator.noise_row(xs.data() + static_cast<std::size_t>(o) * width, ny, nz, *time / scale * freq,
+                                octave.data(), static_cast<std::size_t>(width));
+                        else
+                            generator.noise_row(xs.data() + static_cast<std::size_t>(o) * width, ny, nz,
+                                octave.data(), static_cast<std::size_t>(width));
+
+                        const float amplitude = schedule.amplitudes[o];
+                        for (int x = 0; x < width; ++x)
+                            out[x] += octave[x] * amplitude;
+                    }
+                    for (int x = 0; x < width; ++x)
+                        out[x] /= schedule.maxAmp;
+                }
+            }, threads);
+        }
+
+        void validate_extent(int width, int height) {
+            if (width <= 0)
+                throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+            if (height <= 0)
+                throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        }
+
+        NoiseVolume fill_perlin_volume(const PerlinNoise& generator, int width, int height, int depth,
+            const float* time, float scale, float base, const FbmSchedule& schedule, int threads) {
+            NoiseVolume volume = NoiseVolume::uninitialized(width, height, depth);
+            std::vector<float> zs(depth);
+            for (int z = 0; z < depth; ++z)
+                zs[z] = static_cast<float>(z) + base;
+            fill_perlin_slices(generator, width, height, zs, time, scale, base, schedule,
+                [&](std::size_t slice, int y) { return volume.row(y, static_cast<int>(slice)); }, threads);
+            return volume;
+        }
+
+        // Lattice period of an octave: the base period times the octave's
+        // frequency multiplier, rounded so every octave wraps at the tile edge
+        int octave_period(int period, float multiplier) {
+            return std::max(1, static_cast<int>(std::lround(static_cast<double>(period) * multiplier)));
+        }
+
+        // Writes normalized periodic fBm into `noise`: octave o spans
+        // octave_period(period, freqs[o]) lattice cells across the map in each
+        // axis, so the right/bottom edges continue into the left/top ones
+        void fill_perlin_tileable(NoiseMap2D& noise, const PerlinNoise& generator, int periodX, int periodY,
+            const FbmSchedule& schedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = noise.width();
+            const int height = noise.height();
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            std::vector<int> periodsX(octaves), periodsY(octaves);
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o) {
+                periodsX[o] = octave_period(periodX, schedule.freqs[o]);
+                periodsY[o] = octave_period(periodY, schedule.freqs[o]);
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] =
+                        static_cast<float>(x) * static_cast<float>(periodsX[o]) / static_cast<float>(width);
+            }
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> octave(width);
+
+                for (int y = y0; y < y1; ++y) {
+                    float* out = noise.row(y);
+                    std::fill(out, out + width, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        const float ny = static_cast<float>(y) * static_cast<float>(periodsY[o]) / static_cast<float>(height);
+                        generator.noise_row_periodic(xs.data() + static_cast<std::size_t>(o) * width, ny,
+                            periodsX[o], periodsY[o], octave.data(), static_cast<std::size_t>(width));
+
+                        const float amplitude = schedule.amplitudes[o];
+                        for (int x = 0; x < width; ++x)
+                            out[x] += octave[x] * amplitude;
+                    }
+                    for (int x = 0; x < width; ++x)
+                        out[x] /= schedule.maxAmp;
+                }
+            }, threads);
+        }
+
+        // Warped fBm (see DomainWarp.hpp): each row evaluates the warp field and
+        // the map at the displaced points in one batched pass, in cache-sized bands
+        void fill_perlin_warped(NoiseMap2D& noise, const PerlinNoise& generator, const PerlinNoise& field, float base, float scale,
+            const FbmSchedule& schedule, const DomainWarp& warp, const FbmSchedule& warpSchedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = noise.width();
+            const int height = noise.height();
+            const FbmLayer map{ schedule.amplitudes.data(), schedule.freqs.data(),
+                static_cast<int>(schedule.freqs.size()), schedule.maxAmp, scale };
+            const FbmLayer warpLayer{ warpSchedule.amplitudes.data(), warpSchedule.freqs.data(),
+                static_cast<int>(warpSchedule.freqs.size()), warpSchedule.maxAmp, warp.scale };
+            const int maxOctaves = std::max(map.octaves, warpLayer.octaves);
+
+            // unwarped pixel coordinates, as generate_perlin_map forms them
+            std::vector<float> px(width);
+            for (int x = 0; x < width; ++x)
+                px[x] = static_cast<float>(x) + base;
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                WarpScratch scratch(width, maxOctaves);
+                for (int y = y0; y < y1; ++y)
+                    warped_fbm_row(generator, map, field, warpLayer, warp, px.data(), static_cast<float>(y) + base,
+                        noise.row(y), width, scratch);
+            }, threads);
+        }
+
+    } // namespace
+
     // ---------------------------------------------------------
     // Multi-octave map generator
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> generate_perlin_map(
+    NoiseMap2D generate_perlin_map(
         int width,
         int height,
         float scale,
@@ -84,105 +1082,381 @@ namespace Noise {
         float persistence,
         float lacunarity,
         float base,
-        int seed
+        int seed,
+        int threads
     ) {
+        StatsScope stats("generate_perlin_map", pixel_count(width, height));
         // Validate parameters
         if (width <= 0)
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         if (height <= 0)
             throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
-        if (scale <= 0.0f)
-            throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
-        if (octaves < 1)
-            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
-        if (frequency <= 0.0f)
-            throw std::invalid_argument("frequency must be > 0, got: " + std::to_string(frequency));
-        if (persistence < 0.0f || persistence > 1.0f)
-            throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
-        if (lacunarity <= 0.0f)
-            throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
 
         PerlinNoise generator(seed);
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width, 0.0f));
-
-        float amplitude = 1.0f;
-        float maxAmplitude = 0.0f;
-        float freq = frequency;
-
-        for (int o = 0; o < octaves; ++o) {
-            for (int y = 0; y < height; ++y) {
-                for (int x = 0; x < width; ++x) {
-                    float nx = (x + base) / scale * freq;
-                    float ny = (y + base) / scale * freq;
-                    noise[y][x] += generator.noise(nx, ny) * amplitude;
-                }
-            }
-            maxAmplitude += amplitude;
-            amplitude *= persistence;
-            freq *= lacunarity;
-        }
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        Region region{ 0, 0, width, height, base, base };
+        fill_perlin(noise, generator, region, scale, octaves, frequency, persistence, lacunarity, CoordinateMode::Float, threads);
+        return noise;
+    }
 
-        // Normalize to [0,1] - consistent with SimplexNoise approach
-        // Perlin noise() already returns [0,1], so just divide by max amplitude
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                noise[y][x] /= maxAmplitude;
+    // ---------------------------------------------------------
+    // World-space region generator (seamless chunks)
+    // ---------------------------------------------------------
+    NoiseMap2D generate_perlin_region(
+        const Region& region,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        int seed,
+        CoordinateMode mode,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_region", pixel_count(region.width, region.height));
+        if (region.width <= 0)
+            throw std::invalid_argument("region width must be > 0, got: " + std::to_string(region.width));
+        if (region.height <= 0)
+            throw std::invalid_argument("region height must be > 0, got: " + std::to_string(region.height));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
 
+        PerlinNoise generator(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(region.width, region.height);
+        fill_perlin(noise, generator, region, scale, octaves, frequency, persistence, lacunarity, mode, threads);
         return noise;
     }
 
     // ---------------------------------------------------------
-    // Save Perlin map to grayscale PNG or JPEG (auto-detected from extension)
+    // Height map with analytic gradient (normal maps)
     // ---------------------------------------------------------
-    void save_perlin_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) {
-            throw std::invalid_argument("Cannot save empty noise map.");
-        }
+    SurfaceMap generate_perlin_surface(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_surface", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
 
-        int height = noise.size();
-        int width = noise[0].size();
+        PerlinNoise generator(seed);
+        SurfaceMap surface{ NoiseMap2D::uninitialized(width, height), NoiseMap2D::uninitialized(width, height),
+            NoiseMap2D::uninitialized(width, height) };
+        fill_perlin_surface(surface, generator, base, scale, make_schedule(octaves, frequency, persistence, lacunarity), threads);
+        return surface;
+    }
 
-        std::vector<unsigned char> imgData(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                imgData[y * width + x] = static_cast<unsigned char>(noise[y][x] * 255.0f);
+    // ---------------------------------------------------------
+    // Seamlessly tiling map generator
+    // ---------------------------------------------------------
+    NoiseMap2D generate_perlin_tileable(
+        int width,
+        int height,
+        int periodX,
+        int periodY,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_tileable", pixel_count(width, height));
+        validate_extent(width, height);
+        if (periodX <= 0)
+            throw std::invalid_argument("periodX must be > 0, got: " + std::to_string(periodX));
+        if (periodY <= 0)
+            throw std::invalid_argument("periodY must be > 0, got: " + std::to_string(periodY));
+        // scale and frequency follow from the map size and the periods
+        validate_fbm(1.0f, octaves, 1.0f, persistence, lacunarity);
 
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
-        }
-        else {
-            outDir = outputDir;
+        PerlinNoise generator(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_perlin_tileable(noise, generator, periodX, periodY,
+            make_schedule(octaves, 1.0f, persistence, lacunarity), threads);
+        return noise;
+    }
+
+    NoiseMap2D generate_perlin_warped(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        const DomainWarp& warp,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_warped", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+        validate_fbm(warp.scale, warp.octaves, 1.0f, warp.persistence, warp.lacunarity);
+        if (warp.levels < 1)
+            throw std::invalid_argument("warp levels must be >= 1, got: " + std::to_string(warp.levels));
+
+        PerlinNoise generator(seed);
+        PerlinNoise field(warp_seed(warp, seed));
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_perlin_warped(noise, generator, field, base, scale, make_schedule(octaves, frequency, persistence, lacunarity),
+            warp, make_schedule(warp.octaves, 1.0f, warp.persistence, warp.lacunarity), threads);
+        return noise;
+    }
+
+    // ---------------------------------------------------------
+    // Volumes and animation frames (3D / 4D noise)
+    // ---------------------------------------------------------
+    NoiseVolume generate_perlin_volume(
+        int width,
+        int height,
+        int depth,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_volume", pixel_count(width, height, depth));
+        validate_extent(width, height);
+        if (depth <= 0)
+            throw std::invalid_argument("depth must be > 0, got: " + std::to_string(depth));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+
+        PerlinNoise generator(seed);
+        return fill_perlin_volume(generator, width, height, depth, nullptr, scale, base,
+            make_schedule(octaves, frequency, persistence, lacunarity), threads);
+    }
+
+    NoiseVolume generate_perlin_volume_frame(
+        int width,
+        int height,
+        int depth,
+        float time,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_volume_frame", pixel_count(width, height, depth));
+        validate_extent(width, height);
+        if (depth <= 0)
+            throw std::invalid_argument("depth must be > 0, got: " + std::to_string(depth));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+
+        PerlinNoise generator(seed);
+        const float w = time + base;
+        return fill_perlin_volume(generator, width, height, depth, &w, scale, base,
+            make_schedule(octaves, frequency, persistence, lacunarity), threads);
+    }
+
+    NoiseMap2D generate_perlin_frame(
+        int width,
+        int height,
+        float time,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_perlin_frame", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+
+        PerlinNoise generator(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_perlin_slices(generator, width, height, { time + base }, nullptr, scale, base,
+            make_schedule(octaves, frequency, persistence, lacunarity),
+            [&](std::size_t, int y) { return noise.row(y); }, threads);
+        return noise;
+    }
+
+    void stream_perlin_frames(
+        int width,
+        int height,
+        int frames,
+        float time0,
+        float timeStep,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const FrameCallback& onFrame,
+        int threads
+    ) {
+        StatsScope stats("stream_perlin_frames", pixel_count(width, height, frames));
+        validate_extent(width, height);
+        if (frames < 0)
+            throw std::invalid_argument("frames must be >= 0, got: " + std::to_string(frames));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+        if (!onFrame)
+            throw std::invalid_argument("onFrame callback must not be empty");
+
+        PerlinNoise generator(seed);
+        const FbmSchedule schedule = make_schedule(octaves, frequency, persistence, lacunarity);
+
+        // One frame per worker per batch; the maps are reused across batches
+        const int batch = std::min(frames, static_cast<int>(resolve_thread_count(threads)));
+        std::vector<NoiseMap2D> maps;
+        for (int i = 0; i < batch; ++i)
+            maps.push_back(NoiseMap2D::uninitialized(width, height));
+
+        for (int first = 0; first < frames; first += batch) {
+            const int count = std::min(batch, frames - first);
+            std::vector<float> zs(count);
+            for (int i = 0; i < count; ++i)
+                zs[i] = time0 + static_cast<float>(first + i) * timeStep + base;
+            fill_perlin_slices(generator, width, height, zs, nullptr, scale, base, schedule,
+                [&](std::size_t slice, int y) { return maps[slice].row(y); }, threads);
+            for (int i = 0; i < count; ++i)
+                onFrame(first + i, maps[i]);
         }
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path outFile = outDir / filename;
-        std::string extension = outFile.extension().string();
+    }
+
+    // ---------------------------------------------------------
+    // Cached tile (generated through generate_perlin_region on a miss)
+    // ---------------------------------------------------------
+    TileCache::Tile perlin_tile(
+        TileCache& cache,
+        std::int64_t tileX,
+        std::int64_t tileY,
+        int tileSize,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        int seed,
+        CoordinateMode mode,
+        int threads
+    ) {
+        StatsScope stats("perlin_tile", pixel_count(tileSize, tileSize));
+        const TileKey key = make_tile_key(NoiseType::Perlin, tileX, tileY, tileSize, seed,
+            { scale, static_cast<double>(octaves), frequency, persistence, lacunarity, static_cast<double>(mode) });
+        return cache.get_or_create(key, [&]() {
+            return generate_perlin_region(tile_region(key), scale, octaves, frequency, persistence, lacunarity, seed, mode, threads);
+        });
+    }
 
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    // ---------------------------------------------------------
+    // Save Perlin map to grayscale PNG or JPEG (auto-detected from extension)
+    // ---------------------------------------------------------
+    void save_perlin_image(const NoiseMap2D& noise, const std::string& filename, const std::string& outputDir, int compressionLevel) {
+        StatsScope stats("save_perlin_image", pixel_count(noise.width(), noise.height()));
+        std::filesystem::path outFile = resolve_image_path(filename, outputDir);
+        ImageOptions options;
+        options.compressionLevel = compressionLevel;
+        write_image(noise, outFile, options);
+        std::cout << "[OK] Perlin noise image saved at: " << outFile.string() << "\n";
+    }
 
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outFile.string().c_str(), width, height, 1, imgData.data(), 90);
+    // ---------------------------------------------------------
+    // Generate and save band by band (bounded memory)
+    // ---------------------------------------------------------
+    void stream_perlin_image(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const std::string& filename,
+        const std::string& outputDir,
+        int threads,
+        int compressionLevel
+    ) {
+        StatsScope stats("stream_perlin_image", pixel_count(width, height));
+        if (width <= 0) {
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         }
-        else {
-            // Default to PNG
-            result = stbi_write_png(outFile.string().c_str(), width, height, 1, imgData.data(), width);
+        if (height <= 0) {
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
         }
 
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outFile.string());
-        }
+        // every band must see the same permutation table
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
+        std::filesystem::path outFile = resolve_image_path(filename, outputDir);
+        stream_image(outFile, width, height, [&](int y0, int rows) {
+            return generate_perlin_region(Region{ 0, y0, width, rows, base, base }, scale, octaves, frequency,
+                persistence, lacunarity, seed, CoordinateMode::Float, threads);
+        }, ImageOptions{ 90, compressionLevel, threads });
         std::cout << "[OK] Perlin noise image saved at: " << outFile.string() << "\n";
     }
 
+    // ---------------------------------------------------------
+    // Generate straight into a memory-mapped map file
+    // ---------------------------------------------------------
+    void save_perlin_map_file(
+        const std::string& path,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float frequency,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        SampleFormat format,
+        int threads
+    ) {
+        StatsScope stats("save_perlin_map_file", pixel_count(width, height));
+        if (width <= 0)
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0)
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        validate_fbm(scale, octaves, frequency, persistence, lacunarity);
+
+        // record the seed actually used so the file can be regenerated
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
+
+        MapInfo info;
+        info.type = NoiseType::Perlin;
+        info.seed = seed;
+        info.params = { scale, static_cast<double>(octaves), frequency, persistence, lacunarity, base };
+
+        PerlinNoise generator(seed);
+        MappedMap file = MappedMap::create(path, width, height, format, info);
+        if (format == SampleFormat::Float32) {
+            // fill_perlin writes every sample straight into the mapping
+            Region region{ 0, 0, width, height, base, base };
+            fill_perlin(file.map(), generator, region, scale, octaves, frequency, persistence, lacunarity, CoordinateMode::Float, threads);
+        }
+        else {
+            file.store(generate_perlin_map(width, height, scale, octaves, frequency, persistence, lacunarity, base, seed, threads));
+        }
+        file.flush();
+    }
+
     // ---------------------------------------------------------
     // Wrapper like Python's create_perlinnoise()
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> create_perlinnoise(
+    NoiseMap2D create_perlinnoise(
         int width,
         int height,
         float scale,
@@ -196,6 +1470,7 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
+        StatsScope stats("create_perlinnoise", pixel_count(width, height));
         auto noise = generate_perlin_map(width, height, scale, octaves, frequency, persistence, lacunarity, base, seed);
 
         switch (mode) {
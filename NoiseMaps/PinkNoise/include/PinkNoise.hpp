@@ -2,26 +2,18 @@
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <cstdint>
 #include "Noise.hpp"
+#include "AlignedBuffer.hpp"
+#include "NoiseMap2D.hpp"
+#include "Region.hpp"
+#include "MapFile.hpp"
+#include "TileCache.hpp"
 
 namespace Noise {
 
     enum class OutputMode; // forward declare (Noise.hpp provides def when included in compilation units)
 
-    // aligned buffer RAII wrapper (opaque here, defined in cpp)
-    struct AlignedBuffer {
-        float* data = nullptr;
-        std::size_t size = 0; // number of floats
-        AlignedBuffer() = default;
-        AlignedBuffer(std::size_t n);
-        ~AlignedBuffer();
-        AlignedBuffer(const AlignedBuffer&) = delete;
-        AlignedBuffer& operator=(const AlignedBuffer&) = delete;
-        AlignedBuffer(AlignedBuffer&& other) noexcept;
-        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
-        float* get() noexcept { return data; }
-    };
-
     // PinkNoise generator class (lightweight)
     class PinkNoise {
     public:
@@ -29,40 +21,128 @@ namespace Noise {
         ~PinkNoise() = default;
 
         // low-level method: build single layer white noise into target (contiguously)
-        // width*height sized target
-        void generate_white_layer(float* target, int width, int height, int octaveSeed) const;
+        // width*height sized target. Pixel (x, y) is hash_coords(key, x, y) (see
+        // CoordHash.hpp) with key = octaveSeed, else the generator seed, else random,
+        // so rows are filled on the worker pool with SIMD and a seeded layer is the
+        // same for every thread count and instruction set.
+        void generate_white_layer(float* target, int width, int height, int octaveSeed, int threads = 0) const;
 
         // build integral image (summed-area table) from `src` (size w*h) into `dst` (size (w+1)*(h+1))
         // `dst` layout: (h+1) rows of (w+1) floats; row major
-        static void build_integral(const float* src, float* dst, int width, int height);
+        // Row prefix sums and column sums run in parallel (SIMD row scans with AVX2); the
+        // float table matches a sequential build bit for bit. The double overload
+        // accumulates in double, so box sums stay exact on large maps where float
+        // entries lose the low bits.
+        static void build_integral(const float* src, float* dst, int width, int height, int threads = 0);
+        static void build_integral(const float* src, double* dst, int width, int height, int threads = 0);
 
         // compute box-averages using integral image and write into `out` (contiguous w*h)
         // box defined by integer blockSize (block width/height)
         // top-left anchored boxes  consistent with previous implementation (blocks starting at multiples)
-        static void box_average_from_integral(const float* integral, float* out, int width, int height, int blockSize);
+        static void box_average_from_integral(const float* integral, float* out, int width, int height, int blockSize, int threads = 0);
+        static void box_average_from_integral(const double* integral, float* out, int width, int height, int blockSize, int threads = 0);
 
     private:
         int seed_;
     };
 
     // High-level generator
-    std::vector<std::vector<float>> generate_pink_map(
+    // Each octave averages blockSize x blockSize blocks anchored at the map origin
+    // (clipped at the map edge) once per block and adds the means to every pixel
+    // they cover; memory beyond the result is a few rows per worker.
+    NoiseMap2D generate_pink_map(
         int width,
         int height,
         int octaves = 6,
         float alpha = 1.0f,
         int sampleRate = 44100,
         float amplitude = 1.0f,
-        int seed = -1
+        int seed = -1,
+        int threads = 0     // worker threads, <= 0 = library default (set_thread_count)
+    );
+
+    // Generate a rectangle of an unbounded pink noise world.
+    // White layers are hashed from (seed + octave, world x, world y) and box means
+    // are taken over blocks anchored at world multiples of the block size, so
+    // adjacent regions tile seamlessly. Offsets are rounded to whole pixels.
+    // Values differ from generate_pink_map near its right and bottom edges, where
+    // the map clips its blocks; each octave costs O((w + B) * (h + B)) for block size B.
+    NoiseMap2D generate_pink_region(
+        const Region& region,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        int threads = 0     // worker threads, <= 0 = library default (set_thread_count)
+    );
+
+    // Building blocks of generate_pink_region, for callers that sample the world
+    // at scattered pixels (NoiseGraph::pink). Octave o uses layer key seed + o,
+    // block size pink_block_size(o, sampleRate) and weight blockSize^-alpha.
+    int pink_block_size(int octave, int sampleRate);
+    // Means of the white layer hashed with `key` over the cols x rows world blocks
+    // of blockSize x blockSize pixels starting at block (blockX, blockY), row by
+    // row into `means`. Summed in the order generate_pink_region sums them, so
+    // both give the same values bit for bit.
+    void pink_block_means(std::uint32_t key, std::int64_t blockX, std::int64_t blockY, int cols, int rows,
+        int blockSize, float* means);
+
+    // Square tile (tileX, tileY) of the world through `cache` (see TileCache.hpp);
+    // same pixels as generate_pink_region. The seed must be >= 0.
+    TileCache::Tile pink_tile(
+        TileCache& cache,
+        std::int64_t tileX,
+        std::int64_t tileY,
+        int tileSize,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        int threads = 0
     );
 
     void save_pink_image(
-        const std::vector<std::vector<float>>& noise,
+        const NoiseMap2D& noise,
         const std::string& filename = "pink_noise.png",
-        const std::string& outputDir = ""
+        const std::string& outputDir = "",
+        int compressionLevel = 6    // PNG deflate level in [0, 9] (ignored for JPEG)
+    );
+
+    // Generate and save without holding the map in memory. Rows come from
+    // generate_pink_region (world origin at 0,0), so the image matches that
+    // function rather than generate_pink_map; memory stays at two row bands.
+    void stream_pink_image(
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        const std::string& filename = "pink_noise.png",
+        const std::string& outputDir = "",
+        int threads = 0,
+        int compressionLevel = 6
+    );
+
+    // Generate straight into a memory-mapped map file (see MapFile.hpp); same
+    // values as generate_pink_map for the recorded seed
+    void save_pink_map_file(
+        const std::string& path,
+        int width,
+        int height,
+        int octaves = 6,
+        float alpha = 1.0f,
+        int sampleRate = 44100,
+        float amplitude = 1.0f,
+        int seed = -1,
+        SampleFormat format = SampleFormat::Float32,
+        int threads = 0
     );
 
-    std::vector<std::vector<float>> create_pinknoise(
+    NoiseMap2D create_pinknoise(
         int width,
         int height,
         int octaves = 6,
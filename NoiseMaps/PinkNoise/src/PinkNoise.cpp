@@ -1,387 +1,572 @@
 // PinkNoise.cpp
 #include "PinkNoise.hpp"
 #include "Noise.hpp" // for OutputMode definition
-#include "stb_image_write.h"
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
+#include "CoordHash.hpp"
+#include "ImageWriter.hpp"
+#include "MapFile.hpp"
+#include "Simd.hpp"
 
 #include <random>
 #include <vector>
 #include <cmath>
 #include <algorithm>
-#include <filesystem>
 #include <iostream>
-#include <thread>
-#include <atomic>
 #include <cassert>
 #include <cstring>
-#include <cstdint> // for std::uintptr_t
+#include <type_traits>
 
-#if defined(_MSC_VER)
-#include <malloc.h> // _aligned_malloc / _aligned_free
-#else
-#include <stdlib.h> // posix_memalign, free
-#endif
-
-#if defined(__AVX2__)
+#if RELNO_SIMD_X86
 #include <immintrin.h>
 #endif
 
 namespace Noise {
 
     // -----------------------------
-    // AlignedBuffer implementation
+    // PinkNoise methods
     // -----------------------------
-    AlignedBuffer::AlignedBuffer(std::size_t n) : data(nullptr), size(n) {
-        if (n == 0) return;
+    PinkNoise::PinkNoise(int seed) : seed_(seed) {}
 
-        std::size_t bytes = n * sizeof(float);
+    // Generate white noise into target (contiguous width*height). Hash keyed by octaveSeed.
+    void PinkNoise::generate_white_layer(float* target, int width, int height, int octaveSeed, int threads) const {
+        std::uint32_t key;
+        if (octaveSeed >= 0) key = static_cast<std::uint32_t>(octaveSeed);
+        else if (seed_ >= 0) key = static_cast<std::uint32_t>(seed_);
+        else key = std::random_device{}();
+        TraceSpan span("generate_white_layer", "pink");
+
+        // every pixel is independent: bands of rows run on the pool
+        const int bandRows = rows_per_band(width);
+        const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+        parallel_for(bands, [&](std::size_t band) {
+            const int y0 = static_cast<int>(band) * bandRows;
+            const int y1 = std::min(y0 + bandRows, height);
+            for (int y = y0; y < y1; ++y)
+                hash_row_to_unit(hash_row(key, y), 0, target + static_cast<std::size_t>(y) * width, static_cast<std::size_t>(width));
+        }, threads);
+    }
 
-#if defined(_MSC_VER)
-        // Windows (MSVC): use _aligned_malloc / _aligned_free
-        data = static_cast<float*>(_aligned_malloc(bytes, 64));
-        if (!data) {
-            throw std::bad_alloc();
-        }
-#else
-        // Portable manual alignment for all other compilers (MinGW, Linux, macOS, etc.)
-        const std::size_t alignment = 64;
-
-        // We allocate extra space to:
-        //  - guarantee we can align to `alignment`
-        //  - store the original pointer just before the aligned block
-        std::size_t total = bytes + alignment - 1 + sizeof(void*);
-        void* raw = std::malloc(total);
-        if (!raw) {
-            throw std::bad_alloc();
+    // -----------------------------
+    // Summed-area tables
+    // -----------------------------
+    namespace {
+    #if RELNO_SIMD_X86
+        // AVX2 kernels start at `i`, stop before the tail and return where they stopped
+        RELNO_TARGET_AVX2 int add_row8(float* acc, const float* add, int i, int count) {
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_loadu_ps(add + i)));
+            return i;
         }
 
-        // Find an aligned address inside the allocated block
-        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
-        std::uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
-        void* alignedPtr = reinterpret_cast<void*>(aligned);
+        RELNO_TARGET_AVX2 int add_row4(double* acc, const double* add, int i, int count) {
+            for (; i + 4 <= count; i += 4)
+                _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_loadu_pd(add + i)));
+            return i;
+        }
+    #endif
 
-        // Store the original pointer immediately before the aligned block
-        reinterpret_cast<void**>(alignedPtr)[-1] = raw;
+        // acc[i] += add[i] for i < count
+        void add_row(float* acc, const float* add, int count) {
+            int i = 0;
+    #if RELNO_SIMD_X86
+            if (simd_level() >= SimdLevel::AVX2) i = add_row8(acc, add, i, count);
+    #endif
+            for (; i < count; ++i) acc[i] += add[i];
+        }
 
-        data = static_cast<float*>(alignedPtr);
-#endif
+        void add_row(double* acc, const double* add, int count) {
+            int i = 0;
+    #if RELNO_SIMD_X86
+            if (simd_level() >= SimdLevel::AVX2) i = add_row4(acc, add, i, count);
+    #endif
+            for (; i < count; ++i) acc[i] += add[i];
+        }
 
-        // zero initialize the usable bytes (not the padding)
-        std::memset(data, 0, bytes);
-    }
+    #if RELNO_SIMD_X86
+        // r[i][j] <-> r[j][i] for an 8x8 block of floats
+        RELNO_TARGET_AVX2 inline void transpose8(__m256 r[8]) {
+            __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]), t1 = _mm256_unpackhi_ps(r[0], r[1]);
+            __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]), t3 = _mm256_unpackhi_ps(r[2], r[3]);
+            __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]), t5 = _mm256_unpackhi_ps(r[4], r[5]);
+            __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]), t7 = _mm256_unpackhi_ps(r[6], r[7]);
+            __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+            r[0] = _mm256_permute2f128_ps(s0, s4, 0x20); r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+            r[1] = _mm256_permute2f128_ps(s1, s5, 0x20); r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+            r[2] = _mm256_permute2f128_ps(s2, s6, 0x20); r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+            r[3] = _mm256_permute2f128_ps(s3, s7, 0x20); r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+        }
 
-    AlignedBuffer::~AlignedBuffer() {
-#if defined(_MSC_VER)
-        if (data) {
-            _aligned_free(data);
+        // Inclusive prefix sums of 8 source rows into 8 table rows. Blocks of 8x8 are
+        // transposed so each lane runs one row's sum in the same order as the scalar loop.
+        RELNO_TARGET_AVX2 int scan_rows8(const float* src, std::size_t srcStride, float* dst, std::size_t dstStride, int width, float run[8]) {
+            __m256 sum = _mm256_setzero_ps();
+            __m256 r[8];
+            int x = 0;
+            for (; x + 8 <= width; x += 8) {
+                for (int k = 0; k < 8; ++k) r[k] = _mm256_loadu_ps(src + k * srcStride + x);
+                transpose8(r);
+                for (int k = 0; k < 8; ++k) {
+                    sum = _mm256_add_ps(sum, r[k]);
+                    r[k] = sum;
+                }
+                transpose8(r);
+                for (int k = 0; k < 8; ++k) _mm256_storeu_ps(dst + k * dstStride + x, r[k]);
+            }
+            _mm256_storeu_ps(run, sum);
+            return x;
         }
-#else
-        if (data) {
-            // Recover the original pointer we stashed just before `data`
-            void* raw = reinterpret_cast<void**>(data)[-1];
-            std::free(raw);
+    #endif
+
+        // Row pass: table row y + 1 = [0, prefix sums of source row y]. Column pass:
+        // each table row adds the one above it, in strips of columns. Both passes run
+        // on the pool, and every entry gets the same additions as a sequential build.
+        template <typename T>
+        void build_table(const float* src, T* dst, int width, int height, int threads) {
+            TraceSpan span("build_integral", "pink");
+            const std::size_t iw = static_cast<std::size_t>(width) + 1;
+            std::fill(dst, dst + iw, T(0));
+
+            constexpr int groupRows = 8;
+            const std::size_t groups = static_cast<std::size_t>((height + groupRows - 1) / groupRows);
+            parallel_for(groups, [&](std::size_t g) {
+                const int y0 = static_cast<int>(g) * groupRows;
+                const int y1 = std::min(y0 + groupRows, height);
+                T run[groupRows] = {};
+                int done = 0;
+    #if RELNO_SIMD_X86
+                if constexpr (std::is_same<T, float>::value) {
+                    if (y1 - y0 == groupRows && simd_level() >= SimdLevel::AVX2) {
+                        float lanes[8];
+                        done = scan_rows8(src + static_cast<std::size_t>(y0) * width, static_cast<std::size_t>(width),
+                            dst + (static_cast<std::size_t>(y0) + 1) * iw + 1, iw, width, lanes);
+                        for (int k = 0; k < groupRows; ++k) run[k] = lanes[k];
+                    }
+                }
+    #endif
+                for (int y = y0; y < y1; ++y) {
+                    const float* srcRow = src + static_cast<std::size_t>(y) * width;
+                    T* dstRow = dst + (static_cast<std::size_t>(y) + 1) * iw;
+                    dstRow[0] = T(0); // first column
+                    T rowSum = run[y - y0];
+                    for (int x = done; x < width; ++x) {
+                        rowSum += srcRow[x];
+                        dstRow[x + 1] = rowSum;
+                    }
+                }
+            }, threads);
+
+            // rows depend on each other, columns do not
+            constexpr int stripCols = 1024;
+            const std::size_t strips = (iw + stripCols - 1) / stripCols;
+            parallel_for(strips, [&](std::size_t strip) {
+                const std::size_t x0 = strip * stripCols;
+                const int count = static_cast<int>(std::min<std::size_t>(stripCols, iw - x0));
+                for (int y = 2; y <= height; ++y) {
+                    T* row = dst + static_cast<std::size_t>(y) * iw + x0;
+                    add_row(row, row - iw, count);
+                }
+            }, threads);
         }
-#endif
 
-        data = nullptr;
-        size = 0;
+        // Per-pixel mean of the block holding it; blocks start at multiples of blockSize
+        // and are clipped at the table edge. Bands of rows run on the pool.
+        template <typename T>
+        void box_average_table(const T* integral, float* out, int width, int height, int blockSize, int threads) {
+            TraceSpan span("box_average", "pink");
+            const std::size_t iw = static_cast<std::size_t>(width) + 1;
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+            parallel_for(bands, [&](std::size_t band) {
+                const int rowBegin = static_cast<int>(band) * bandRows;
+                const int rowEnd = std::min(rowBegin + bandRows, height);
+                for (int y = rowBegin; y < rowEnd; ++y) {
+                    // integral coordinates are +1 offset
+                    const std::size_t y1 = static_cast<std::size_t>((y / blockSize) * blockSize);
+                    const std::size_t y2 = static_cast<std::size_t>(std::min(static_cast<int>(y1) + blockSize, height)); // exclusive
+                    float* outRow = out + static_cast<std::size_t>(y) * width;
+                    for (int x = 0; x < width; ++x) {
+                        const std::size_t x1 = static_cast<std::size_t>((x / blockSize) * blockSize);
+                        const std::size_t x2 = static_cast<std::size_t>(std::min(static_cast<int>(x1) + blockSize, width)); // exclusive
+                        // sum = I(y2,x2) - I(y1,x2) - I(y2,x1) + I(y1,x1)
+                        T s = integral[y2 * iw + x2] - integral[y1 * iw + x2] - integral[y2 * iw + x1] + integral[y1 * iw + x1];
+                        T count = static_cast<T>((y2 - y1) * (x2 - x1));
+                        outRow[x] = (count > 0) ? static_cast<float>(s / count) : 0.0f;
+                    }
+                }
+            }, threads);
+        }
+    }
+
+    // Build integral image: dst has dims (height+1) x (width+1). dst is contiguous and must be (width+1)*(height+1) floats.
+    // We keep row0 and col0 as zeros to simplify box sum queries.
+    void PinkNoise::build_integral(const float* src, float* dst, int width, int height, int threads) {
+        build_table(src, dst, width, height, threads);
     }
 
-    // Move constructor
-    AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept {
-        data = other.data;
-        size = other.size;
-        other.data = nullptr;
-        other.size = 0;
+    void PinkNoise::build_integral(const float* src, double* dst, int width, int height, int threads) {
+        build_table(src, dst, width, height, threads);
     }
 
-    // Move assignment
-    AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
-        if (this != &other) {
-            // Free existing buffer
-#if defined(_MSC_VER)
-            if (data) {
-                _aligned_free(data);
-            }
-#else
-            if (data) {
-                void* raw = reinterpret_cast<void**>(data)[-1];
-                std::free(raw);
-            }
-#endif
-            // Steal ownership
-            data = other.data;
-            size = other.size;
-            other.data = nullptr;
-            other.size = 0;
-        }
-        return *this;
+    // Box average using integral image. Writes mean into out (w*h). blockSize >=1.
+    // Here we use top-left anchored blocks: block at (bx,b y) covers [bx, bx+blockSize-1] x [by, by+blockSize-1]
+    // For compatibility with existing behavior we keep same anchoring: blocks start at multiples of blockSize
+    void PinkNoise::box_average_from_integral(const float* integral, float* out, int width, int height, int blockSize, int threads) {
+        box_average_table(integral, out, width, height, blockSize, threads);
     }
 
+    void PinkNoise::box_average_from_integral(const double* integral, float* out, int width, int height, int blockSize, int threads) {
+        box_average_table(integral, out, width, height, blockSize, threads);
+    }
 
     // -----------------------------
-    // PinkNoise methods
+    // High-level generator
     // -----------------------------
-    PinkNoise::PinkNoise(int seed) : seed_(seed) {}
+    namespace {
+        // floor(a / b) for b > 0, also for negative a
+        std::int64_t floor_div(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && a < 0) ? q - 1 : q;
+        }
 
-    // Generate white noise into target (contiguous width*height). RNG seeded by octaveSeed.
-    void PinkNoise::generate_white_layer(float* target, int width, int height, int octaveSeed) const {
-        std::mt19937 rng;
-        if (octaveSeed >= 0) rng.seed(static_cast<unsigned int>(octaveSeed));
-        else if (seed_ >= 0) rng.seed(static_cast<unsigned int>(seed_));
-        else rng.seed(std::random_device{}());
+        // One octave at block resolution: adds weight * (mean of hashed layer `key` over
+        // the blockSize x blockSize block holding each pixel) to `acc`, whose pixel (x, y)
+        // is layer pixel (x0 + x, y0 + y). Blocks are anchored at layer multiples of the
+        // block size. With `clip` they are cut at the edges of acc (generate_pink_map);
+        // without, they extend past them so neighbouring regions agree (generate_pink_region).
+        //
+        // Every layer pixel is hashed and summed once, each block mean is computed once,
+        // and one contribution row per block row is added to each of its output rows, so
+        // no layer or summed-area buffer is needed.
+        void accumulate_block_means(NoiseMap2D& acc, std::uint32_t key, std::int64_t x0, std::int64_t y0,
+            int blockSize, float weight, bool clip, int threads) {
+            StageTimer timer(Stage::Generate);
+            TraceSpan span("block_means", "pink", blockSize);
+            const int width = acc.width();
+            const int height = acc.height();
+            const std::int64_t B = blockSize;
+            const std::int64_t bx0 = floor_div(x0, B), bx1 = floor_div(x0 + width - 1, B);
+            const std::int64_t by0 = floor_div(y0, B), by1 = floor_div(y0 + height - 1, B);
+            const std::size_t blockCols = static_cast<std::size_t>(bx1 - bx0 + 1);
+            const std::size_t blockRows = static_cast<std::size_t>(by1 - by0 + 1);
+
+            // layer pixels that enter the means: acc itself when clipping, whole blocks otherwise
+            const std::int64_t lx0 = clip ? x0 : bx0 * B;
+            const std::int64_t lx1 = clip ? x0 + width : (bx1 + 1) * B;
+            const std::int64_t ly0 = clip ? y0 : by0 * B;
+            const std::int64_t ly1 = clip ? y0 + height : (by1 + 1) * B;
+
+            // Block rows own disjoint output rows
+            parallel_for(blockRows, [&](std::size_t r) {
+                const std::int64_t by = by0 + static_cast<std::int64_t>(r);
+                const std::int64_t rowBegin = std::max(by * B, ly0);
+                const std::int64_t rowEnd = std::min((by + 1) * B, ly1);
+
+                std::vector<float> layer(static_cast<std::size_t>(lx1 - lx0));
+                std::vector<double> sums(blockCols, 0.0);
+                for (std::int64_t ly = rowBegin; ly < rowEnd; ++ly) {
+                    hash_row_to_unit(hash_row(key, ly), lx0, layer.data(), layer.size());
+                    for (std::size_t c = 0; c < blockCols; ++c) {
+                        const std::int64_t bx = bx0 + static_cast<std::int64_t>(c);
+                        const std::int64_t begin = std::max(bx * B, lx0) - lx0;
+                        const std::int64_t end = std::min((bx + 1) * B, lx1) - lx0;
+                        float rowSum = 0.0f;
+                        for (std::int64_t i = begin; i < end; ++i)
+                            rowSum += layer[static_cast<std::size_t>(i)];
+                        sums[c] += rowSum;
+                    }
+                }
 
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+                // block means spread over the output columns they cover
+                std::vector<float> contribution(static_cast<std::size_t>(width));
+                for (std::size_t c = 0; c < blockCols; ++c) {
+                    const std::int64_t bx = bx0 + static_cast<std::int64_t>(c);
+                    const std::int64_t cols = std::min((bx + 1) * B, lx1) - std::max(bx * B, lx0);
+                    const double invArea = 1.0 / (static_cast<double>(rowEnd - rowBegin) * static_cast<double>(cols));
+                    const float value = static_cast<float>(sums[c] * invArea) * weight;
+
+                    const int xBegin = static_cast<int>(std::max<std::int64_t>(bx * B - x0, 0));
+                    const int xEnd = static_cast<int>(std::min<std::int64_t>((bx + 1) * B - x0, width));
+                    std::fill(contribution.begin() + xBegin, contribution.begin() + xEnd, value);
+                }
 
-        int N = width * height;
-        for (int i = 0; i < N; ++i) target[i] = dist(rng);
-    }
+                const int yBegin = static_cast<int>(std::max<std::int64_t>(by * B - y0, 0));
+                const int yEnd = static_cast<int>(std::min<std::int64_t>((by + 1) * B - y0, height));
+                for (int y = yBegin; y < yEnd; ++y)
+                    add_row(acc.row(y), contribution.data(), width);
+            }, threads);
+        }
 
-    // Build integral image: dst has dims (height+1) x (width+1). dst is contiguous and must be (width+1)*(height+1) floats.
-    // We keep row0 and col0 as zeros to simplify box sum queries.
-    void PinkNoise::build_integral(const float* src, float* dst, int width, int height) {
-        int iw = width + 1;
-        int ih = height + 1;
-        // zero first row
-        for (int x = 0; x < iw; ++x) dst[x] = 0.0f;
-
-        for (int y = 1; y < ih; ++y) {
-            float rowSum = 0.0f;
-            dst[y * iw + 0] = 0.0f; // first column
-            const float* srcRow = src + (y - 1) * width;
-            float* dstRow = dst + y * iw;
-            for (int x = 1; x < iw; ++x) {
-                rowSum += srcRow[x - 1];
-                // integral = previous row integral + rowSum
-                dstRow[x] = dstRow[x - iw] + rowSum;
+    #if RELNO_SIMD_X86
+        RELNO_TARGET_AVX2 int normalize_row8(float* acc, float invWeight, float amplitude, int count) {
+            const __m256 invW = _mm256_set1_ps(invWeight);
+            const __m256 ampv = _mm256_set1_ps(amplitude);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 v = _mm256_load_ps(acc + i);
+                v = _mm256_mul_ps(v, invW);
+                v = _mm256_mul_ps(v, ampv);
+                // clamp 0..1
+                v = _mm256_max_ps(zero, _mm256_min_ps(v, one));
+                _mm256_store_ps(acc + i, v);
             }
+            return i;
+        }
+    #endif
+
+        // acc = clamp(acc / totalWeight * amplitude, 0, 1); the scalar tail uses the
+        // same reciprocal as the vector lanes so every SIMD level gives the same map
+        void normalize_pink(NoiseMap2D& accMap, double totalWeight, float amplitude, int threads) {
+            StageTimer timer(Stage::Normalize);
+            TraceSpan span("normalize", "pink");
+            const int width = accMap.width();
+            const int height = accMap.height();
+            const float invW = static_cast<float>(1.0 / totalWeight);
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                for (int y = y0; y < y1; ++y) {
+                    float* acc = accMap.row(y);
+                    int i = 0;
+    #if RELNO_SIMD_X86
+                    if (simd_level() >= SimdLevel::AVX2) i = normalize_row8(acc, invW, amplitude, width);
+    #endif
+                    for (; i < width; ++i)
+                        acc[i] = std::min(1.0f, std::max(0.0f, acc[i] * invW * amplitude));
+                }
+            }, threads);
         }
-    }
 
-    // Box average using integral image. Writes mean into out (w*h). blockSize >=1.
-    // Here we use top-left anchored blocks: block at (bx,b y) covers [bx, bx+blockSize-1] x [by, by+blockSize-1]
-    // For compatibility with existing behavior we keep same anchoring: blocks start at multiples of blockSize
-    void PinkNoise::box_average_from_integral(const float* integral, float* out, int width, int height, int blockSize) {
-        int iw = width + 1;
-        // We'll compute for each block region and fill block with same average to keep legacy visual style
-        // But we implement per-pixel average using the block containing that pixel: compute block start bx = (x/blockSize)*blockSize
-        // This keeps same pattern as previous block-averaging
-        for (int y = 0; y < height; ++y) {
-            int by = (y / blockSize) * blockSize;
-            int ey = std::min(by + blockSize, height);
-            for (int x = 0; x < width; ++x) {
-                int bx = (x / blockSize) * blockSize;
-                int ex = std::min(bx + blockSize, width);
-                // integral coordinates are +1 offset
-                int x1 = bx;
-                int y1 = by;
-                int x2 = ex; // exclusive
-                int y2 = ey; // exclusive
-                // sum = I(y2,x2) - I(y1,x2) - I(y2,x1) + I(y1,x1)
-                float s = integral[y2 * iw + x2] - integral[y1 * iw + x2] - integral[y2 * iw + x1] + integral[y1 * iw + x1];
-                int count = (y2 - y1) * (x2 - x1);
-                out[y * width + x] = (count > 0) ? (s / static_cast<float>(count)) : 0.0f;
+        // Accumulates every octave into `accMap` (zero-filled, rows 64-byte aligned)
+        // and normalizes it in place. Shared by generate_pink_map and the map file writer.
+        // Blocks are anchored at the map origin and clipped at its edges.
+        void fill_pink(NoiseMap2D& accMap, int octaves, float alpha, int sampleRate, float amplitude, int seed, int threads) {
+            double totalWeight = 0.0;
+
+            for (int o = 0; o < octaves; ++o) {
+                const int blockSize = pink_block_size(o, sampleRate);
+
+                // hashed white layer keyed by seed + octave (see PinkNoise::generate_white_layer)
+                const std::uint32_t key = (seed >= 0) ? static_cast<std::uint32_t>(seed) + static_cast<std::uint32_t>(o)
+                                                      : std::random_device{}();
+
+                float weight = 1.0f / std::pow(static_cast<float>(blockSize), alpha);
+                totalWeight += weight;
+
+                TraceSpan span("octave", "pink", o);
+                accumulate_block_means(accMap, key, 0, 0, blockSize, weight, true, threads);
             }
+
+            normalize_pink(accMap, totalWeight, amplitude, threads);
         }
     }
 
-    // -----------------------------
-    // High-level generator
-    // -----------------------------
-    std::vector<std::vector<float>> generate_pink_map(
+    NoiseMap2D generate_pink_map(
         int width,
         int height,
         int octaves,
         float alpha,
         int sampleRate,
         float amplitude,
-        int seed
+        int seed,
+        int threads
     ) {
+        StatsScope stats("generate_pink_map", pixel_count(width, height));
         if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
         if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
         if (alpha < 0.0f) alpha = 0.0f;
         if (amplitude <= 0.0f) amplitude = 1.0f;
         if (sampleRate < 1) sampleRate = 44100;
 
-        // accumulator (contiguous aligned)
-        AlignedBuffer accBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-        float* acc = accBuf.get();
-        std::fill(acc, acc + (width * height), 0.0f);
-
-        // integral image temp buffer size (width+1)*(height+1)
-        AlignedBuffer integralBuf(static_cast<std::size_t>(width + 1) * static_cast<std::size_t>(height + 1));
-        float* integral = integralBuf.get();
+        // accumulator doubles as the returned map (zero-filled, rows 64-byte aligned)
+        NoiseMap2D accMap(width, height);
+        fill_pink(accMap, octaves, alpha, sampleRate, amplitude, seed, threads);
+        return accMap;
+    }
 
-        // white layer buffer
-        AlignedBuffer layerBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-        float* layer = layerBuf.get();
+    // -----------------------------
+    // World-space region generator
+    // -----------------------------
+    NoiseMap2D generate_pink_region(
+        const Region& region,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_pink_region", pixel_count(region.width, region.height));
+        if (region.width <= 0 || region.height <= 0) throw std::invalid_argument("region width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+        if (sampleRate < 1) sampleRate = 44100;
 
-        PinkNoise pn(seed);
+        const std::int64_t x0 = region.x + std::llround(region.offsetX);
+        const std::int64_t y0 = region.y + std::llround(region.offsetY);
+        const std::uint32_t baseKey = static_cast<std::uint32_t>(seed >= 0 ? seed : std::random_device{}());
 
+        NoiseMap2D accMap(region.width, region.height);
         double totalWeight = 0.0;
 
-        // base spacing derived from sampleRate to emulate frequency spacing
-        float baseSpacing = std::max(1.0f, std::sqrt(static_cast<float>(sampleRate) / 44100.0f));
-
-        // threading config
-        unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
-        unsigned int numThreads = std::min<unsigned int>(hw, 8); // conservative cap
-
         for (int o = 0; o < octaves; ++o) {
-            int blockSize = static_cast<int>(std::max(1.0f, baseSpacing * std::pow(2.0f, static_cast<float>(o))));
-            int octaveSeed = (seed >= 0) ? (seed + o) : (-1);
-
-            // 1) generate white layer
-            pn.generate_white_layer(layer, width, height, octaveSeed);
-
-            // 2) build integral image (single-threaded; O(width*height))
-            // integral buffer has (height+1) rows of (width+1) floats
-            // set to 0 at start (constructor zeros buffer)
-            PinkNoise::build_integral(layer, integral, width, height);
-
-            // 3) compute box-average using integral and write into temp 'layer' buffer (reuse layerBuf)
-            // We'll write the averages into a separate aligned buffer 'avgBuf' to avoid race
-            AlignedBuffer avgBuf(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-            float* avg = avgBuf.get();
+            const int blockSize = pink_block_size(o, sampleRate);
+            const std::uint32_t key = baseKey + static_cast<std::uint32_t>(o);
+            const float weight = 1.0f / std::pow(static_cast<float>(blockSize), alpha);
+            totalWeight += weight;
 
-            // We parallelize block-averaging by rows: each thread computes its row range
-            std::vector<std::thread> workers;
-            std::atomic<int> nextRow{ 0 };
+            // Blocks are anchored to world multiples of blockSize, so every block
+            // touching the region is averaged in full and neighbours agree on it.
+            TraceSpan span("octave", "pink", o);
+            accumulate_block_means(accMap, key, x0, y0, blockSize, weight, false, threads);
+        }
 
-            // Replaced old worker lambda compare to last push 
-            auto worker = [&]() {
-                int y;
-                int iw = width + 1;
+        normalize_pink(accMap, totalWeight, amplitude, threads);
+        return accMap;
+    }
 
-                while ((y = nextRow.fetch_add(1, std::memory_order_relaxed)) < height) {
+    int pink_block_size(int octave, int sampleRate) {
+        // base spacing derived from sampleRate to emulate frequency spacing
+        const float baseSpacing = std::max(1.0f, std::sqrt(static_cast<float>(sampleRate) / 44100.0f));
+        return static_cast<int>(std::max(1.0f, baseSpacing * std::pow(2.0f, static_cast<float>(octave))));
+    }
 
-                    int by = (y / blockSize) * blockSize;
-                    int ey = std::min(by + blockSize, height);
+    // Same sums as accumulate_block_means without clipping: float row sums per
+    // block, accumulated in double, scaled by the reciprocal of the block area
+    void pink_block_means(std::uint32_t key, std::int64_t blockX, std::int64_t blockY, int cols, int rows,
+        int blockSize, float* means) {
+        const std::int64_t B = blockSize;
+        const std::size_t columns = static_cast<std::size_t>(cols);
+        const std::size_t width = columns * static_cast<std::size_t>(blockSize);
+        // single blocks (NoiseGraph's scattered samples) stay off the heap
+        float layerSmall[256];
+        double sumsSmall[64];
+        std::vector<float> layerBig;
+        std::vector<double> sumsBig;
+        float* layer = layerSmall;
+        double* sums = sumsSmall;
+        if (width > 256) { layerBig.resize(width); layer = layerBig.data(); }
+        if (columns > 64) { sumsBig.resize(columns); sums = sumsBig.data(); }
+        const double invArea = 1.0 / (static_cast<double>(B) * static_cast<double>(B));
+
+        for (int r = 0; r < rows; ++r) {
+            std::fill(sums, sums + columns, 0.0);
+            for (std::int64_t ly = (blockY + r) * B; ly < (blockY + r + 1) * B; ++ly) {
+                hash_row_to_unit(hash_row(key, ly), blockX * B, layer, width);
+                for (std::size_t c = 0; c < columns; ++c) {
+                    const float* block = layer + c * static_cast<std::size_t>(blockSize);
+                    float rowSum = 0.0f;
+                    for (int i = 0; i < blockSize; ++i) rowSum += block[i];
+                    sums[c] += rowSum;
+                }
+            }
+            for (std::size_t c = 0; c < columns; ++c)
+                means[static_cast<std::size_t>(r) * columns + c] = static_cast<float>(sums[c] * invArea);
+        }
+    }
 
-                    for (int x = 0; x < width; ++x) {
+    // Cached tile, generated through generate_pink_region on a miss
+    TileCache::Tile pink_tile(
+        TileCache& cache,
+        std::int64_t tileX,
+        std::int64_t tileY,
+        int tileSize,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("pink_tile", pixel_count(tileSize, tileSize));
+        const TileKey key = make_tile_key(NoiseType::Pink, tileX, tileY, tileSize, seed,
+            { static_cast<double>(octaves), alpha, static_cast<double>(sampleRate), amplitude });
+        return cache.get_or_create(key, [&]() {
+            return generate_pink_region(tile_region(key), octaves, alpha, sampleRate, amplitude, seed, threads);
+        });
+    }
 
-                        int bx = (x / blockSize) * blockSize;
-                        int ex = std::min(bx + blockSize, width);
-
-                        // +1 offset for integral image
-                        int x1 = bx;
-                        int y1 = by;
-                        int x2 = ex;
-                        int y2 = ey;
-
-                        // summed area table:
-                        // I(y2,x2) - I(y1,x2) - I(y2,x1) + I(y1,x1)
-                        float s =
-                            integral[y2 * iw + x2] -
-                            integral[y1 * iw + x2] -
-                            integral[y2 * iw + x1] +
-                            integral[y1 * iw + x1];
-
-                        int count = (y2 - y1) * (x2 - x1);
-                        avg[y * width + x] = (count > 0) ? (s / count) : 0.0f;
-                    }
-                }
-                };
+    // Save image uses previous utility style: single-channel
+    void save_pink_image(const NoiseMap2D& noise, const std::string& filename, const std::string& outputDir, int compressionLevel) {
+        StatsScope stats("save_pink_image", pixel_count(noise.width(), noise.height()));
+        if (noise.empty()) throw std::invalid_argument("Cannot save empty pink map.");
+        std::filesystem::path file = resolve_image_path(filename, outputDir);
+        write_image(noise, file, ImageOptions{ 95, compressionLevel });
+        std::cout << "[OK] Pink noise saved at: " << file.string() << "\n";
+    }
 
+    // Band-by-band generate + save through generate_pink_region (world origin at 0,0)
+    void stream_pink_image(
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        const std::string& filename,
+        const std::string& outputDir,
+        int threads,
+        int compressionLevel
+    ) {
+        StatsScope stats("stream_pink_image", pixel_count(width, height));
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
 
-            // Replaced thread creation as compare to last push
-            for (unsigned int t = 0; t < numThreads; ++t)
-                workers.emplace_back(worker); // no thread id needed (zero-arg lambda)
-            for (auto& th : workers) th.join();
-                workers.clear();
+        // every band must hash with the same key
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
-            // 4) accumulate with weight: acc += avg * weight
-            float weight = 1.0f / std::pow(static_cast<float>(blockSize), alpha);
-            totalWeight += weight;
+        std::filesystem::path file = resolve_image_path(filename, outputDir);
+        stream_image(file, width, height, [&](int y0, int rows) {
+            return generate_pink_region(Region{ 0, y0, width, rows }, octaves, alpha, sampleRate, amplitude, seed, threads);
+        }, ImageOptions{ 95, compressionLevel, threads });
+        std::cout << "[OK] Pink noise saved at: " << file.string() << "\n";
+    }
 
-            // Vectorized accumulate if AVX2 available
-#if defined(__AVX2__)
-            const int N = width * height;
-            int i = 0;
-            const int step = 8; // 8 floats per __m256
-            __m256 wv = _mm256_set1_ps(weight);
-            for (; i + step <= N; i += step) {
-                __m256 a = _mm256_load_ps(acc + i);
-                __m256 b = _mm256_load_ps(avg + i);
-                __m256 prod = _mm256_mul_ps(b, wv);
-                __m256 sum = _mm256_add_ps(a, prod);
-                _mm256_store_ps(acc + i, sum);
-            }
-            // tail
-            for (; i < N; ++i) acc[i] += avg[i] * weight;
-#else
-            int N = width * height;
-            for (int i = 0; i < N; ++i) acc[i] += avg[i] * weight;
-#endif
-            // avgBuf frees on scope exit
-        }
+    // Generate straight into a memory-mapped map file
+    void save_pink_map_file(
+        const std::string& path,
+        int width,
+        int height,
+        int octaves,
+        float alpha,
+        int sampleRate,
+        float amplitude,
+        int seed,
+        SampleFormat format,
+        int threads
+    ) {
+        StatsScope stats("save_pink_map_file", pixel_count(width, height));
+        if (width <= 0 || height <= 0) throw std::invalid_argument("width/height must be > 0");
+        if (octaves < 1) throw std::invalid_argument("octaves must be >= 1");
+        if (alpha < 0.0f) alpha = 0.0f;
+        if (amplitude <= 0.0f) amplitude = 1.0f;
+        if (sampleRate < 1) sampleRate = 44100;
 
-        // Normalize accumulator by totalWeight and apply amplitude. Vectorize where possible
-        int Npix = width * height;
-#if defined(__AVX2__)
-        int i = 0;
-        __m256 invW = _mm256_set1_ps(static_cast<float>(1.0 / totalWeight));
-        __m256 ampv = _mm256_set1_ps(amplitude);
-        for (; i + 8 <= Npix; i += 8) {
-            __m256 v = _mm256_load_ps(acc + i);
-            v = _mm256_mul_ps(v, invW);
-            v = _mm256_mul_ps(v, ampv);
-            // clamp 0..1
-            __m256 zero = _mm256_setzero_ps();
-            __m256 one = _mm256_set1_ps(1.0f);
-            v = _mm256_max_ps(zero, _mm256_min_ps(v, one));
-            _mm256_store_ps(acc + i, v);
-        }
-        for (; i < Npix; ++i) {
-            float val = acc[i] / static_cast<float>(totalWeight);
-            val = val * amplitude;
-            if (val < 0.0f) val = 0.0f;
-            if (val > 1.0f) val = 1.0f;
-            acc[i] = val;
-        }
-#else
-        for (int i = 0; i < Npix; ++i) {
-            float val = acc[i] / static_cast<float>(totalWeight);
-            val = val * amplitude;
-            if (val < 0.0f) val = 0.0f;
-            if (val > 1.0f) val = 1.0f;
-            acc[i] = val;
-        }
-#endif
+        // record the seed actually used so the file can be regenerated
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
-        // Convert contiguous acc buffer to std::vector<std::vector<float>> for public API
-        std::vector<std::vector<float>> out(height, std::vector<float>(width));
-        for (int y = 0; y < height; ++y) {
-            std::memcpy(out[y].data(), acc + (std::size_t)y * width, sizeof(float) * static_cast<std::size_t>(width));
-        }
-        return out;
-    }
+        MapInfo info;
+        info.type = NoiseType::Pink;
+        info.seed = seed;
+        info.params = { static_cast<double>(octaves), alpha, static_cast<double>(sampleRate), amplitude };
 
-    // Save image uses previous utility style: single-channel
-    void save_pink_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) throw std::invalid_argument("Cannot save empty pink map.");
-        int height = static_cast<int>(noise.size());
-        int width = static_cast<int>(noise[0].size());
-        std::vector<unsigned char> img(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                img[y * width + x] = static_cast<unsigned char>(std::clamp(noise[y][x], 0.0f, 1.0f) * 255.0f);
-        std::filesystem::path outDir =
-    outputDir.empty()
-        ? (std::filesystem::current_path().parent_path() / "ImageOutput")
-        : std::filesystem::path(outputDir);
-
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path file = outDir / filename;
-        std::string ext = file.extension().string();
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-        int res = 0;
-        if (ext == ".jpg" || ext == ".jpeg") res = stbi_write_jpg(file.string().c_str(), width, height, 1, img.data(), 95);
-        else res = stbi_write_png(file.string().c_str(), width, height, 1, img.data(), width);
-        if (res == 0) throw std::runtime_error("Failed to write pink noise image: " + file.string());
-        std::cout << "[OK] Pink noise saved at: " << file.string() << "\n";
+        MappedMap file = MappedMap::create(path, width, height, format, info);
+        if (format == SampleFormat::Float32) fill_pink(file.map(), octaves, alpha, sampleRate, amplitude, seed, threads);
+        else file.store(generate_pink_map(width, height, octaves, alpha, sampleRate, amplitude, seed, threads));
+        file.flush();
     }
 
-    std::vector<std::vector<float>> create_pinknoise(
+    NoiseMap2D create_pinknoise(
         int width,
         int height,
         int octaves,
@@ -393,6 +578,7 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
+        StatsScope stats("create_pinknoise", pixel_count(width, height));
         auto map = generate_pink_map(width, height, octaves, alpha, sampleRate, amplitude, seed);
         if (mode == OutputMode::Image) save_pink_image(map, filename, outputDir);
         return map;
@@ -3,9 +3,19 @@
 #include <random>
 #include <cmath>
 #include <iostream>
-#include <algorithm> // for std::shuffle, std::clamp
-#include <filesystem>
-#include "stb_image_write.h"
+#include <algorithm> // for std::clamp
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "ImageWriter.hpp"
+#include "MapFile.hpp"
+#include "Permutation.hpp"
+#include "Simd.hpp"
+#include "Surface.hpp"
+#include "Fbm.hpp"
+
+#if RELNO_SIMD_X86
+#include <immintrin.h>
+#endif
 
 #ifndef __cpp_lib_clamp
 namespace std {
@@ -22,24 +32,8 @@ namespace Noise {
     // ---------------------------------------------------------
     // Constructor � creates permutation table
     // ---------------------------------------------------------
-    SimplexNoise::SimplexNoise(int seed) {
-        perm.resize(512);
-        std::vector<int> p(256);
-        for (int i = 0; i < 256; ++i)
-            p[i] = i;
-
-        if (seed >= 0) {
-            std::mt19937 rng(seed);
-            std::shuffle(p.begin(), p.end(), rng);
-        }
-        else {
-            std::random_device rd;
-            std::mt19937 rng(rd());
-            std::shuffle(p.begin(), p.end(), rng);
-        }
-
-        for (int i = 0; i < 512; ++i)
-            perm[i] = p[i & 255];
+    SimplexNoise::SimplexNoise(int seed)
+        : perm(permutation_table(seed)) {
     }
 
     // ---------------------------------------------------------
@@ -96,10 +90,1126 @@ namespace Noise {
         return 70.0f * (n0 + n1 + n2);
     }
 
+    // ---------------------------------------------------------
+    // 2D Simplex noise with its analytic gradient
+    // Each corner contributes t^4 * dot(g, d) with t = 0.5 - |d|^2, so
+    // its gradient is t^4 * g - 8 t^3 * dot(g, d) * d. The value is
+    // computed exactly as in noise2D().
+    // ---------------------------------------------------------
+    float SimplexNoise::noise2D_deriv(float xin, float yin, float& dx, float& dy) const {
+        float s = (xin + yin) * F2;
+        int i = static_cast<int>(std::floor(xin + s));
+        int j = static_cast<int>(std::floor(yin + s));
+
+        float t = (i + j) * G2;
+        float X0 = i - t;
+        float Y0 = j - t;
+        float x0 = xin - X0;
+        float y0 = yin - Y0;
+
+        int i1, j1;
+        if (x0 > y0) { i1 = 1; j1 = 0; }
+        else { i1 = 0; j1 = 1; }
+
+        const float xs[3] = { x0, x0 - i1 + G2, x0 - 1.0f + 2.0f * G2 };
+        const float ys[3] = { y0, y0 - j1 + G2, y0 - 1.0f + 2.0f * G2 };
+
+        int ii = i & 255;
+        int jj = j & 255;
+        const int gi[3] = {
+            perm[ii + perm[jj]] % 8,
+            perm[ii + i1 + perm[jj + j1]] % 8,
+            perm[ii + 1 + perm[jj + 1]] % 8 };
+
+        float n[3], cdx[3], cdy[3];
+        for (int c = 0; c < 3; ++c) {
+            n[c] = cdx[c] = cdy[c] = 0.0f;
+            float tc = 0.5f - xs[c] * xs[c] - ys[c] * ys[c];
+            if (tc >= 0.0f) {
+                float t2 = tc * tc;
+                float dot = grad3[gi[c]][0] * xs[c] + grad3[gi[c]][1] * ys[c];
+                float falloff = -8.0f * t2 * tc * dot;
+                n[c] = t2 * t2 * dot;
+                cdx[c] = falloff * xs[c] + t2 * t2 * grad3[gi[c]][0];
+                cdy[c] = falloff * ys[c] + t2 * t2 * grad3[gi[c]][1];
+            }
+        }
+
+        dx = 70.0f * (cdx[0] + cdx[1] + cdx[2]);
+        dy = 70.0f * (cdy[0] + cdy[1] + cdy[2]);
+        return 70.0f * (n[0] + n[1] + n[2]);
+    }
+
+    // ---------------------------------------------------------
+    // 3D / 4D Simplex noise: returns value in [-1, 1]
+    // The simplex containing the point is found by ranking the
+    // offsets from the cell origin (largest axis steps first);
+    // corner gradients come from hash bits like improved Perlin noise.
+    // ---------------------------------------------------------
+    namespace {
+
+        // 12 cube-edge directions picked by the low 4 bits
+        inline float grad3D(int hash, float x, float y, float z) {
+            int h = hash & 15;
+            float u = (h < 8) ? x : y;
+            float v = (h < 4) ? y : ((h == 12 || h == 14) ? x : z);
+            return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+        }
+
+        // 32 directions: bits 3-4 drop one axis, bits 0-2 flip the signs of the other three
+        inline float grad4D(int hash, float x, float y, float z, float w) {
+            int h = hash & 31;
+            int drop = h >> 3;
+            float a = (drop == 0) ? y : x;
+            float b = (drop < 2) ? z : y;
+            float c = (drop == 3) ? z : w;
+            return (((h & 4) ? -a : a) + ((h & 2) ? -b : b)) + ((h & 1) ? -c : c);
+        }
+
+        // (0.6 - |d|^2)^4 falloff; 0 outside the corner's radius
+        inline float falloff(float t) {
+            if (t < 0.0f) return 0.0f;
+            t *= t;
+            return t * t;
+        }
+
+    } // namespace
+
+    float SimplexNoise::noise3D(float xin, float yin, float zin) const {
+        float s = (xin + yin + zin) * F3;
+        int i = static_cast<int>(std::floor(xin + s));
+        int j = static_cast<int>(std::floor(yin + s));
+        int k = static_cast<int>(std::floor(zin + s));
+
+        float t = (i + j + k) * G3;
+        float x0 = xin - (i - t);
+        float y0 = yin - (j - t);
+        float z0 = zin - (k - t);
+
+        // rank of each axis offset: 2 = largest
+        int rx = 0, ry = 0, rz = 0;
+        if (x0 > y0) ++rx; else ++ry;
+        if (x0 > z0) ++rx; else ++rz;
+        if (y0 > z0) ++ry; else ++rz;
+
+        int i1 = rx >= 2, j1 = ry >= 2, k1 = rz >= 2;
+        int i2 = rx >= 1, j2 = ry >= 1, k2 = rz >= 1;
+
+        float x1 = x0 - i1 + G3, y1 = y0 - j1 + G3, z1 = z0 - k1 + G3;
+        float x2 = x0 - i2 + 2.0f * G3, y2 = y0 - j2 + 2.0f * G3, z2 = z0 - k2 + 2.0f * G3;
+        float x3 = x0 - 1.0f + 3.0f * G3, y3 = y0 - 1.0f + 3.0f * G3, z3 = z0 - 1.0f + 3.0f * G3;
+
+        int ii = i & 255;
+        int jj = j & 255;
+        int kk = k & 255;
+        int gi0 = perm[ii + perm[jj + perm[kk]]];
+        int gi1 = perm[ii + i1 + perm[jj + j1 + perm[kk + k1]]];
+        int gi2 = perm[ii + i2 + perm[jj + j2 + perm[kk + k2]]];
+        int gi3 = perm[ii + 1 + perm[jj + 1 + perm[kk + 1]]];
+
+        float n0 = falloff(0.6f - x0 * x0 - y0 * y0 - z0 * z0) * grad3D(gi0, x0, y0, z0);
+        float n1 = falloff(0.6f - x1 * x1 - y1 * y1 - z1 * z1) * grad3D(gi1, x1, y1, z1);
+        float n2 = falloff(0.6f - x2 * x2 - y2 * y2 - z2 * z2) * grad3D(gi2, x2, y2, z2);
+        float n3 = falloff(0.6f - x3 * x3 - y3 * y3 - z3 * z3) * grad3D(gi3, x3, y3, z3);
+
+        // Scale constant for 3D
+        return 32.0f * (((n0 + n1) + n2) + n3);
+    }
+
+    float SimplexNoise::noise4D(float xin, float yin, float zin, float win) const {
+        float s = (xin + yin + zin + win) * F4;
+        int i = static_cast<int>(std::floor(xin + s));
+        int j = static_cast<int>(std::floor(yin + s));
+        int k = static_cast<int>(std::floor(zin + s));
+        int l = static_cast<int>(std::floor(win + s));
+
+        float t = (i + j + k + l) * G4;
+        float x0 = xin - (i - t);
+        float y0 = yin - (j - t);
+        float z0 = zin - (k - t);
+        float w0 = win - (l - t);
+
+        // rank of each axis offset: 3 = largest
+        int rx = 0, ry = 0, rz = 0, rw = 0;
+        if (x0 > y0) ++rx; else ++ry;
+        if (x0 > z0) ++rx; else ++rz;
+        if (x0 > w0) ++rx; else ++rw;
+        if (y0 > z0) ++ry; else ++rz;
+        if (y0 > w0) ++ry; else ++rw;
+        if (z0 > w0) ++rz; else ++rw;
+
+        const int r[4] = { rx, ry, rz, rw };
+        const float d0[4] = { x0, y0, z0, w0 };
+        const int c0[4] = { i & 255, j & 255, k & 255, l & 255 };
+
+        // corner c steps along every axis whose rank is >= 4 - c
+        float n = 0.0f;
+        for (int c = 0; c < 5; ++c) {
+            int step[4];
+            float d[4];
+            for (int a = 0; a < 4; ++a) {
+                step[a] = (r[a] >= 4 - c) ? 1 : 0;
+                d[a] = d0[a] - step[a] + c * G4;
+            }
+            int gi = perm[c0[0] + step[0] + perm[c0[1] + step[1] + perm[c0[2] + step[2] + perm[c0[3] + step[3]]]]];
+            n += falloff(0.6f - d[0] * d[0] - d[1] * d[1] - d[2] * d[2] - d[3] * d[3]) * grad4D(gi, d[0], d[1], d[2], d[3]);
+        }
+
+        // Scale constant for 4D
+        return 27.0f * n;
+    }
+
+    // ---------------------------------------------------------
+    // Periodic 2D Simplex noise: returns value in [-1, 1]
+    // The skewed simplex lattice cannot wrap to an axis-aligned
+    // rectangle, so each axis is mapped onto a circle whose
+    // circumference is its period (in lattice cells) and the point
+    // on the resulting torus is evaluated with noise4D.
+    // ---------------------------------------------------------
+    namespace {
+        // Position u on a circle of circumference `period`
+        inline void torus_axis(double u, int period, float& c, float& s) {
+            const double twoPi = 6.283185307179586;
+            const double angle = u / period * twoPi;
+            const double radius = period / twoPi;
+            c = static_cast<float>(radius * std::cos(angle));
+            s = static_cast<float>(radius * std::sin(angle));
+        }
+    }
+
+    float SimplexNoise::noise2D_periodic(float x, float y, int periodX, int periodY) const {
+        float x0, x1, y0, y1;
+        torus_axis(x, periodX, x0, x1);
+        torus_axis(y, periodY, y0, y1);
+        return noise4D(x0, x1, y0, y1);
+    }
+
+    // ---------------------------------------------------------
+    // Batched SIMD kernels
+    // Mirrors noise2D() operation for operation so every lane is
+    // bit-identical: the x0 > y0 corner choice and the three falloff
+    // tests become masks/blends, gradients come from a register table.
+    // Each level is compiled with its own target attribute and chosen at run
+    // time (Simd.hpp); kernels start at `i`, stop before the tail and return
+    // where they stopped.
+    // ---------------------------------------------------------
+    namespace {
+
+        constexpr float kF2 = SimplexNoise::F2;
+        constexpr float kG2 = SimplexNoise::G2;
+
+#if RELNO_SIMD_X86
+        // One grad3 component (0 = x, 1 = y) as a permute table indexed by gi
+        RELNO_TARGET_AVX2 inline __m256 grad_column8(const float (&grad)[8][2], int c) {
+            return _mm256_setr_ps(grad[0][c], grad[1][c], grad[2][c], grad[3][c],
+                                  grad[4][c], grad[5][c], grad[6][c], grad[7][c]);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 corner8(__m256 gradX, __m256 gradY, __m256i gi, __m256 x, __m256 y) {
+            // t = 0.5 - x*x - y*y; n = (t*t)^2 * dot(grad, (x, y)) when t >= 0, else 0
+            __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+            __m256 inside = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GE_OQ);
+            __m256 gx = _mm256_permutevar8x32_ps(gradX, gi);
+            __m256 gy = _mm256_permutevar8x32_ps(gradY, gi);
+            t = _mm256_mul_ps(t, t);
+            __m256 n = _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_add_ps(_mm256_mul_ps(gx, x), _mm256_mul_ps(gy, y)));
+            return _mm256_and_ps(n, inside);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 simplex8(const int* perm, __m256 gradX, __m256 gradY, __m256 xin, __m256 yin) {
+            const __m256 F2 = _mm256_set1_ps(kF2);
+            const __m256 G2 = _mm256_set1_ps(kG2);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i seven = _mm256_set1_epi32(7);
+
+            __m256 s = _mm256_mul_ps(_mm256_add_ps(xin, yin), F2);
+            __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(xin, s)));
+            __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(yin, s)));
+
+            __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(i, j)), G2);
+            __m256 X0 = _mm256_sub_ps(_mm256_cvtepi32_ps(i), t);
+            __m256 Y0 = _mm256_sub_ps(_mm256_cvtepi32_ps(j), t);
+            __m256 x0 = _mm256_sub_ps(xin, X0);
+            __m256 y0 = _mm256_sub_ps(yin, Y0);
+
+            // lower triangle (x0 > y0): (i1, j1) = (1, 0), otherwise (0, 1)
+            __m256i lower = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+            __m256i i1 = _mm256_and_si256(lower, one);
+            __m256i j1 = _mm256_andnot_si256(lower, one);
+
+            __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2);
+            __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2);
+            const __m256 G2x2 = _mm256_set1_ps(2.0f * kG2);
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, onef), G2x2);
+            __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, onef), G2x2);
+
+            __m256i ii = _mm256_and_si256(i, mask);
+            __m256i jj = _mm256_and_si256(j, mask);
+            __m256i gi0 = _mm256_i32gather_epi32(perm, _mm256_add_epi32(ii, _mm256_i32gather_epi32(perm, jj, 4)), 4);
+            __m256i gi1 = _mm256_i32gather_epi32(perm,
+                _mm256_add_epi32(_mm256_add_epi32(ii, i1), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, j1), 4)), 4);
+            __m256i gi2 = _mm256_i32gather_epi32(perm,
+                _mm256_add_epi32(_mm256_add_epi32(ii, one), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, one), 4)), 4);
+
+            __m256 n0 = corner8(gradX, gradY, _mm256_and_si256(gi0, seven), x0, y0);
+            __m256 n1 = corner8(gradX, gradY, _mm256_and_si256(gi1, seven), x1, y1);
+            __m256 n2 = corner8(gradX, gradY, _mm256_and_si256(gi2, seven), x2, y2);
+            return _mm256_mul_ps(_mm256_set1_ps(70.0f), _mm256_add_ps(_mm256_add_ps(n0, n1), n2));
+        }
+
+        // Same table repeated twice so lane indices 0..15 stay in range
+        RELNO_TARGET_AVX512 inline __m512 grad_column16(const float (&grad)[8][2], int c) {
+            return _mm512_setr_ps(grad[0][c], grad[1][c], grad[2][c], grad[3][c],
+                                  grad[4][c], grad[5][c], grad[6][c], grad[7][c],
+                                  grad[0][c], grad[1][c], grad[2][c], grad[3][c],
+                                  grad[4][c], grad[5][c], grad[6][c], grad[7][c]);
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 corner16(__m512 gradX, __m512 gradY, __m512i gi, __m512 x, __m512 y) {
+            __m512 t = _mm512_sub_ps(_mm512_sub_ps(_mm512_set1_ps(0.5f), _mm512_mul_ps(x, x)), _mm512_mul_ps(y, y));
+            __mmask16 inside = _mm512_cmp_ps_mask(t, _mm512_setzero_ps(), _CMP_GE_OQ);
+            __m512 gx = _mm512_permutexvar_ps(gi, gradX);
+            __m512 gy = _mm512_permutexvar_ps(gi, gradY);
+            t = _mm512_mul_ps(t, t);
+            __m512 n = _mm512_mul_ps(_mm512_mul_ps(t, t), _mm512_add_ps(_mm512_mul_ps(gx, x), _mm512_mul_ps(gy, y)));
+            return _mm512_maskz_mov_ps(inside, n);
+        }
+
+        RELNO_TARGET_AVX512 inline __m512 simplex16(const int* perm, __m512 gradX, __m512 gradY, __m512 xin, __m512 yin) {
+            const __m512 F2 = _mm512_set1_ps(kF2);
+            const __m512 G2 = _mm512_set1_ps(kG2);
+            const __m512i one = _mm512_set1_epi32(1);
+            const __m512i mask = _mm512_set1_epi32(255);
+            const __m512i seven = _mm512_set1_epi32(7);
+
+            __m512 s = _mm512_mul_ps(_mm512_add_ps(xin, yin), F2);
+            __m512i i = _mm512_cvttps_epi32(_mm512_floor_ps(_mm512_add_ps(xin, s)));
+            __m512i j = _mm512_cvttps_epi32(_mm512_floor_ps(_mm512_add_ps(yin, s)));
+
+            __m512 t = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_add_epi32(i, j)), G2);
+            __m512 X0 = _mm512_sub_ps(_mm512_cvtepi32_ps(i), t);
+            __m512 Y0 = _mm512_sub_ps(_mm512_cvtepi32_ps(j), t);
+            __m512 x0 = _mm512_sub_ps(xin, X0);
+            __m512 y0 = _mm512_sub_ps(yin, Y0);
+
+            __mmask16 lower = _mm512_cmp_ps_mask(x0, y0, _CMP_GT_OQ);
+            __m512i i1 = _mm512_maskz_mov_epi32(lower, one);
+            __m512i j1 = _mm512_maskz_mov_epi32(static_cast<__mmask16>(~lower), one);
+
+            __m512 x1 = _mm512_add_ps(_mm512_sub_ps(x0, _mm512_cvtepi32_ps(i1)), G2);
+            __m512 y1 = _mm512_add_ps(_mm512_sub_ps(y0, _mm512_cvtepi32_ps(j1)), G2);
+            const __m512 G2x2 = _mm512_set1_ps(2.0f * kG2);
+            const __m512 onef = _mm512_set1_ps(1.0f);
+            __m512 x2 = _mm512_add_ps(_mm512_sub_ps(x0, onef), G2x2);
+            __m512 y2 = _mm512_add_ps(_mm512_sub_ps(y0, onef), G2x2);
+
+            __m512i ii = _mm512_and_si512(i, mask);
+            __m512i jj = _mm512_and_si512(j, mask);
+            __m512i gi0 = _mm512_i32gather_epi32(_mm512_add_epi32(ii, _mm512_i32gather_epi32(jj, perm, 4)), perm, 4);
+            __m512i gi1 = _mm512_i32gather_epi32(
+                _mm512_add_epi32(_mm512_add_epi32(ii, i1), _mm512_i32gather_epi32(_mm512_add_epi32(jj, j1), perm, 4)), perm, 4);
+            __m512i gi2 = _mm512_i32gather_epi32(
+                _mm512_add_epi32(_mm512_add_epi32(ii, one), _mm512_i32gather_epi32(_mm512_add_epi32(jj, one), perm, 4)), perm, 4);
+
+            __m512 n0 = corner16(gradX, gradY, _mm512_and_si512(gi0, seven), x0, y0);
+            __m512 n1 = corner16(gradX, gradY, _mm512_and_si512(gi1, seven), x1, y1);
+            __m512 n2 = corner16(gradX, gradY, _mm512_and_si512(gi2, seven), x2, y2);
+            return _mm512_mul_ps(_mm512_set1_ps(70.0f), _mm512_add_ps(_mm512_add_ps(n0, n1), n2));
+        }
+
+        RELNO_TARGET_AVX512 std::size_t noise2D_16(const int* perm, const float (&grad)[8][2], const float* x, const float* y, float* out, std::size_t i, std::size_t count) {
+            const __m512 gradX = grad_column16(grad, 0);
+            const __m512 gradY = grad_column16(grad, 1);
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, simplex16(perm, gradX, gradY, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+            return i;
+        }
+
+        RELNO_TARGET_AVX512 std::size_t noise2D_row16(const int* perm, const float (&grad)[8][2], const float* x, float y, float* out, std::size_t i, std::size_t count) {
+            const __m512 gradX = grad_column16(grad, 0);
+            const __m512 gradY = grad_column16(grad, 1);
+            const __m512 vy = _mm512_set1_ps(y);
+            for (; i + 16 <= count; i += 16)
+                _mm512_storeu_ps(out + i, simplex16(perm, gradX, gradY, _mm512_loadu_ps(x + i), vy));
+            return i;
+        }
+
+        // Octave o reads ys + o * yStride: one y per lane (fbm) or one per octave (fbm_row).
+        // Octaves > 0 fixes the octave count at compile time (see Fbm.hpp), 0 reads octaves.
+        template <int Octaves>
+        RELNO_TARGET_AVX512 std::size_t fbm16(const int* perm, const float (&grad)[8][2], const float* xs, std::size_t xStride, const float* ys, std::size_t yStride,
+            bool yPerLane, const float* amplitudes, int octaves, float maxAmp, float* out, std::size_t i, std::size_t count) {
+            const __m512 gradX = grad_column16(grad, 0);
+            const __m512 gradY = grad_column16(grad, 1);
+            const int octaveCount = octave_count<Octaves>(octaves);
+            const __m512 norm = _mm512_set1_ps(maxAmp);
+            const __m512 half = _mm512_set1_ps(0.5f);
+            for (; i + 16 <= count; i += 16) {
+                __m512 acc = _mm512_setzero_ps();
+                for (int o = 0; o < octaveCount; ++o) {
+                    const float* yo = ys + o * yStride;
+                    __m512 vy = yPerLane ? _mm512_loadu_ps(yo + i) : _mm512_set1_ps(*yo);
+                    __m512 n = simplex16(perm, gradX, gradY, _mm512_loadu_ps(xs + o * xStride + i), vy);
+                    acc = _mm512_add_ps(acc, _mm512_mul_ps(n, _mm512_set1_ps(amplitudes[o])));
+                }
+                _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(acc, norm), half), half));
+            }
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise2D_8(const int* perm, const float (&grad)[8][2], const float* x, const float* y, float* out, std::size_t i, std::size_t count) {
+            const __m256 gradX = grad_column8(grad, 0);
+            const __m256 gradY = grad_column8(grad, 1);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, simplex8(perm, gradX, gradY, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise2D_row8(const int* perm, const float (&grad)[8][2], const float* x, float y, float* out, std::size_t i, std::size_t count) {
+            const __m256 gradX = grad_column8(grad, 0);
+            const __m256 gradY = grad_column8(grad, 1);
+            const __m256 vy = _mm256_set1_ps(y);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, simplex8(perm, gradX, gradY, _mm256_loadu_ps(x + i), vy));
+            return i;
+        }
+
+        // Octave o reads ys + o * yStride: one y per lane (fbm) or one per octave (fbm_row)
+        template <int Octaves>
+        RELNO_TARGET_AVX2 std::size_t fbm8(const int* perm, const float (&grad)[8][2], const float* xs, std::size_t xStride, const float* ys, std::size_t yStride,
+            bool yPerLane, const float* amplitudes, int octaves, float maxAmp, float* out, std::size_t i, std::size_t count) {
+            const __m256 gradX = grad_column8(grad, 0);
+            const __m256 gradY = grad_column8(grad, 1);
+            const int octaveCount = octave_count<Octaves>(octaves);
+            const __m256 norm = _mm256_set1_ps(maxAmp);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            for (; i + 8 <= count; i += 8) {
+                __m256 acc = _mm256_setzero_ps();
+                for (int o = 0; o < octaveCount; ++o) {
+                    const float* yo = ys + o * yStride;
+                    __m256 vy = yPerLane ? _mm256_loadu_ps(yo + i) : _mm256_set1_ps(*yo);
+                    __m256 n = simplex8(perm, gradX, gradY, _mm256_loadu_ps(xs + o * xStride + i), vy);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(n, _mm256_set1_ps(amplitudes[o])));
+                }
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(acc, norm), half), half));
+            }
+            return i;
+        }
+        // Value + gradient (see noise2D_deriv): AVX2 only
+        RELNO_TARGET_AVX2 inline __m256 corner_deriv8(__m256 gradX, __m256 gradY, __m256i gi, __m256 x, __m256 y,
+            __m256& dx, __m256& dy) {
+            __m256 t = _mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.5f), _mm256_mul_ps(x, x)), _mm256_mul_ps(y, y));
+            __m256 inside = _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GE_OQ);
+            __m256 gx = _mm256_permutevar8x32_ps(gradX, gi);
+            __m256 gy = _mm256_permutevar8x32_ps(gradY, gi);
+            __m256 t2 = _mm256_mul_ps(t, t);
+            __m256 t4 = _mm256_mul_ps(t2, t2);
+            __m256 dot = _mm256_add_ps(_mm256_mul_ps(gx, x), _mm256_mul_ps(gy, y));
+            __m256 falloff = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(-8.0f), t2), t), dot);
+            dx = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(falloff, x), _mm256_mul_ps(t4, gx)), inside);
+            dy = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(falloff, y), _mm256_mul_ps(t4, gy)), inside);
+            return _mm256_and_ps(_mm256_mul_ps(t4, dot), inside);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 simplex_deriv8(const int* perm, __m256 gradX, __m256 gradY, __m256 xin, __m256 yin,
+            __m256& dx, __m256& dy) {
+            const __m256 F2 = _mm256_set1_ps(kF2);
+            const __m256 G2 = _mm256_set1_ps(kG2);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256i seven = _mm256_set1_epi32(7);
+
+            __m256 s = _mm256_mul_ps(_mm256_add_ps(xin, yin), F2);
+            __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(xin, s)));
+            __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(yin, s)));
+
+            __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(i, j)), G2);
+            __m256 x0 = _mm256_sub_ps(xin, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+            __m256 y0 = _mm256_sub_ps(yin, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+
+            __m256i lower = _mm256_castps_si256(_mm256_cmp_ps(x0, y0, _CMP_GT_OQ));
+            __m256i i1 = _mm256_and_si256(lower, one);
+            __m256i j1 = _mm256_andnot_si256(lower, one);
+
+            __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(i1)), G2);
+            __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(j1)), G2);
+            const __m256 G2x2 = _mm256_set1_ps(2.0f * kG2);
+            const __m256 onef = _mm256_set1_ps(1.0f);
+            __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, onef), G2x2);
+            __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, onef), G2x2);
+
+            __m256i ii = _mm256_and_si256(i, mask);
+            __m256i jj = _mm256_and_si256(j, mask);
+            __m256i gi0 = _mm256_i32gather_epi32(perm, _mm256_add_epi32(ii, _mm256_i32gather_epi32(perm, jj, 4)), 4);
+            __m256i gi1 = _mm256_i32gather_epi32(perm,
+                _mm256_add_epi32(_mm256_add_epi32(ii, i1), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, j1), 4)), 4);
+            __m256i gi2 = _mm256_i32gather_epi32(perm,
+                _mm256_add_epi32(_mm256_add_epi32(ii, one), _mm256_i32gather_epi32(perm, _mm256_add_epi32(jj, one), 4)), 4);
+
+            __m256 dx0, dy0, dx1, dy1, dx2, dy2;
+            __m256 n0 = corner_deriv8(gradX, gradY, _mm256_and_si256(gi0, seven), x0, y0, dx0, dy0);
+            __m256 n1 = corner_deriv8(gradX, gradY, _mm256_and_si256(gi1, seven), x1, y1, dx1, dy1);
+            __m256 n2 = corner_deriv8(gradX, gradY, _mm256_and_si256(gi2, seven), x2, y2, dx2, dy2);
+            const __m256 k = _mm256_set1_ps(70.0f);
+            dx = _mm256_mul_ps(k, _mm256_add_ps(_mm256_add_ps(dx0, dx1), dx2));
+            dy = _mm256_mul_ps(k, _mm256_add_ps(_mm256_add_ps(dy0, dy1), dy2));
+            return _mm256_mul_ps(k, _mm256_add_ps(_mm256_add_ps(n0, n1), n2));
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise2D_row_deriv8(const int* perm, const float (&grad)[8][2], const float* x, float y,
+            float* out, float* dx, float* dy, std::size_t i, std::size_t count) {
+            const __m256 gradX = grad_column8(grad, 0);
+            const __m256 gradY = grad_column8(grad, 1);
+            const __m256 vy = _mm256_set1_ps(y);
+            for (; i + 8 <= count; i += 8) {
+                __m256 ddx, ddy;
+                _mm256_storeu_ps(out + i, simplex_deriv8(perm, gradX, gradY, _mm256_loadu_ps(x + i), vy, ddx, ddy));
+                _mm256_storeu_ps(dx + i, ddx);
+                _mm256_storeu_ps(dy + i, ddy);
+            }
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t fbm_row_deriv8(const int* perm, const float (&grad)[8][2], const float* xs, std::size_t xStride,
+            const float* ys, const float* amplitudes, const float* gradScales, int octaves, float maxAmp,
+            float* out, float* dx, float* dy, std::size_t i, std::size_t count) {
+            const __m256 gradX = grad_column8(grad, 0);
+            const __m256 gradY = grad_column8(grad, 1);
+            const __m256 norm = _mm256_set1_ps(maxAmp);
+            const __m256 half = _mm256_set1_ps(0.5f);
+            for (; i + 8 <= count; i += 8) {
+                __m256 acc = _mm256_setzero_ps();
+                __m256 accX = _mm256_setzero_ps();
+                __m256 accY = _mm256_setzero_ps();
+                for (int o = 0; o < octaves; ++o) {
+                    __m256 ndx, ndy;
+                    __m256 n = simplex_deriv8(perm, gradX, gradY, _mm256_loadu_ps(xs + o * xStride + i), _mm256_set1_ps(ys[o]), ndx, ndy);
+                    const __m256 g = _mm256_set1_ps(gradScales[o]);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(n, _mm256_set1_ps(amplitudes[o])));
+                    accX = _mm256_add_ps(accX, _mm256_mul_ps(ndx, g));
+                    accY = _mm256_add_ps(accY, _mm256_mul_ps(ndy, g));
+                }
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(acc, norm), half), half));
+                _mm256_storeu_ps(dx + i, _mm256_mul_ps(_mm256_div_ps(accX, norm), half));
+                _mm256_storeu_ps(dy + i, _mm256_mul_ps(_mm256_div_ps(accY, norm), half));
+            }
+            return i;
+        }
+
+        // 3D / 4D: AVX2 only (AVX-512 hosts take these as well)
+        constexpr float kF3 = SimplexNoise::F3;
+        constexpr float kG3 = SimplexNoise::G3;
+        constexpr float kF4 = SimplexNoise::F4;
+        constexpr float kG4 = SimplexNoise::G4;
+
+        RELNO_TARGET_AVX2 inline __m256 sign_flip8(__m256 v, __m256i h, int bit) {
+            // (h & bit) ? -v : v
+            __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(bit)), _mm256_set1_epi32(bit));
+            return _mm256_xor_ps(v, _mm256_and_ps(_mm256_castsi256_ps(set), _mm256_set1_ps(-0.0f)));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 grad3D_8(__m256i hash, __m256 x, __m256 y, __m256 z) {
+            __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+            __m256 u = _mm256_blendv_ps(x, y, _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(7))));
+            // h == 12 or 14 <=> (h & 13) == 12
+            __m256i hx = _mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(13)), _mm256_set1_epi32(12));
+            __m256 v = _mm256_blendv_ps(z, x, _mm256_castsi256_ps(hx));
+            v = _mm256_blendv_ps(v, y, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h)));
+            return _mm256_add_ps(sign_flip8(u, h, 1), sign_flip8(v, h, 2));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 grad4D_8(__m256i hash, __m256 x, __m256 y, __m256 z, __m256 w) {
+            __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(31));
+            __m256i drop = _mm256_srli_epi32(h, 3);
+            __m256 a = _mm256_blendv_ps(x, y, _mm256_castsi256_ps(_mm256_cmpeq_epi32(drop, _mm256_setzero_si256())));
+            __m256 b = _mm256_blendv_ps(y, z, _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), drop)));
+            __m256 c = _mm256_blendv_ps(w, z, _mm256_castsi256_ps(_mm256_cmpeq_epi32(drop, _mm256_set1_epi32(3))));
+            return _mm256_add_ps(_mm256_add_ps(sign_flip8(a, h, 4), sign_flip8(b, h, 2)), sign_flip8(c, h, 1));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 falloff8(__m256 t) {
+            // t < 0 -> 0, else t^4
+            t = _mm256_and_ps(t, _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_GE_OQ));
+            t = _mm256_mul_ps(t, t);
+            return _mm256_mul_ps(t, t);
+        }
+
+        // 1 where a > b, else 0
+        RELNO_TARGET_AVX2 inline __m256i greater8(__m256 a, __m256 b) {
+            return _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ)), _mm256_set1_epi32(1));
+        }
+
+        RELNO_TARGET_AVX2 inline __m256i gather8(const int* perm, __m256i index) {
+            return _mm256_i32gather_epi32(perm, index, 4);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 simplex3D_8(const int* perm, __m256 xin, __m256 yin, __m256 zin) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i mask = _mm256_set1_epi32(255);
+            const __m256 G3 = _mm256_set1_ps(kG3);
+
+            __m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(xin, yin), zin), _mm256_set1_ps(kF3));
+            __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(xin, s)));
+            __m256i j = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(yin, s)));
+            __m256i k = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(zin, s)));
+
+            __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_add_epi32(i, j), k)), G3);
+            __m256 x0 = _mm256_sub_ps(xin, _mm256_sub_ps(_mm256_cvtepi32_ps(i), t));
+            __m256 y0 = _mm256_sub_ps(yin, _mm256_sub_ps(_mm256_cvtepi32_ps(j), t));
+            __m256 z0 = _mm256_sub_ps(zin, _mm256_sub_ps(_mm256_cvtepi32_ps(k), t));
+
+            __m256i xy = greater8(x0, y0), xz = greater8(x0, z0), yz = greater8(y0, z0);
+            __m256i rx = _mm256_add_epi32(xy, xz);
+            __m256i ry = _mm256_add_epi32(_mm256_sub_epi32(one, xy), yz);
+            __m256i rz = _mm256_sub_epi32(_mm256_set1_epi32(2), _mm256_add_epi32(xz, yz));
+
+            __m256i ii = _mm256_and_si256(i, mask);
+            __m256i jj = _mm256_and_si256(j, mask);
+            __m256i kk = _mm256_and_si256(k, mask);
+
+            // corner c steps along every axis whose rank is >= 3 - c
+            __m256 n = _mm256_setzero_ps();
+            for (int c = 0; c < 4; ++c) {
+                const __m256i minRank = _mm256_set1_epi32(2 - c); // rank > 2 - c
+                __m256i si = _mm256_and_si256(_mm256_cmpgt_epi32(rx, minRank), one);
+                __m256i sj = _mm256_and_si256(_mm256_cmpgt_epi32(ry, minRank), one);
+                __m256i sk = _mm256_and_si256(_mm256_cmpgt_epi32(rz, minRank), one);
+                const __m256 cG = _mm256_set1_ps(c * kG3);
+                __m256 x = _mm256_add_ps(_mm256_sub_ps(x0, _mm256_cvtepi32_ps(si)), cG);
+                __m256 y = _mm256_add_ps(_mm256_sub_ps(y0, _mm256_cvtepi32_ps(sj)), cG);
+                __m256 z = _mm256_add_ps(_mm256_sub_ps(z0, _mm256_cvtepi32_ps(sk)), cG);
+
+                __m256i gi = gather8(perm, _mm256_add_epi32(_mm256_add_epi32(ii, si),
+                    gather8(perm, _mm256_add_epi32(_mm256_add_epi32(jj, sj),
+                        gather8(perm, _mm256_add_epi32(kk, sk))))));
+                __m256 d = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(x, x)),
+                    _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+                __m256 nc = _mm256_mul_ps(falloff8(d), grad3D_8(gi, x, y, z));
+                n = (c == 0) ? nc : _mm256_add_ps(n, nc);
+            }
+            return _mm256_mul_ps(_mm256_set1_ps(32.0f), n);
+        }
+
+        RELNO_TARGET_AVX2 inline __m256 simplex4D_8(const int* perm, __m256 xin, __m256 yin, __m256 zin, __m256 win) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i mask = _mm256_set1_epi32(255);
+
+            __m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(xin, yin), zin), win), _mm256_set1_ps(kF4));
+            const __m256 in[4] = { xin, yin, zin, win };
+            __m256i cell[4];
+            for (int a = 0; a < 4; ++a)
+                cell[a] = _mm256_cvttps_epi32(_mm256_floor_ps(_mm256_add_ps(in[a], s)));
+
+            __m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(cell[0], cell[1]), cell[2]), cell[3])),
+                _mm256_set1_ps(kG4));
+            __m256 d0[4];
+            __m256i rank[4], base[4];
+            for (int a = 0; a < 4; ++a) {
+                d0[a] = _mm256_sub_ps(in[a], _mm256_sub_ps(_mm256_cvtepi32_ps(cell[a]), t));
+                rank[a] = _mm256_setzero_si256();
+                base[a] = _mm256_and_si256(cell[a], mask);
+            }
+            for (int a = 0; a < 4; ++a)
+                for (int b = a + 1; b < 4; ++b) {
+                    __m256i g = greater8(d0[a], d0[b]);
+                    rank[a] = _mm256_add_epi32(rank[a], g);
+                    rank[b] = _mm256_add_epi32(rank[b], _mm256_sub_epi32(one, g));
+                }
+
+            // corner c steps along every axis whose rank is >= 4 - c
+            __m256 n = _mm256_setzero_ps();
+            for (int c = 0; c < 5; ++c) {
+                const __m256i minRank = _mm256_set1_epi32(3 - c); // rank > 3 - c
+                const __m256 cG = _mm256_set1_ps(c * kG4);
+                __m256i step[4];
+                __m256 d[4];
+                for (int a = 0; a < 4; ++a) {
+                    step[a] = _mm256_and_si256(_mm256_cmpgt_epi32(rank[a], minRank), one);
+                    d[a] = _mm256_add_ps(_mm256_sub_ps(d0[a], _mm256_cvtepi32_ps(step[a])), cG);
+                }
+                __m256i gi = gather8(perm, _mm256_add_epi32(base[3], step[3]));
+                for (int a = 2; a >= 0; --a)
+                    gi = gather8(perm, _mm256_add_epi32(_mm256_add_epi32(base[a], step[a]), gi));
+
+                __m256 r = _mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(d[0], d[0]));
+                for (int a = 1; a < 4; ++a)
+                    r = _mm256_sub_ps(r, _mm256_mul_ps(d[a], d[a]));
+                n = _mm256_add_ps(n, _mm256_mul_ps(falloff8(r), grad4D_8(gi, d[0], d[1], d[2], d[3])));
+            }
+            return _mm256_mul_ps(_mm256_set1_ps(27.0f), n);
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise3D_row8(const int* perm, const float* x, float y, float z, float* out, std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y), vz = _mm256_set1_ps(z);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, simplex3D_8(perm, _mm256_loadu_ps(x + i), vy, vz));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise4D_row8(const int* perm, const float* x, float y, float z, float w, float* out, std::size_t i, std::size_t count) {
+            const __m256 vy = _mm256_set1_ps(y), vz = _mm256_set1_ps(z), vw = _mm256_set1_ps(w);
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, simplex4D_8(perm, _mm256_loadu_ps(x + i), vy, vz, vw));
+            return i;
+        }
+
+        RELNO_TARGET_AVX2 std::size_t noise4D_8(const int* perm, const float* x, const float* y, const float* z, const float* w,
+            float* out, std::size_t i, std::size_t count) {
+            for (; i + 8 <= count; i += 8)
+                _mm256_storeu_ps(out + i, simplex4D_8(perm, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i),
+                    _mm256_loadu_ps(z + i), _mm256_loadu_ps(w + i)));
+            return i;
+        }
+#endif
+
+    } // namespace
+
+    void SimplexNoise::noise2D(const float* x, const float* y, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        const SimdLevel level = simd_level();
+        if (level >= SimdLevel::AVX512) i = noise2D_16(perm.data(), grad3, x, y, out, i, count);
+        if (level >= SimdLevel::AVX2) i = noise2D_8(perm.data(), grad3, x, y, out, i, count);
+#endif
+        // scalar fallback / tail
+        for (; i < count; ++i)
+            out[i] = noise2D(x[i], y[i]);
+    }
+
+    void SimplexNoise::noise2D_row(const float* x, float y, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        const SimdLevel level = simd_level();
+        if (level >= SimdLevel::AVX512) i = noise2D_row16(perm.data(), grad3, x, y, out, i, count);
+        if (level >= SimdLevel::AVX2) i = noise2D_row8(perm.data(), grad3, x, y, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise2D(x[i], y);
+    }
+
+    void SimplexNoise::fbm_row(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+        int octaves, float maxAmp, float* out, std::size_t count) const {
+        // Unrolled instantiations for the usual octave counts
+        dispatch_octaves(octaves, [&](auto unrolled) {
+            constexpr int Octaves = decltype(unrolled)::value;
+            const int octaveCount = octave_count<Octaves>(octaves);
+            std::size_t i = 0;
+#if RELNO_SIMD_X86
+            const SimdLevel level = simd_level();
+            if (level >= SimdLevel::AVX512) i = fbm16<Octaves>(perm.data(), grad3, xs, xStride, ys, 1, false, amplitudes, octaves, maxAmp, out, i, count);
+            if (level >= SimdLevel::AVX2) i = fbm8<Octaves>(perm.data(), grad3, xs, xStride, ys, 1, false, amplitudes, octaves, maxAmp, out, i, count);
+#endif
+            for (; i < count; ++i) {
+                float acc = 0.0f;
+                for (int o = 0; o < octaveCount; ++o)
+                    acc += noise2D(xs[o * xStride + i], ys[o]) * amplitudes[o];
+                out[i] = (acc / maxAmp) * 0.5f + 0.5f;
+            }
+        });
+    }
+
+    void SimplexNoise::fbm(const float* xs, const float* ys, std::size_t stride, const float* amplitudes,
+        int octaves, float maxAmp, float* out, std::size_t count) const {
+        dispatch_octaves(octaves, [&](auto unrolled) {
+            constexpr int Octaves = decltype(unrolled)::value;
+            const int octaveCount = octave_count<Octaves>(octaves);
+            std::size_t i = 0;
+#if RELNO_SIMD_X86
+            const SimdLevel level = simd_level();
+            if (level >= SimdLevel::AVX512) i = fbm16<Octaves>(perm.data(), grad3, xs, stride, ys, stride, true, amplitudes, octaves, maxAmp, out, i, count);
+            if (level >= SimdLevel::AVX2) i = fbm8<Octaves>(perm.data(), grad3, xs, stride, ys, stride, true, amplitudes, octaves, maxAmp, out, i, count);
+#endif
+            for (; i < count; ++i) {
+                float acc = 0.0f;
+                for (int o = 0; o < octaveCount; ++o)
+                    acc += noise2D(xs[o * stride + i], ys[o * stride + i]) * amplitudes[o];
+                out[i] = (acc / maxAmp) * 0.5f + 0.5f;
+            }
+        });
+    }
+
+    void SimplexNoise::noise2D_row_deriv(const float* x, float y, float* out, float* dx, float* dy, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise2D_row_deriv8(perm.data(), grad3, x, y, out, dx, dy, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise2D_deriv(x[i], y, dx[i], dy[i]);
+    }
+
+    void SimplexNoise::fbm_row_deriv(const float* xs, std::size_t xStride, const float* ys, const float* amplitudes,
+        const float* gradScales, int octaves, float maxAmp, float* out, float* dx, float* dy, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2)
+            i = fbm_row_deriv8(perm.data(), grad3, xs, xStride, ys, amplitudes, gradScales, octaves, maxAmp, out, dx, dy, i, count);
+#endif
+        for (; i < count; ++i) {
+            float acc = 0.0f, accX = 0.0f, accY = 0.0f;
+            for (int o = 0; o < octaves; ++o) {
+                float ndx, ndy;
+                float n = noise2D_deriv(xs[o * xStride + i], ys[o], ndx, ndy);
+                acc += n * amplitudes[o];
+                accX += ndx * gradScales[o];
+                accY += ndy * gradScales[o];
+            }
+            out[i] = (acc / maxAmp) * 0.5f + 0.5f;
+            dx[i] = (accX / maxAmp) * 0.5f;
+            dy[i] = (accY / maxAmp) * 0.5f;
+        }
+    }
+
+    void SimplexNoise::noise3D_row(const float* x, float y, float z, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise3D_row8(perm.data(), x, y, z, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise3D(x[i], y, z);
+    }
+
+    void SimplexNoise::noise4D_row(const float* x, float y, float z, float w, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise4D_row8(perm.data(), x, y, z, w, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise4D(x[i], y, z, w);
+    }
+
+    void SimplexNoise::noise4D(const float* x, const float* y, const float* z, const float* w, float* out, std::size_t count) const {
+        std::size_t i = 0;
+#if RELNO_SIMD_X86
+        if (simd_level() >= SimdLevel::AVX2) i = noise4D_8(perm.data(), x, y, z, w, out, i, count);
+#endif
+        for (; i < count; ++i)
+            out[i] = noise4D(x[i], y[i], z[i], w[i]);
+    }
+
+    // ---------------------------------------------------------
+    // Shared multi-octave fill used by the map and region generators
+    // ---------------------------------------------------------
+    namespace {
+
+        void validate_fbm(float scale, int octaves, float persistence, float lacunarity) {
+            if (scale <= 0.0f)
+                throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
+            if (octaves < 1)
+                throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
+            if (persistence < 0.0f || persistence > 1.0f)
+                throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
+            if (lacunarity <= 0.0f)
+                throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+        }
+
+        // Maps a double-precision input point to the equivalent point inside one
+        // lattice period. The permutation table repeats every 256 cells of the
+        // *skewed* grid, so skew, drop whole periods, then unskew.
+        inline void reduce_to_period(double x, double y, float& rx, float& ry) {
+            const double F2d = 0.36602540378443864676;  // (sqrt(3)-1)/2
+            const double G2d = 0.21132486540518711775;  // (3-sqrt(3))/6
+            double s = (x + y) * F2d;
+            double xs = x + s;
+            double ys = y + s;
+            xs -= 256.0 * std::floor(xs / 256.0);
+            ys -= 256.0 * std::floor(ys / 256.0);
+            double t = (xs + ys) * G2d;
+            rx = static_cast<float>(xs - t);
+            ry = static_cast<float>(ys - t);
+        }
+
+        struct FbmSchedule {
+            std::vector<float> amplitudes;
+            std::vector<float> freqs;
+            float maxAmp = 0.0f;
+        };
+
+        FbmSchedule make_schedule(int octaves, float persistence, float lacunarity) {
+            FbmSchedule schedule;
+            schedule.amplitudes.resize(octaves);
+            schedule.freqs.resize(octaves);
+            fbm_schedule(octaves, 1.0f, persistence, lacunarity,
+                schedule.amplitudes.data(), schedule.freqs.data(), schedule.maxAmp);
+            return schedule;
+        }
+
+        // Writes normalized fBm for world pixels (region.x + x, region.y + y) into `noise`
+        void fill_simplex(NoiseMap2D& noise, const SimplexNoise& noiseGen, const Region& region,
+            float scale, int octaves, float persistence, float lacunarity,
+            CoordinateMode mode, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = region.width;
+            const int height = region.height;
+            const bool precise = (mode == CoordinateMode::Precise);
+            const float offX = static_cast<float>(region.offsetX);
+            const float offY = static_cast<float>(region.offsetY);
+
+            // Octave schedule, computed once so every band uses identical values
+            const FbmSchedule schedule = make_schedule(octaves, persistence, lacunarity);
+            const std::vector<float>& amplitudes = schedule.amplitudes;
+            const std::vector<float>& freqs = schedule.freqs;
+            const float maxAmp = schedule.maxAmp;
+
+            // per-octave x coordinates, shared read-only by every band (Float mode;
+            // Precise mode reduces x and y together, per row)
+            std::vector<float> xs;
+            if (!precise) {
+                xs.resize(static_cast<std::size_t>(octaves) * width);
+                for (int o = 0; o < octaves; ++o)
+                    for (int x = 0; x < width; ++x)
+                        xs[static_cast<std::size_t>(o) * width + x] = (static_cast<float>(region.x + x) + offX) / scale * freqs[o];
+            }
+
+            // Split the map into cache-sized row bands evaluated in parallel. Each pixel
+            // depends only on its own coordinates, so the result is bit-identical for
+            // any thread count. Every row is written once: all octaves and the
+            // normalization to [0,1] happen in fbm_row / fbm.
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            // Precise mode reduces x and y per pixel and octave, a span of columns at a time
+            constexpr int spanColumns = 256;
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> ys(octaves);
+                std::vector<float> px, py;
+                if (precise) {
+                    px.resize(static_cast<std::size_t>(octaves) * spanColumns);
+                    py.resize(static_cast<std::size_t>(octaves) * spanColumns);
+                }
+
+                for (int y = y0; y < y1; ++y) {
+                    float* row = noise.row(y);
+                    if (!precise) {
+                        for (int o = 0; o < octaves; ++o)
+                            ys[o] = (static_cast<float>(region.y + y) + offY) / scale * freqs[o];
+                        noiseGen.fbm_row(xs.data(), static_cast<std::size_t>(width), ys.data(), amplitudes.data(),
+                            octaves, maxAmp, row, static_cast<std::size_t>(width));
+                        continue;
+                    }
+
+                    for (int x0 = 0; x0 < width; x0 += spanColumns) {
+                        const int span = std::min(spanColumns, width - x0);
+                        for (int o = 0; o < octaves; ++o) {
+                            const double k = static_cast<double>(freqs[o]) / scale;
+                            const double wy = (static_cast<double>(region.y + y) + region.offsetY) * k;
+                            float* ox = px.data() + static_cast<std::size_t>(o) * spanColumns;
+                            float* oy = py.data() + static_cast<std::size_t>(o) * spanColumns;
+                            for (int x = 0; x < span; ++x)
+                                reduce_to_period((static_cast<double>(region.x + x0 + x) + region.offsetX) * k, wy, ox[x], oy[x]);
+                        }
+                        noiseGen.fbm(px.data(), py.data(), spanColumns, amplitudes.data(), octaves, maxAmp,
+                            row + x0, static_cast<std::size_t>(span));
+                    }
+                }
+            }, threads);
+        }
+
+        // fill_simplex over Region{0, 0, w, h, base, base} in Float mode, plus the
+        // per-pixel gradient of the normalized height
+        void fill_simplex_surface(SurfaceMap& surface, const SimplexNoise& noiseGen, float base, float scale,
+            const FbmSchedule& schedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = surface.height.width();
+            const int height = surface.height.height();
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            // d(noise space) / d(pixel) = freq / scale
+            std::vector<float> gradScales(octaves);
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o) {
+                gradScales[o] = schedule.amplitudes[o] * schedule.freqs[o] / scale;
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] = (static_cast<float>(x) + base) / scale * schedule.freqs[o];
+            }
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> ys(octaves);
+
+                for (int y = y0; y < y1; ++y) {
+                    for (int o = 0; o < octaves; ++o)
+                        ys[o] = (static_cast<float>(y) + base) / scale * schedule.freqs[o];
+                    noiseGen.fbm_row_deriv(xs.data(), static_cast<std::size_t>(width), ys.data(), schedule.amplitudes.data(),
+                        gradScales.data(), octaves, schedule.maxAmp, surface.height.row(y), surface.dx.row(y), surface.dy.row(y),
+                        static_cast<std::size_t>(width));
+                }
+            }, threads);
+        }
+
+        // Writes normalized fBm of noise3D (noise4D when `time` is set) for
+        // zs.size() slices of width x height through rowOut(slice, y). Slice s
+        // sits at z = zs[s] and the fourth axis at *time, both in unscaled world
+        // units (base already added). Slices and row bands are split across
+        // threads together; octaves are accumulated in order, so the result does
+        // not depend on the thread count or the SIMD level.
+        template <class RowOut>
+        void fill_simplex_slices(const SimplexNoise& noiseGen, int width, int height,
+            const std::vector<float>& zs, const float* time, float scale, float base,
+            const FbmSchedule& schedule, RowOut rowOut, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            std::vector<float> xs(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o)
+                for (int x = 0; x < width; ++x)
+                    xs[static_cast<std::size_t>(o) * width + x] = (static_cast<float>(x) + base) / scale * schedule.freqs[o];
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(zs.size() * bands, [&](std::size_t task) {
+                const std::size_t slice = task / bands;
+                const int y0 = static_cast<int>(task % bands) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> octave(width);
+
+                for (int y = y0; y < y1; ++y) {
+                    float* out = rowOut(slice, y);
+                    std::fill(out, out + width, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        const float freq = schedule.freqs[o];
+                        const float ny = (static_cast<float>(y) + base) / scale * freq;
+                        const float nz = zs[slice] / scale * freq;
+                        if (time != nullptr)
+                            noiseGen.noise4D_row(xs.data() + static_cast<std::size_t>(o) * width, ny, nz, *time / scale * freq,
+                                octave.data(), static_cast<std::size_t>(width));
+                        else
+                            noiseGen.noise3D_row(xs.data() + static_cast<std::size_t>(o) * width, ny, nz,
+                                octave.data(), static_cast<std::size_t>(width));
+
+                        const float amplitude = schedule.amplitudes[o];
+                        for (int x = 0; x < width; ++x)
+                            out[x] += octave[x] * amplitude;
+                    }
+                    for (int x = 0; x < width; ++x)
+                        out[x] = (out[x] / schedule.maxAmp) * 0.5f + 0.5f;
+                }
+            }, threads);
+        }
+
+        void validate_extent(int width, int height) {
+            if (width <= 0)
+                throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+            if (height <= 0)
+                throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        }
+
+        NoiseVolume fill_simplex_volume(const SimplexNoise& noiseGen, int width, int height, int depth,
+            const float* time, float scale, float base, const FbmSchedule& schedule, int threads) {
+            NoiseVolume volume = NoiseVolume::uninitialized(width, height, depth);
+            std::vector<float> zs(depth);
+            for (int z = 0; z < depth; ++z)
+                zs[z] = static_cast<float>(z) + base;
+            fill_simplex_slices(noiseGen, width, height, zs, time, scale, base, schedule,
+                [&](std::size_t slice, int y) { return volume.row(y, static_cast<int>(slice)); }, threads);
+            return volume;
+        }
+
+        // Lattice period of an octave: the base period times the octave's
+        // frequency multiplier, rounded so every octave wraps at the tile edge
+        int octave_period(int period, float multiplier) {
+            return std::max(1, static_cast<int>(std::lround(static_cast<double>(period) * multiplier)));
+        }
+
+        // Writes normalized periodic fBm into `noise`: octave o wraps after
+        // octave_period(period, freqs[o]) lattice cells, laid across the map in
+        // each axis (see noise2D_periodic for the torus mapping)
+        void fill_simplex_tileable(NoiseMap2D& noise, const SimplexNoise& noiseGen, int periodX, int periodY,
+            const FbmSchedule& schedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = noise.width();
+            const int height = noise.height();
+            const int octaves = static_cast<int>(schedule.freqs.size());
+
+            // torus coordinates of every column, per octave
+            std::vector<int> periodsY(octaves);
+            std::vector<float> cx(static_cast<std::size_t>(octaves) * width);
+            std::vector<float> sx(static_cast<std::size_t>(octaves) * width);
+            for (int o = 0; o < octaves; ++o) {
+                const int px = octave_period(periodX, schedule.freqs[o]);
+                periodsY[o] = octave_period(periodY, schedule.freqs[o]);
+                for (int x = 0; x < width; ++x) {
+                    const std::size_t k = static_cast<std::size_t>(o) * width + x;
+                    torus_axis(static_cast<double>(x) * px / width, px, cx[k], sx[k]);
+                }
+            }
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                std::vector<float> octave(width), cy(width), sy(width);
+
+                for (int y = y0; y < y1; ++y) {
+                    float* out = noise.row(y);
+                    std::fill(out, out + width, 0.0f);
+                    for (int o = 0; o < octaves; ++o) {
+                        float c, sn;
+                        torus_axis(static_cast<double>(y) * periodsY[o] / height, periodsY[o], c, sn);
+                        std::fill(cy.begin(), cy.end(), c);
+                        std::fill(sy.begin(), sy.end(), sn);
+                        const std::size_t k = static_cast<std::size_t>(o) * width;
+                        noiseGen.noise4D(cx.data() + k, sx.data() + k, cy.data(), sy.data(), octave.data(),
+                            static_cast<std::size_t>(width));
+
+                        const float amplitude = schedule.amplitudes[o];
+                        for (int x = 0; x < width; ++x)
+                            out[x] += octave[x] * amplitude;
+                    }
+                    for (int x = 0; x < width; ++x)
+                        out[x] = (out[x] / schedule.maxAmp) * 0.5f + 0.5f;
+                }
+            }, threads);
+        }
+
+        // Warped fBm (see DomainWarp.hpp): each row evaluates the warp field and
+        // the map at the displaced points in one batched pass, in cache-sized bands
+        void fill_simplex_warped(NoiseMap2D& noise, const SimplexNoise& noiseGen, const SimplexNoise& field, float base, float scale,
+            const FbmSchedule& schedule, const DomainWarp& warp, const FbmSchedule& warpSchedule, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int width = noise.width();
+            const int height = noise.height();
+            const FbmLayer map{ schedule.amplitudes.data(), schedule.freqs.data(),
+                static_cast<int>(schedule.freqs.size()), schedule.maxAmp, scale };
+            const FbmLayer warpLayer{ warpSchedule.amplitudes.data(), warpSchedule.freqs.data(),
+                static_cast<int>(warpSchedule.freqs.size()), warpSchedule.maxAmp, warp.scale };
+            const int maxOctaves = std::max(map.octaves, warpLayer.octaves);
+
+            // unwarped pixel coordinates, as generate_simplex_map forms them
+            std::vector<float> px(width);
+            for (int x = 0; x < width; ++x)
+                px[x] = static_cast<float>(x) + base;
+
+            const int bandRows = rows_per_band(width);
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int y0 = static_cast<int>(band) * bandRows;
+                const int y1 = std::min(y0 + bandRows, height);
+                WarpScratch scratch(width, maxOctaves);
+                for (int y = y0; y < y1; ++y)
+                    warped_fbm_row(noiseGen, map, field, warpLayer, warp, px.data(), static_cast<float>(y) + base,
+                        noise.row(y), width, scratch);
+            }, threads);
+        }
+
+    } // namespace
+
     // ---------------------------------------------------------
     // Multi-octave Simplex map generator
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> generate_simplex_map(
+    NoiseMap2D generate_simplex_map(
         int width,
         int height,
         float scale,
@@ -107,102 +1217,371 @@ namespace Noise {
         float persistence,
         float lacunarity,
         float base,
-        int seed
+        int seed,
+        int threads
     ) {
+        StatsScope stats("generate_simplex_map", pixel_count(width, height));
         // Validate parameters
         if (width <= 0)
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         if (height <= 0)
             throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
-        if (scale <= 0.0f)
-            throw std::invalid_argument("scale must be > 0, got: " + std::to_string(scale));
-        if (octaves < 1)
-            throw std::invalid_argument("octaves must be >= 1, got: " + std::to_string(octaves));
-        if (persistence < 0.0f || persistence > 1.0f)
-            throw std::invalid_argument("persistence must be in [0,1], got: " + std::to_string(persistence));
-        if (lacunarity <= 0.0f)
-            throw std::invalid_argument("lacunarity must be > 0, got: " + std::to_string(lacunarity));
+        validate_fbm(scale, octaves, persistence, lacunarity);
 
         SimplexNoise noiseGen(seed);
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width, 0.0f));
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        Region region{ 0, 0, width, height, base, base };
+        fill_simplex(noise, noiseGen, region, scale, octaves, persistence, lacunarity, CoordinateMode::Float, threads);
+        return noise;
+    }
 
-        float amplitude = 1.0f;
-        float maxAmp = 0.0f;
-        float frequency = 1.0f;
+    // ---------------------------------------------------------
+    // World-space region generator (seamless chunks)
+    // ---------------------------------------------------------
+    NoiseMap2D generate_simplex_region(
+        const Region& region,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        int seed,
+        CoordinateMode mode,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_region", pixel_count(region.width, region.height));
+        if (region.width <= 0)
+            throw std::invalid_argument("region width must be > 0, got: " + std::to_string(region.width));
+        if (region.height <= 0)
+            throw std::invalid_argument("region height must be > 0, got: " + std::to_string(region.height));
+        validate_fbm(scale, octaves, persistence, lacunarity);
 
-        for (int o = 0; o < octaves; ++o) {
-            for (int y = 0; y < height; ++y) {
-                for (int x = 0; x < width; ++x) {
-                    float nx = (x + base) / scale * frequency;
-                    float ny = (y + base) / scale * frequency;
-                    noise[y][x] += noiseGen.noise2D(nx, ny) * amplitude;
-                }
-            }
-            maxAmp += amplitude;
-            amplitude *= persistence;
-            frequency *= lacunarity;
-        }
+        SimplexNoise noiseGen(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(region.width, region.height);
+        fill_simplex(noise, noiseGen, region, scale, octaves, persistence, lacunarity, mode, threads);
+        return noise;
+    }
 
-        // Normalize to [0,1]
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                noise[y][x] = (noise[y][x] / maxAmp) * 0.5f + 0.5f;
+    // ---------------------------------------------------------
+    // Height map with analytic gradient (normal maps)
+    // ---------------------------------------------------------
+    SurfaceMap generate_simplex_surface(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_surface", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, persistence, lacunarity);
+
+        SimplexNoise noiseGen(seed);
+        SurfaceMap surface{ NoiseMap2D::uninitialized(width, height), NoiseMap2D::uninitialized(width, height),
+            NoiseMap2D::uninitialized(width, height) };
+        fill_simplex_surface(surface, noiseGen, base, scale, make_schedule(octaves, persistence, lacunarity), threads);
+        return surface;
+    }
+
+    // ---------------------------------------------------------
+    // Seamlessly tiling map generator
+    // ---------------------------------------------------------
+    NoiseMap2D generate_simplex_tileable(
+        int width,
+        int height,
+        int periodX,
+        int periodY,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_tileable", pixel_count(width, height));
+        validate_extent(width, height);
+        if (periodX <= 0)
+            throw std::invalid_argument("periodX must be > 0, got: " + std::to_string(periodX));
+        if (periodY <= 0)
+            throw std::invalid_argument("periodY must be > 0, got: " + std::to_string(periodY));
+        // the scale follows from the map size and the periods
+        validate_fbm(1.0f, octaves, persistence, lacunarity);
 
+        SimplexNoise noiseGen(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_simplex_tileable(noise, noiseGen, periodX, periodY,
+            make_schedule(octaves, persistence, lacunarity), threads);
+        return noise;
+    }
+
+    NoiseMap2D generate_simplex_warped(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        const DomainWarp& warp,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_warped", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, persistence, lacunarity);
+        validate_fbm(warp.scale, warp.octaves, warp.persistence, warp.lacunarity);
+        if (warp.levels < 1)
+            throw std::invalid_argument("warp levels must be >= 1, got: " + std::to_string(warp.levels));
+
+        SimplexNoise noiseGen(seed);
+        SimplexNoise field(warp_seed(warp, seed));
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_simplex_warped(noise, noiseGen, field, base, scale, make_schedule(octaves, persistence, lacunarity),
+            warp, make_schedule(warp.octaves, warp.persistence, warp.lacunarity), threads);
         return noise;
     }
 
     // ---------------------------------------------------------
-    // Save as grayscale PNG or JPEG (auto-detected from extension)
+    // Volumes and animation frames (3D / 4D noise)
     // ---------------------------------------------------------
-    void save_simplex_image(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) {
-            throw std::invalid_argument("Cannot save empty noise map.");
-        }
+    NoiseVolume generate_simplex_volume(
+        int width,
+        int height,
+        int depth,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_volume", pixel_count(width, height, depth));
+        validate_extent(width, height);
+        if (depth <= 0)
+            throw std::invalid_argument("depth must be > 0, got: " + std::to_string(depth));
+        validate_fbm(scale, octaves, persistence, lacunarity);
 
-        int height = noise.size();
-        int width = noise[0].size();
+        SimplexNoise noiseGen(seed);
+        return fill_simplex_volume(noiseGen, width, height, depth, nullptr, scale, base,
+            make_schedule(octaves, persistence, lacunarity), threads);
+    }
 
-        std::vector<unsigned char> img(width * height);
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                img[y * width + x] = static_cast<unsigned char>(std::clamp(noise[y][x], 0.0f, 1.0f) * 255.0f);
+    NoiseVolume generate_simplex_volume_frame(
+        int width,
+        int height,
+        int depth,
+        float time,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_volume_frame", pixel_count(width, height, depth));
+        validate_extent(width, height);
+        if (depth <= 0)
+            throw std::invalid_argument("depth must be > 0, got: " + std::to_string(depth));
+        validate_fbm(scale, octaves, persistence, lacunarity);
 
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
-        }
-        else {
-            outDir = outputDir;
+        SimplexNoise noiseGen(seed);
+        const float w = time + base;
+        return fill_simplex_volume(noiseGen, width, height, depth, &w, scale, base,
+            make_schedule(octaves, persistence, lacunarity), threads);
+    }
+
+    NoiseMap2D generate_simplex_frame(
+        int width,
+        int height,
+        float time,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        int threads
+    ) {
+        StatsScope stats("generate_simplex_frame", pixel_count(width, height));
+        validate_extent(width, height);
+        validate_fbm(scale, octaves, persistence, lacunarity);
+
+        SimplexNoise noiseGen(seed);
+        NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+        fill_simplex_slices(noiseGen, width, height, { time + base }, nullptr, scale, base,
+            make_schedule(octaves, persistence, lacunarity),
+            [&](std::size_t, int y) { return noise.row(y); }, threads);
+        return noise;
+    }
+
+    void stream_simplex_frames(
+        int width,
+        int height,
+        int frames,
+        float time0,
+        float timeStep,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const FrameCallback& onFrame,
+        int threads
+    ) {
+        StatsScope stats("stream_simplex_frames", pixel_count(width, height, frames));
+        validate_extent(width, height);
+        if (frames < 0)
+            throw std::invalid_argument("frames must be >= 0, got: " + std::to_string(frames));
+        validate_fbm(scale, octaves, persistence, lacunarity);
+        if (!onFrame)
+            throw std::invalid_argument("onFrame callback must not be empty");
+
+        SimplexNoise noiseGen(seed);
+        const FbmSchedule schedule = make_schedule(octaves, persistence, lacunarity);
+
+        // One frame per worker per batch; the maps are reused across batches
+        const int batch = std::min(frames, static_cast<int>(resolve_thread_count(threads)));
+        std::vector<NoiseMap2D> maps;
+        for (int i = 0; i < batch; ++i)
+            maps.push_back(NoiseMap2D::uninitialized(width, height));
+
+        for (int first = 0; first < frames; first += batch) {
+            const int count = std::min(batch, frames - first);
+            std::vector<float> zs(count);
+            for (int i = 0; i < count; ++i)
+                zs[i] = time0 + static_cast<float>(first + i) * timeStep + base;
+            fill_simplex_slices(noiseGen, width, height, zs, nullptr, scale, base, schedule,
+                [&](std::size_t slice, int y) { return maps[slice].row(y); }, threads);
+            for (int i = 0; i < count; ++i)
+                onFrame(first + i, maps[i]);
         }
-        std::filesystem::create_directories(outDir);
-        std::filesystem::path outputFile = outDir / filename;
-        std::string extension = outputFile.extension().string();
+    }
+
+    // ---------------------------------------------------------
+    // Cached tile (generated through generate_simplex_region on a miss)
+    // ---------------------------------------------------------
+    TileCache::Tile simplex_tile(
+        TileCache& cache,
+        std::int64_t tileX,
+        std::int64_t tileY,
+        int tileSize,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        int seed,
+        CoordinateMode mode,
+        int threads
+    ) {
+        StatsScope stats("simplex_tile", pixel_count(tileSize, tileSize));
+        const TileKey key = make_tile_key(NoiseType::Simplex, tileX, tileY, tileSize, seed,
+            { scale, static_cast<double>(octaves), persistence, lacunarity, static_cast<double>(mode) });
+        return cache.get_or_create(key, [&]() {
+            return generate_simplex_region(tile_region(key), scale, octaves, persistence, lacunarity, seed, mode, threads);
+        });
+    }
 
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    // ---------------------------------------------------------
+    // Save as grayscale PNG or JPEG (auto-detected from extension)
+    // ---------------------------------------------------------
+    void save_simplex_image(const NoiseMap2D& noise, const std::string& filename, const std::string& outputDir, int compressionLevel) {
+        StatsScope stats("save_simplex_image", pixel_count(noise.width(), noise.height()));
+        std::filesystem::path outputFile = resolve_image_path(filename, outputDir);
+        ImageOptions options;
+        options.compressionLevel = compressionLevel;
+        write_image(noise, outputFile, options);
+        std::cout << "[OK] Simplex noise image saved at: " << outputFile.string() << "\n";
+    }
 
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outputFile.string().c_str(), width, height, 1, img.data(), 90);
+    // ---------------------------------------------------------
+    // Generate and save band by band (bounded memory)
+    // ---------------------------------------------------------
+    void stream_simplex_image(
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        const std::string& filename,
+        const std::string& outputDir,
+        int threads,
+        int compressionLevel
+    ) {
+        StatsScope stats("stream_simplex_image", pixel_count(width, height));
+        if (width <= 0) {
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         }
-        else {
-            // Default to PNG
-            result = stbi_write_png(outputFile.string().c_str(), width, height, 1, img.data(), width);
+        if (height <= 0) {
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
         }
 
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outputFile.string());
-        }
+        // every band must see the same permutation table
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
+        std::filesystem::path outputFile = resolve_image_path(filename, outputDir);
+        stream_image(outputFile, width, height, [&](int y0, int rows) {
+            return generate_simplex_region(Region{ 0, y0, width, rows, base, base }, scale, octaves,
+                persistence, lacunarity, seed, CoordinateMode::Float, threads);
+        }, ImageOptions{ 90, compressionLevel, threads });
         std::cout << "[OK] Simplex noise image saved at: " << outputFile.string() << "\n";
     }
 
+    // ---------------------------------------------------------
+    // Generate straight into a memory-mapped map file
+    // ---------------------------------------------------------
+    void save_simplex_map_file(
+        const std::string& path,
+        int width,
+        int height,
+        float scale,
+        int octaves,
+        float persistence,
+        float lacunarity,
+        float base,
+        int seed,
+        SampleFormat format,
+        int threads
+    ) {
+        StatsScope stats("save_simplex_map_file", pixel_count(width, height));
+        if (width <= 0)
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        if (height <= 0)
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        validate_fbm(scale, octaves, persistence, lacunarity);
+
+        // record the seed actually used so the file can be regenerated
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
+
+        MapInfo info;
+        info.type = NoiseType::Simplex;
+        info.seed = seed;
+        info.params = { scale, static_cast<double>(octaves), persistence, lacunarity, base };
+
+        SimplexNoise noiseGen(seed);
+        MappedMap file = MappedMap::create(path, width, height, format, info);
+        if (format == SampleFormat::Float32) {
+            // fill_simplex writes every sample straight into the mapping
+            Region region{ 0, 0, width, height, base, base };
+            fill_simplex(file.map(), noiseGen, region, scale, octaves, persistence, lacunarity, CoordinateMode::Float, threads);
+        }
+        else {
+            file.store(generate_simplex_map(width, height, scale, octaves, persistence, lacunarity, base, seed, threads));
+        }
+        file.flush();
+    }
+
     // ---------------------------------------------------------
     // Wrapper � same API pattern as others
     // ---------------------------------------------------------
-    std::vector<std::vector<float>> create_simplexnoise(
+    NoiseMap2D create_simplexnoise(
         int width,
         int height,
         float scale,
@@ -215,6 +1594,7 @@ namespace Noise {
         const std::string& filename,
         const std::string& outputDir
     ) {
+        StatsScope stats("create_simplexnoise", pixel_count(width, height));
         auto noise = generate_simplex_map(width, height, scale, octaves, persistence, lacunarity, base, seed);
 
         switch (mode) {
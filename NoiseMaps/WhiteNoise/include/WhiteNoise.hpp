@@ -6,12 +6,17 @@
 // ---------------
 // #include "WhiteNoise.hpp"
 // auto noise = Noise::WhiteNoise::generate(512, 512, 42);
+// auto mask  = Noise::WhiteNoise::generate(4096, 4096, 42, Noise::WhiteNoise::Mode::Counter);
 // Noise::WhiteNoise::save(noise, "white_noise.png");
 //
 
 #pragma once
 #include <vector>
 #include <string>
+#include "NoiseMap2D.hpp"
+#include "Region.hpp"
+#include "MapFile.hpp"
+#include "TileCache.hpp"
 
 namespace Noise {
 
@@ -20,18 +25,53 @@ namespace Noise {
 
     class WhiteNoise {
     public:
-        static std::vector<std::vector<float>> generate(int width, int height, int seed = -1);
-        static void show(const std::vector<std::vector<float>>& noise);
+        // How pixel values are drawn
+        enum class Mode {
+            // std::mt19937 in row-major order (the original output; single-threaded)
+            Sequential,
+            // counter-based: each pixel is a hash of (seed, x, y), so the map is
+            // filled with SIMD on every pool thread and any pixel or region can
+            // be produced on its own. Same values as generate_region.
+            Counter
+        };
+
+        static NoiseMap2D generate(int width, int height, int seed = -1,
+            Mode mode = Mode::Sequential, int threads = 0);
+
+        // Generate a rectangle of an unbounded white noise world. Every pixel is a
+        // hash of (seed, world x, world y), so regions tile seamlessly and any pixel
+        // can be recomputed on its own. Offsets are rounded to whole pixels.
+        // Matches generate(..., Mode::Counter) for Region{0, 0, width, height}.
+        static NoiseMap2D generate_region(const Region& region, int seed = -1, int threads = 0);
+
+        // Square tile (tileX, tileY) of the hashed world through `cache` (see
+        // TileCache.hpp); same pixels as generate_region. The seed must be >= 0.
+        static TileCache::Tile tile(TileCache& cache, std::int64_t tileX, std::int64_t tileY, int tileSize, int seed);
+        static void show(const NoiseMap2D& noise);
 
         // Save to grayscale PNG or JPEG (auto-detected from extension)
         // If outputDir is empty, uses default ImageOutput/ directory
-        static void save(const std::vector<std::vector<float>>& noise,
+        // compressionLevel: PNG deflate level in [0, 9] (ignored for JPEG)
+        static void save(const NoiseMap2D& noise,
             const std::string& filename = "white_noise.png",
-            const std::string& outputDir = "");
+            const std::string& outputDir = "",
+            int compressionLevel = 6);
+
+        // Generate and save without holding the map: rows come from generate_region
+        // (world origin at 0,0) and are encoded band by band with bounded memory.
+        static void stream(int width, int height, int seed = -1,
+            const std::string& filename = "white_noise.png",
+            const std::string& outputDir = "",
+            int compressionLevel = 6);
+
+        // Generate straight into a memory-mapped map file (see MapFile.hpp);
+        // same values as generate() for the recorded seed and mode (params[0])
+        static void save_map_file(const std::string& path, int width, int height, int seed = -1,
+            SampleFormat format = SampleFormat::Float32, Mode mode = Mode::Sequential, int threads = 0);
     };
 
     // Wrapper
-    std::vector<std::vector<float>> create_whitenoise(
+    NoiseMap2D create_whitenoise(
         int width = 256,
         int height = 256,
         int seed = -1,
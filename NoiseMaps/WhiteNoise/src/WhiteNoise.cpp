@@ -2,17 +2,58 @@
 #include "Noise.hpp"  // giving full OutputMode definition
 #include <iostream>
 #include <random>
-#include <algorithm>  // for std::transform
-#include "stb_image_write.h"
-#include <filesystem>
+#include <algorithm>
+#include "CoordHash.hpp"
+#include "Parallel.hpp"
+#include "Stats.hpp"
+#include "ImageWriter.hpp"
+#include "MapFile.hpp"
+#include <cmath>
 
 
 namespace Noise {
 
+    namespace {
+        // Sequential RNG fill shared by generate() and save_map_file()
+        void fill_white(NoiseMap2D& noise, int seed) {
+            StageTimer timer(Stage::Generate);
+            std::mt19937 rng(seed >= 0 ? seed : std::random_device{}());
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+            for (int y = 0; y < noise.height(); ++y) {
+                float* row = noise.row(y);
+                for (int x = 0; x < noise.width(); ++x)
+                    row[x] = dist(rng);
+            }
+        }
+
+        // Counter-based fill: world pixel (x0 + x, y0 + y) of the hashed layer.
+        // Rows are independent, so bands run in parallel with identical results.
+        void fill_hashed(NoiseMap2D& noise, std::uint32_t key, std::int64_t x0, std::int64_t y0, int threads) {
+            StageTimer timer(Stage::Generate);
+            const int height = noise.height();
+            const std::size_t width = static_cast<std::size_t>(noise.width());
+            const int bandRows = rows_per_band(noise.width());
+            const std::size_t bands = static_cast<std::size_t>((height + bandRows - 1) / bandRows);
+
+            parallel_for(bands, [&](std::size_t band) {
+                const int yBegin = static_cast<int>(band) * bandRows;
+                const int yEnd = std::min(yBegin + bandRows, height);
+                for (int y = yBegin; y < yEnd; ++y)
+                    hash_row_to_unit(hash_row(key, y0 + y), x0, noise.row(y), width);
+            }, threads);
+        }
+
+        std::uint32_t hash_key(int seed) {
+            return static_cast<std::uint32_t>(seed >= 0 ? seed : std::random_device{}());
+        }
+    }
+
     // -------------------------------------------------------------
-    // Generate white noise: returns a 2D vector of floats [0,1]
+    // Generate white noise: returns a 2D map of floats [0,1]
     // -------------------------------------------------------------
-    std::vector<std::vector<float>> WhiteNoise::generate(int width, int height, int seed) {
+    NoiseMap2D WhiteNoise::generate(int width, int height, int seed, Mode mode, int threads) {
+        StatsScope stats("WhiteNoise::generate", pixel_count(width, height));
         // Validate parameters
         if (width <= 0) {
             throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
@@ -21,31 +62,57 @@ namespace Noise {
             throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
         }
 
-        std::vector<std::vector<float>> noise(height, std::vector<float>(width));
+        if (mode == Mode::Counter) {
+            NoiseMap2D noise = NoiseMap2D::uninitialized(width, height);
+            fill_hashed(noise, hash_key(seed), 0, 0, threads);
+            return noise;
+        }
+
+        NoiseMap2D noise(width, height);
+        fill_white(noise, seed);
+        return noise;
+    }
 
-        // Random number generator setup
-        std::mt19937 rng(seed >= 0 ? seed : std::random_device{}());
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    // -------------------------------------------------------------
+    // Generate a world-space region of hashed white noise
+    // -------------------------------------------------------------
+    NoiseMap2D WhiteNoise::generate_region(const Region& region, int seed, int threads) {
+        StatsScope stats("WhiteNoise::generate_region", pixel_count(region.width, region.height));
+        if (region.width <= 0) {
+            throw std::invalid_argument("region width must be > 0, got: " + std::to_string(region.width));
+        }
+        if (region.height <= 0) {
+            throw std::invalid_argument("region height must be > 0, got: " + std::to_string(region.height));
+        }
 
-        // Fill with random values
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                noise[y][x] = dist(rng);
+        const std::int64_t x0 = region.x + std::llround(region.offsetX);
+        const std::int64_t y0 = region.y + std::llround(region.offsetY);
 
+        NoiseMap2D noise = NoiseMap2D::uninitialized(region.width, region.height);
+        fill_hashed(noise, hash_key(seed), x0, y0, threads);
         return noise;
     }
 
+    // -------------------------------------------------------------
+    // Cached tile of the hashed world
+    // -------------------------------------------------------------
+    TileCache::Tile WhiteNoise::tile(TileCache& cache, std::int64_t tileX, std::int64_t tileY, int tileSize, int seed) {
+        StatsScope stats("WhiteNoise::tile", pixel_count(tileSize, tileSize));
+        const TileKey key = make_tile_key(NoiseType::White, tileX, tileY, tileSize, seed, {});
+        return cache.get_or_create(key, [&]() { return generate_region(tile_region(key), seed); });
+    }
+
     // -------------------------------------------------------------
     // Show preview in terminal (optional)
     // -------------------------------------------------------------
-    void WhiteNoise::show(const std::vector<std::vector<float>>& noise) {
-        if (noise.empty() || noise[0].empty()) {
+    void WhiteNoise::show(const NoiseMap2D& noise) {
+        if (noise.empty()) {
             throw std::invalid_argument("Cannot show empty noise map.");
         }
 
         std::cout << "\n[Preview of White Noise Map]\n";
-        int previewH = std::min((int)noise.size(), 10);
-        int previewW = std::min((int)noise[0].size(), 20);
+        int previewH = std::min(noise.height(), 10);
+        int previewW = std::min(noise.width(), 20);
 
         for (int y = 0; y < previewH; ++y) {
             for (int x = 0; x < previewW; ++x) {
@@ -60,59 +127,80 @@ namespace Noise {
     // -------------------------------------------------------------
     // Save as grayscale PNG or JPEG (auto-detected from extension)
     // -------------------------------------------------------------
-    void WhiteNoise::save(const std::vector<std::vector<float>>& noise, const std::string& filename, const std::string& outputDir) {
-        if (noise.empty() || noise[0].empty()) {
+    void WhiteNoise::save(const NoiseMap2D& noise, const std::string& filename, const std::string& outputDir, int compressionLevel) {
+        StatsScope stats("WhiteNoise::save", pixel_count(noise.width(), noise.height()));
+        if (noise.empty()) {
             throw std::invalid_argument("Cannot save empty noise map.");
         }
 
-        int height = noise.size();
-        int width = noise[0].size();
+        std::filesystem::path outputFile = resolve_image_path(filename, outputDir);
+        ImageOptions options;
+        options.compressionLevel = compressionLevel;
+        write_image(noise, outputFile, options);
+        std::cout << "[OK] White noise image saved at: " << outputFile.string() << "\n";
+    }
+
+    // -------------------------------------------------------------
+    // Generate and save band by band (hashed world, bounded memory)
+    // -------------------------------------------------------------
+    void WhiteNoise::stream(int width, int height, int seed, const std::string& filename, const std::string& outputDir,
+        int compressionLevel) {
+        StatsScope stats("WhiteNoise::stream", pixel_count(width, height));
+        if (width <= 0) {
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
+        }
+        if (height <= 0) {
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
+        }
 
-        std::vector<unsigned char> imgData(width * height);
+        // every band must hash with the same key
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
-        for (int y = 0; y < height; ++y)
-            for (int x = 0; x < width; ++x)
-                imgData[y * width + x] = static_cast<unsigned char>(noise[y][x] * 255.0f);
+        std::filesystem::path outputFile = resolve_image_path(filename, outputDir);
+        stream_image(outputFile, width, height, [&](int y0, int rows) {
+            return generate_region(Region{ 0, y0, width, rows }, seed);
+        }, ImageOptions{ 90, compressionLevel });
+        std::cout << "[OK] White noise image saved at: " << outputFile.string() << "\n";
+    }
 
-        // Determine output directory: use custom or default
-        std::filesystem::path outDir;
-        if (outputDir.empty()) {
-            outDir = std::filesystem::current_path().parent_path() / "ImageOutput";
+    // -------------------------------------------------------------
+    // Generate straight into a memory-mapped map file
+    // -------------------------------------------------------------
+    void WhiteNoise::save_map_file(const std::string& path, int width, int height, int seed, SampleFormat format,
+        Mode mode, int threads) {
+        StatsScope stats("WhiteNoise::save_map_file", pixel_count(width, height));
+        if (width <= 0) {
+            throw std::invalid_argument("width must be > 0, got: " + std::to_string(width));
         }
-        else {
-            outDir = outputDir;
+        if (height <= 0) {
+            throw std::invalid_argument("height must be > 0, got: " + std::to_string(height));
         }
-        std::filesystem::create_directories(outDir);
 
-        // Save file there
-        std::filesystem::path outputFile = outDir / filename;
-        std::string extension = outputFile.extension().string();
+        // record the seed actually used so the file can be regenerated
+        if (seed < 0) seed = static_cast<int>(std::random_device{}() & 0x7fffffff);
 
-        // Convert extension to lowercase for comparison
-        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        MapInfo info;
+        info.type = NoiseType::White;
+        info.seed = seed;
+        info.params = { static_cast<double>(mode) };
 
-        int result = 0;
-        if (extension == ".jpg" || extension == ".jpeg") {
-            // Save as JPEG with quality 90 (range: 1-100, higher = better quality)
-            result = stbi_write_jpg(outputFile.string().c_str(), width, height, 1, imgData.data(), 90);
+        MappedMap file = MappedMap::create(path, width, height, format, info);
+        if (format == SampleFormat::Float32) {
+            if (mode == Mode::Counter) fill_hashed(file.map(), hash_key(seed), 0, 0, threads);
+            else fill_white(file.map(), seed);
         }
         else {
-            // Default to PNG
-            result = stbi_write_png(outputFile.string().c_str(), width, height, 1, imgData.data(), width);
-        }
-
-        if (result == 0) {
-            throw std::runtime_error("Failed to write image file: " + outputFile.string());
+            file.store(generate(width, height, seed, mode, threads));
         }
-
-        std::cout << "[OK] White noise image saved at: " << outputFile.string() << "\n";
+        file.flush();
     }
 
     // -------------------------------------------------------------
     // Python-style wrapper
     // -------------------------------------------------------------
-    std::vector<std::vector<float>> create_whitenoise(int width, int height, int seed,
+    NoiseMap2D create_whitenoise(int width, int height, int seed,
         OutputMode mode, const std::string& filename, const std::string& outputDir) {
+        StatsScope stats("create_whitenoise", pixel_count(width, height));
         auto noise = WhiteNoise::generate(width, height, seed);
 
         switch (mode) {
@@ -0,0 +1,310 @@
+// RelNo_D1_bench
+// ----------------
+// Throughput of the map generators, for comparing builds and releases.
+//
+// Every (generator, size, octaves, threads) case is run --repeat times per
+// stage and reported as best / median wall time and megapixels per second
+// (from the median):
+//   generate   the generate_*_map call. Normalization to [0,1] is fused into
+//              the generators (fBm divides by the amplitude sum inside the
+//              octave kernels, pink runs its scaling pass before returning),
+//              so it is part of this stage.
+//   quantize   quantize_row over the map, the float -> 8-bit step of every writer
+//   encode     write_image to a temporary PNG (quantize + deflate + file write)
+// White noise has no octaves and runs once per size and thread count with
+// octaves = 0, using the counter-based mode so it scales with threads.
+//
+// Usage:
+//   RelNo_D1_bench                                   # default matrix, CSV on stdout
+//   RelNo_D1_bench --format json --out base.json
+//   RelNo_D1_bench --generators perlin,simplex --sizes 512,2048 --octaves 1,8 --threads 1,8 --repeat 7
+//   RelNo_D1_bench --smoke                           # tiny matrix, one repeat (used by ctest)
+//   RelNo_D1_bench --generators pink --sizes 4096 --trace pink.trace.json   # worker timeline (Trace.hpp)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Noise.hpp"
+#include "ImageWriter.hpp"
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+#ifndef RELNO_VERSION
+#define RELNO_VERSION "unknown"
+#endif
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        std::vector<std::string> generators{ "perlin", "simplex", "white", "pink" };
+        std::vector<int> sizes{ 256, 1024, 2048 };
+        std::vector<int> octaves{ 1, 4, 8 };
+        std::vector<int> threads;       // empty = 1 and all hardware threads
+        int repeat = 5;
+        std::string format = "csv";
+        std::string out;                // empty = stdout
+        std::string trace;              // Chrome trace of the whole run, empty = off
+    };
+
+    struct Result {
+        std::string generator;
+        std::string stage;
+        int width = 0;
+        int height = 0;
+        int octaves = 0;
+        int threads = 0;
+        int repeats = 0;
+        double bestMs = 0.0;
+        double medianMs = 0.0;
+        double mpixPerSecond = 0.0;
+    };
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream in(list);
+        std::string item;
+        while (std::getline(in, item, ','))
+            if (!item.empty()) items.push_back(item);
+        return items;
+    }
+
+    std::vector<int> parse_ints(const std::string& option, const std::string& list, int minimum) {
+        std::vector<int> values;
+        for (const std::string& item : split(list)) {
+            std::size_t used = 0;
+            int value = 0;
+            try {
+                value = std::stoi(item, &used);
+            }
+            catch (const std::exception&) {
+                used = 0;
+            }
+            if (used != item.size() || value < minimum)
+                throw std::invalid_argument(option + " expects integers >= " + std::to_string(minimum) + ", got: " + item);
+            values.push_back(value);
+        }
+        if (values.empty()) throw std::invalid_argument(option + " needs at least one value");
+        return values;
+    }
+
+    void print_usage(std::ostream& out) {
+        out << "Usage: RelNo_D1_bench [options]\n"
+            "  --generators LIST   comma-separated: perlin,simplex,white,pink (default: all)\n"
+            "  --sizes LIST        square map edges in pixels (default: 256,1024,2048)\n"
+            "  --octaves LIST      octave counts for perlin/simplex/pink (default: 1,4,8)\n"
+            "  --threads LIST      worker thread counts (default: 1 and all hardware threads)\n"
+            "  --repeat N          timed runs per stage (default: 5)\n"
+            "  --format csv|json   output format (default: csv)\n"
+            "  --out FILE          write results to FILE instead of stdout\n"
+            "  --trace FILE        record a Chrome trace of the run into FILE\n"
+            "  --smoke             64x64, 2 octaves, 1 and 2 threads, one run\n";
+    }
+
+    Config parse_args(int argc, char** argv) {
+        Config config;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+                return argv[++i];
+            };
+
+            if (arg == "--generators") config.generators = split(value());
+            else if (arg == "--sizes") config.sizes = parse_ints(arg, value(), 1);
+            else if (arg == "--octaves") config.octaves = parse_ints(arg, value(), 1);
+            else if (arg == "--threads") config.threads = parse_ints(arg, value(), 1);
+            else if (arg == "--repeat") config.repeat = parse_ints(arg, value(), 1).front();
+            else if (arg == "--format") config.format = value();
+            else if (arg == "--out") config.out = value();
+            else if (arg == "--trace") config.trace = value();
+            else if (arg == "--smoke") {
+                config.sizes = { 64 };
+                config.octaves = { 2 };
+                config.threads = { 1, 2 };
+                config.repeat = 1;
+            }
+            else if (arg == "--help" || arg == "-h") {
+                print_usage(std::cout);
+                std::exit(0);
+            }
+            else throw std::invalid_argument("unknown option: " + arg);
+        }
+
+        for (const std::string& name : config.generators)
+            if (name != "perlin" && name != "simplex" && name != "white" && name != "pink")
+                throw std::invalid_argument("unknown generator: " + name);
+        if (config.format != "csv" && config.format != "json")
+            throw std::invalid_argument("--format must be csv or json, got: " + config.format);
+        if (config.threads.empty()) {
+            config.threads.push_back(1);
+            const int hardware = static_cast<int>(std::thread::hardware_concurrency());
+            if (hardware > 1) config.threads.push_back(hardware);
+        }
+        return config;
+    }
+
+    // Runs `stage` `repeats` times and returns the sorted wall times in milliseconds
+    std::vector<double> time_runs(int repeats, const std::function<void()>& stage) {
+        std::vector<double> ms;
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = Clock::now();
+            stage();
+            ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::sort(ms.begin(), ms.end());
+        return ms;
+    }
+
+    Result make_result(const std::string& generator, const std::string& stage, int size, int octaves, int threads,
+        const std::vector<double>& ms) {
+        Result result;
+        result.generator = generator;
+        result.stage = stage;
+        result.width = size;
+        result.height = size;
+        result.octaves = octaves;
+        result.threads = threads;
+        result.repeats = static_cast<int>(ms.size());
+        result.bestMs = ms.front();
+        const std::size_t mid = ms.size() / 2;
+        result.medianMs = ms.size() % 2 ? ms[mid] : (ms[mid - 1] + ms[mid]) * 0.5;
+        const double pixels = static_cast<double>(size) * size;
+        result.mpixPerSecond = result.medianMs > 0.0 ? pixels / (result.medianMs * 1000.0) : 0.0;
+        return result;
+    }
+
+    Noise::NoiseMap2D generate(const std::string& generator, int size, int octaves, int threads) {
+        if (generator == "perlin")
+            return Noise::generate_perlin_map(size, size, 64.0f, octaves, 1.0f, 0.5f, 2.0f, 0.0f, 42, threads);
+        if (generator == "simplex")
+            return Noise::generate_simplex_map(size, size, 64.0f, octaves, 0.5f, 2.0f, 0.0f, 42, threads);
+        if (generator == "white")
+            return Noise::WhiteNoise::generate(size, size, 42, Noise::WhiteNoise::Mode::Counter, threads);
+        return Noise::generate_pink_map(size, size, octaves, 1.0f, 44100, 1.0f, 42, threads);
+    }
+
+    void run_case(const Config& config, const std::string& generator, int size, int octaves, int threads,
+        const std::filesystem::path& scratchImage, std::vector<Result>& results) {
+        Noise::NoiseMap2D map;
+        auto ms = time_runs(config.repeat, [&] { map = generate(generator, size, octaves, threads); });
+        results.push_back(make_result(generator, "generate", size, octaves, threads, ms));
+
+        std::vector<unsigned char> pixels(static_cast<std::size_t>(size));
+        ms = time_runs(config.repeat, [&] {
+            for (int y = 0; y < map.height(); ++y)
+                Noise::quantize_row(map.row(y), pixels.data(), pixels.size());
+        });
+        results.push_back(make_result(generator, "quantize", size, octaves, threads, ms));
+
+        Noise::ImageOptions options;
+        options.threads = threads;
+        ms = time_runs(config.repeat, [&] { Noise::write_image(map, scratchImage, options); });
+        results.push_back(make_result(generator, "encode", size, octaves, threads, ms));
+    }
+
+    void write_csv(std::ostream& out, const std::vector<Result>& results, const std::string& simd) {
+        out << "generator,stage,width,height,octaves,threads,simd,repeats,best_ms,median_ms,mpix_per_s\n";
+        for (const Result& r : results) {
+            out << r.generator << ',' << r.stage << ',' << r.width << ',' << r.height << ','
+                << r.octaves << ',' << r.threads << ',' << simd << ',' << r.repeats << ','
+                << r.bestMs << ',' << r.medianMs << ',' << r.mpixPerSecond << '\n';
+        }
+    }
+
+    void write_json(std::ostream& out, const std::vector<Result>& results, const std::string& simd) {
+        out << "{\n"
+            << "  \"library\": \"RelNo_D1\",\n"
+            << "  \"version\": \"" << RELNO_VERSION << "\",\n"
+            << "  \"simd\": \"" << simd << "\",\n"
+            << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+            << "  \"results\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\"generator\": \"" << r.generator << "\", \"stage\": \"" << r.stage
+                << "\", \"width\": " << r.width << ", \"height\": " << r.height
+                << ", \"octaves\": " << r.octaves << ", \"threads\": " << r.threads
+                << ", \"repeats\": " << r.repeats << ", \"best_ms\": " << r.bestMs
+                << ", \"median_ms\": " << r.medianMs << ", \"mpix_per_s\": " << r.mpixPerSecond << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    try {
+        config = parse_args(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "RelNo_D1_bench: " << e.what() << "\n\n";
+        print_usage(std::cerr);
+        return 2;
+    }
+
+    // The shared pool has to be large enough for the widest case
+    Noise::set_thread_count(*std::max_element(config.threads.begin(), config.threads.end()));
+
+    const std::string simd = Noise::simd_level_name(Noise::simd_level());
+    const std::filesystem::path scratchImage = std::filesystem::temp_directory_path() / "relno_d1_bench.png";
+
+    std::vector<Result> results;
+    if (!config.trace.empty()) Noise::start_trace();
+    try {
+        for (const std::string& generator : config.generators) {
+            const std::vector<int> octaves = generator == "white" ? std::vector<int>{ 0 } : config.octaves;
+            for (int size : config.sizes)
+                for (int octaveCount : octaves)
+                    for (int threads : config.threads)
+                        run_case(config, generator, size, octaveCount, threads, scratchImage, results);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "RelNo_D1_bench: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove(scratchImage, ignored);
+
+    if (!config.trace.empty()) {
+        Noise::stop_trace();
+        try {
+            Noise::write_trace(config.trace);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "RelNo_D1_bench: " << e.what() << "\n";
+            return 1;
+        }
+        if (const std::size_t dropped = Noise::trace_dropped_count())
+            std::cerr << "RelNo_D1_bench: trace buffers full, " << dropped << " spans dropped\n";
+    }
+
+    std::ofstream file;
+    if (!config.out.empty()) {
+        file.open(config.out);
+        if (!file) {
+            std::cerr << "RelNo_D1_bench: cannot open " << config.out << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = config.out.empty() ? std::cout : file;
+    if (config.format == "json") write_json(out, results, simd);
+    else write_csv(out, results, simd);
+    return out ? 0 : 1;
+}
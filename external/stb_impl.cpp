@@ -1,5 +0,0 @@
-// stb_impl.cpp
-// -------------
-// Single implementation unit for stb_image_write
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
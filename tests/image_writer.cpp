@@ -0,0 +1,350 @@
+// image_writer.cpp
+// PNG writer round trip: every file is parsed, inflated, checked against its
+// CRCs and Adler-32, un-filtered and compared with quantize_row of the map.
+// Output bytes must not depend on the thread count.
+#include "Noise.hpp"
+#include "CoordHash.hpp"
+#include "ImageWriter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    using Bytes = std::vector<std::uint8_t>;
+
+    Bytes read_file(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("cannot read " + path.string());
+        return Bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::uint32_t read_be32(const std::uint8_t* p) {
+        return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+    }
+
+    std::uint32_t crc32(const std::uint8_t* data, std::size_t size) {
+        std::uint32_t crc = 0xffffffffU;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xedb88320U & (0U - (crc & 1U)));
+        }
+        return crc ^ 0xffffffffU;
+    }
+
+    std::uint32_t adler32(const Bytes& data) {
+        std::uint32_t a = 1, b = 0;
+        for (std::uint8_t v : data) {
+            a = (a + v) % 65521U;
+            b = (b + a) % 65521U;
+        }
+        return (b << 16) | a;
+    }
+
+    // Minimal RFC 1951 decoder (stored, fixed and dynamic Huffman blocks)
+    class Inflater {
+    public:
+        Inflater(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+        Bytes run() {
+            Bytes out;
+            bool last = false;
+            while (!last) {
+                last = bits(1) != 0;
+                const int type = static_cast<int>(bits(2));
+                if (type == 0) stored(out);
+                else if (type == 1) fixed(out);
+                else if (type == 2) dynamic(out);
+                else throw std::runtime_error("invalid deflate block type");
+            }
+            return out;
+        }
+
+        // Bytes consumed, including the partly used last one
+        std::size_t consumed() const { return pos_; }
+
+    private:
+        struct Huffman {
+            std::vector<int> counts = std::vector<int>(16, 0);
+            std::vector<int> symbols;
+        };
+
+        const std::uint8_t* data_;
+        std::size_t size_;
+        std::size_t pos_ = 0;
+        std::uint32_t bitBuf_ = 0;
+        int bitCount_ = 0;
+
+        std::uint32_t bits(int need) {
+            std::uint32_t value = 0;
+            for (int i = 0; i < need; ++i) {
+                if (bitCount_ == 0) {
+                    if (pos_ >= size_) throw std::runtime_error("deflate stream truncated");
+                    bitBuf_ = data_[pos_++];
+                    bitCount_ = 8;
+                }
+                value |= (bitBuf_ & 1U) << i;
+                bitBuf_ >>= 1;
+                --bitCount_;
+            }
+            return value;
+        }
+
+        static Huffman build(const int* lengths, int count) {
+            Huffman h;
+            for (int i = 0; i < count; ++i) ++h.counts[static_cast<std::size_t>(lengths[i])];
+            h.counts[0] = 0;
+            std::vector<int> offsets(16, 0);
+            for (int len = 1; len < 16; ++len) offsets[len] = offsets[len - 1] + h.counts[len - 1];
+            h.symbols.assign(static_cast<std::size_t>(count), 0);
+            for (int i = 0; i < count; ++i)
+                if (lengths[i] != 0) h.symbols[static_cast<std::size_t>(offsets[lengths[i]]++)] = i;
+            return h;
+        }
+
+        int decode(const Huffman& h) {
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len < 16; ++len) {
+                code |= static_cast<int>(bits(1));
+                const int count = h.counts[static_cast<std::size_t>(len)];
+                if (code - count < first) return h.symbols[static_cast<std::size_t>(index + (code - first))];
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            throw std::runtime_error("invalid Huffman code");
+        }
+
+        void stored(Bytes& out) {
+            bitBuf_ = 0;
+            bitCount_ = 0;
+            if (pos_ + 4 > size_) throw std::runtime_error("deflate stream truncated");
+            const unsigned len = data_[pos_] | (data_[pos_ + 1] << 8);
+            const unsigned nlen = data_[pos_ + 2] | (data_[pos_ + 3] << 8);
+            pos_ += 4;
+            if ((len ^ 0xffffU) != nlen) throw std::runtime_error("stored block length mismatch");
+            if (pos_ + len > size_) throw std::runtime_error("deflate stream truncated");
+            out.insert(out.end(), data_ + pos_, data_ + pos_ + len);
+            pos_ += len;
+        }
+
+        void codes(Bytes& out, const Huffman& lit, const Huffman& dist) {
+            static const int lenBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const int lenExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const int distBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const int distExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+            for (;;) {
+                const int symbol = decode(lit);
+                if (symbol < 256) {
+                    out.push_back(static_cast<std::uint8_t>(symbol));
+                    continue;
+                }
+                if (symbol == 256) return;
+                const int l = symbol - 257;
+                if (l >= 29) throw std::runtime_error("invalid length symbol");
+                const std::size_t length = static_cast<std::size_t>(lenBase[l]) + bits(lenExtra[l]);
+                const int d = decode(dist);
+                if (d >= 30) throw std::runtime_error("invalid distance symbol");
+                const std::size_t distance = static_cast<std::size_t>(distBase[d]) + bits(distExtra[d]);
+                if (distance > out.size()) throw std::runtime_error("distance before stream start");
+                for (std::size_t i = 0; i < length; ++i) out.push_back(out[out.size() - distance]);
+            }
+        }
+
+        void fixed(Bytes& out) {
+            int lengths[288 + 30];
+            int i = 0;
+            for (; i < 144; ++i) lengths[i] = 8;
+            for (; i < 256; ++i) lengths[i] = 9;
+            for (; i < 280; ++i) lengths[i] = 7;
+            for (; i < 288; ++i) lengths[i] = 8;
+            for (; i < 288 + 30; ++i) lengths[i] = 5;
+            codes(out, build(lengths, 288), build(lengths + 288, 30));
+        }
+
+        void dynamic(Bytes& out) {
+            static const int order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            const int nlen = static_cast<int>(bits(5)) + 257;
+            const int ndist = static_cast<int>(bits(5)) + 1;
+            const int ncode = static_cast<int>(bits(4)) + 4;
+            int lengths[320] = {};
+            for (int i = 0; i < ncode; ++i) lengths[order[i]] = static_cast<int>(bits(3));
+            const Huffman lencode = build(lengths, 19);
+
+            int index = 0;
+            while (index < nlen + ndist) {
+                const int symbol = decode(lencode);
+                if (symbol < 16) {
+                    lengths[index++] = symbol;
+                    continue;
+                }
+                int repeat = 0, value = 0;
+                if (symbol == 16) {
+                    if (index == 0) throw std::runtime_error("repeat with no previous length");
+                    value = lengths[index - 1];
+                    repeat = 3 + static_cast<int>(bits(2));
+                }
+                else if (symbol == 17) repeat = 3 + static_cast<int>(bits(3));
+                else repeat = 11 + static_cast<int>(bits(7));
+                if (index + repeat > nlen + ndist) throw std::runtime_error("too many code lengths");
+                while (repeat--) lengths[index++] = value;
+            }
+            if (lengths[256] == 0) throw std::runtime_error("no end-of-block code");
+            codes(out, build(lengths, nlen), build(lengths + nlen, ndist));
+        }
+    };
+
+    int paeth(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return a;
+        return pb <= pc ? b : c;
+    }
+
+    // Decodes an 8-bit grayscale PNG into width x height bytes
+    Bytes decode_png(const Bytes& file, int expectWidth, int expectHeight) {
+        static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        if (file.size() < 8 || !std::equal(signature, signature + 8, file.begin()))
+            throw std::runtime_error("bad PNG signature");
+
+        Bytes idat;
+        std::uint32_t width = 0, height = 0;
+        bool ended = false;
+        for (std::size_t pos = 8; !ended;) {
+            if (pos + 12 > file.size()) throw std::runtime_error("PNG chunk truncated");
+            const std::uint32_t length = read_be32(&file[pos]);
+            if (pos + 12 + length > file.size()) throw std::runtime_error("PNG chunk truncated");
+            const std::uint8_t* type = &file[pos + 4];
+            const std::uint8_t* body = &file[pos + 8];
+            if (crc32(type, length + 4) != read_be32(body + length)) throw std::runtime_error("PNG chunk CRC mismatch");
+
+            const std::string name(type, type + 4);
+            if (name == "IHDR") {
+                width = read_be32(body);
+                height = read_be32(body + 4);
+                if (body[8] != 8 || body[9] != 0 || body[12] != 0) throw std::runtime_error("not 8-bit grayscale");
+            }
+            else if (name == "IDAT") idat.insert(idat.end(), body, body + length);
+            else if (name == "IEND") ended = true;
+            pos += 12 + length;
+        }
+        if (width != static_cast<std::uint32_t>(expectWidth) || height != static_cast<std::uint32_t>(expectHeight))
+            throw std::runtime_error("IHDR size mismatch");
+
+        // zlib wrapper: header, raw deflate, big-endian Adler-32 of the filtered rows
+        if (idat.size() < 6 || (idat[0] & 0x0f) != 8 || ((idat[0] << 8) | idat[1]) % 31 != 0)
+            throw std::runtime_error("bad zlib header");
+        Inflater inflater(idat.data() + 2, idat.size() - 2);
+        const Bytes filtered = inflater.run();
+        const std::size_t trailer = 2 + inflater.consumed();
+        if (trailer + 4 != idat.size()) throw std::runtime_error("bytes after zlib stream");
+        if (adler32(filtered) != read_be32(&idat[trailer])) throw std::runtime_error("Adler-32 mismatch");
+
+        const std::size_t w = width;
+        if (filtered.size() != (w + 1) * height) throw std::runtime_error("inflated size mismatch");
+        Bytes pixels(w * height);
+        for (std::size_t y = 0; y < height; ++y) {
+            const std::uint8_t filter = filtered[y * (w + 1)];
+            const std::uint8_t* in = &filtered[y * (w + 1) + 1];
+            std::uint8_t* row = &pixels[y * w];
+            const std::uint8_t* up = y > 0 ? row - w : nullptr;
+            for (std::size_t x = 0; x < w; ++x) {
+                const int a = x > 0 ? row[x - 1] : 0;
+                const int b = up ? up[x] : 0;
+                const int c = (up && x > 0) ? up[x - 1] : 0;
+                int predictor = 0;
+                switch (filter) {
+                case 0: predictor = 0; break;
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: predictor = paeth(a, b, c); break;
+                default: throw std::runtime_error("invalid filter type");
+                }
+                row[x] = static_cast<std::uint8_t>(in[x] + predictor);
+            }
+        }
+        return pixels;
+    }
+}
+
+int main() {
+    using namespace Noise;
+
+    // 1000 + 1 bytes per filtered row: 1047 rows per 1 MB segment, so the
+    // image spans two segments (one batch with 4 threads, two with 1)
+    const int width = 1000, height = 1100;
+    const int threadCounts[] = { 1, 4 };
+    int failures = 0;
+    auto check = [&](bool ok, const std::string& what) {
+        if (!ok) {
+            std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+            ++failures;
+        }
+    };
+
+    // smooth Perlin on top, hashed white noise below: matchable and incompressible rows
+    NoiseMap2D map = generate_perlin_map(width, height, 60.0f, 4, 1.0f, 0.5f, 2.0f, 0.0f, 17, 1);
+    for (int y = height * 2 / 3; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            map(x, y) = hash_to_unit(hash_coords(5, x, y));
+
+    Bytes expected(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y)
+        quantize_row(map.row(y), &expected[static_cast<std::size_t>(y) * width], static_cast<std::size_t>(width));
+
+    auto produce = [&](int y0, int rows) {
+        NoiseMap2D band(width, rows);
+        for (int y = 0; y < rows; ++y) std::copy(map.row(y0 + y), map.row(y0 + y) + width, band.row(y));
+        return band;
+    };
+
+    for (int level : { 0, 1, 6, 9 }) {
+        Bytes reference;
+        for (int threads : threadCounts) {
+            ImageOptions options;
+            options.compressionLevel = level;
+            options.threads = threads;
+            const std::string tag = "level " + std::to_string(level) + ", " + std::to_string(threads) + " thread(s)";
+
+            const std::filesystem::path written = "image_writer_test.png";
+            const std::filesystem::path streamed = "image_writer_stream_test.png";
+            write_image(map, written, options);
+            stream_image(streamed, width, height, produce, options);
+
+            for (const auto& path : { written, streamed }) {
+                const std::string what = path.filename().string() + ", " + tag;
+                try {
+                    // the first file of a level is decoded, the others must match it byte for byte
+                    const Bytes file = read_file(path);
+                    if (reference.empty()) {
+                        check(decode_png(file, width, height) == expected, what + ": pixels differ from quantize_row");
+                        reference = file;
+                    }
+                    else if (file != reference) {
+                        check(false, what + ": bytes differ from the first file of this level");
+                        check(decode_png(file, width, height) == expected, what + ": pixels differ from quantize_row");
+                    }
+                }
+                catch (const std::exception& e) {
+                    check(false, what + ": " + e.what());
+                }
+            }
+            std::filesystem::remove(written);
+            std::filesystem::remove(streamed);
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+// map_file.cpp
+// Map file loader against corrupted headers: every case must throw, never crash.
+#include "Noise.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr std::streamoff kStrideOffset = 24;   // FileHeader::stride
+
+    void write_stride(const std::filesystem::path& path, std::uint64_t stride) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(kStrideOffset);
+        file.write(reinterpret_cast<const char*>(&stride), sizeof(stride));
+    }
+
+    bool load_throws(const std::filesystem::path& path) {
+        try {
+            Noise::load_map_file(path);
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main() {
+    using namespace Noise;
+
+    const int width = 100, height = 37;
+    const std::filesystem::path path = "map_file_test.relmap";
+    int failures = 0;
+    auto check = [&](bool ok, const std::string& what) {
+        if (!ok) {
+            std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+            ++failures;
+        }
+    };
+
+    NoiseMap2D map(width, height);
+    map.fill(0.5f);
+    for (SampleFormat format : { SampleFormat::Float32, SampleFormat::UInt16 }) {
+        const std::size_t sample = format == SampleFormat::UInt16 ? 2 : 4;
+        const std::string name = format == SampleFormat::UInt16 ? "uint16" : "float32";
+
+        save_map_file(map, path, {}, format);
+        check(load_map_file(path).width() == width, name + ": intact file loads");
+
+        // header + stride * height * sample wraps around to a small size
+        write_stride(path, UINT64_MAX / (static_cast<std::uint64_t>(height) * sample) + 1);
+        check(load_throws(path), name + ": wrapping stride");
+
+        write_stride(path, UINT64_MAX);
+        check(load_throws(path), name + ": maximum stride");
+
+        // in bounds, but rows lose their 64-byte alignment
+        write_stride(path, static_cast<std::uint64_t>(width) + 1);
+        check(load_throws(path), name + ": unaligned stride");
+    }
+
+    std::filesystem::remove(path);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// simd_levels.cpp
+// Every SIMD level up to the detected one must give the scalar output byte for
+// byte: the Perlin / Simplex fBm kernels, the CoordHash row kernels (white and
+// pink layers), the pink integral scans and normalization, and surface normals.
+#include "Noise.hpp"
+#include "Simd.hpp"
+#include "Surface.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+    using Floats = std::vector<float>;
+    using Doubles = std::vector<double>;
+
+    // Odd sizes so every vector loop ends in a scalar tail
+    constexpr int Width = 203;
+    constexpr int Height = 77;
+
+    void append(Floats& out, const Noise::NoiseMap2D& map) {
+        for (int y = 0; y < map.height(); ++y) out.insert(out.end(), map.row(y), map.row(y) + map.width());
+    }
+
+    template <class T>
+    bool same_bytes(const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+    }
+
+    struct Case {
+        const char* name;
+        std::function<Floats()> run;
+    };
+
+    std::vector<Case> cases() {
+        using namespace Noise;
+        return {
+            { "generate_perlin_map", [] {
+                Floats out;
+                append(out, generate_perlin_map(Width, Height, 30.0f, 5, 1.0f, 0.5f, 2.0f, 0.25f, 42, 1));
+                return out; } },
+            { "generate_simplex_map", [] {
+                Floats out;
+                append(out, generate_simplex_map(Width, Height, 30.0f, 5, 0.5f, 2.0f, 0.25f, 33, 1));
+                return out; } },
+            { "WhiteNoise::generate (Counter)", [] {
+                Floats out;
+                append(out, WhiteNoise::generate(Width, Height, 21, WhiteNoise::Mode::Counter, 1));
+                return out; } },
+            { "generate_pink_map", [] {
+                Floats out;
+                append(out, generate_pink_map(Width, Height, 6, 1.0f, 44100, 1.0f, 7, 1));
+                return out; } },
+            { "generate_pink_region", [] {
+                Floats out;
+                append(out, generate_pink_region(Region{ -37, 91, Width, Height }, 6, 1.0f, 44100, 1.0f, 7, 1));
+                return out; } },
+            { "PinkNoise::generate_white_layer", [] {
+                Floats out(static_cast<std::size_t>(Width) * Height);
+                PinkNoise(5).generate_white_layer(out.data(), Width, Height, 11, 1);
+                return out; } },
+            { "PinkNoise::build_integral (float) / box_average_from_integral", [] {
+                Floats layer(static_cast<std::size_t>(Width) * Height);
+                PinkNoise(5).generate_white_layer(layer.data(), Width, Height, 11, 1);
+                Floats integral(static_cast<std::size_t>(Width + 1) * (Height + 1));
+                PinkNoise::build_integral(layer.data(), integral.data(), Width, Height, 1);
+                Floats boxes(layer.size());
+                PinkNoise::box_average_from_integral(integral.data(), boxes.data(), Width, Height, 8, 1);
+                integral.insert(integral.end(), boxes.begin(), boxes.end());
+                return integral; } },
+            { "PinkNoise::build_integral (double)", [] {
+                Floats layer(static_cast<std::size_t>(Width) * Height);
+                PinkNoise(5).generate_white_layer(layer.data(), Width, Height, 11, 1);
+                Doubles integral(static_cast<std::size_t>(Width + 1) * (Height + 1));
+                PinkNoise::build_integral(layer.data(), integral.data(), Width, Height, 1);
+                Floats boxes(layer.size());
+                PinkNoise::box_average_from_integral(integral.data(), boxes.data(), Width, Height, 8, 1);
+                // the table's bytes, then the averages
+                Floats out(integral.size() * 2);
+                std::memcpy(out.data(), integral.data(), integral.size() * sizeof(double));
+                out.insert(out.end(), boxes.begin(), boxes.end());
+                return out; } },
+            { "generate_perlin_surface / surface_normals", [] {
+                const SurfaceMap surface = generate_perlin_surface(Width, Height, 30.0f, 5, 1.0f, 0.5f, 2.0f, 0.25f, 42, 1);
+                const NormalMap normals = surface_normals(surface, 40.0f, 1);
+                Floats out;
+                for (const NoiseMap2D* map : { &surface.height, &surface.dx, &surface.dy, &normals.x, &normals.y, &normals.z })
+                    append(out, *map);
+                return out; } },
+            { "generate_simplex_surface / surface_normals", [] {
+                const SurfaceMap surface = generate_simplex_surface(Width, Height, 30.0f, 5, 0.5f, 2.0f, 0.25f, 33, 1);
+                const NormalMap normals = surface_normals(surface, 40.0f, 1);
+                Floats out;
+                for (const NoiseMap2D* map : { &surface.height, &surface.dx, &surface.dy, &normals.x, &normals.y, &normals.z })
+                    append(out, *map);
+                return out; } },
+        };
+    }
+}
+
+int main() {
+    using namespace Noise;
+
+    int failures = 0;
+    auto check = [&](bool ok, const std::string& what) {
+        if (!ok) {
+            std::fprintf(stderr, "FAILED: %s\n", what.c_str());
+            ++failures;
+        }
+    };
+
+    const std::vector<Case> all = cases();
+    check(set_simd_level(SimdLevel::Scalar) == SimdLevel::Scalar, "cannot force the scalar level");
+    std::vector<Floats> scalar;
+    for (const Case& c : all) scalar.push_back(c.run());
+
+    const SimdLevel detected = detected_simd_level();
+    for (int l = static_cast<int>(SimdLevel::Scalar) + 1; l <= static_cast<int>(detected); ++l) {
+        const SimdLevel level = static_cast<SimdLevel>(l);
+        check(set_simd_level(level) == level, std::string("cannot force ") + simd_level_name(level));
+        std::printf("checking %s against scalar\n", simd_level_name(level));
+        for (std::size_t i = 0; i < all.size(); ++i)
+            check(same_bytes(all[i].run(), scalar[i]), std::string(all[i].name) + ": " + simd_level_name(level) + " differs from scalar");
+    }
+
+    reset_simd_level();
+    return failures == 0 ? 0 : 1;
+}